@@ -11,6 +11,7 @@ in SphereData {
 
 in VertData {
     flat uint AmbientOcclusion;
+    flat vec3 Color;
 } v_;
 
 struct DirectLight {
@@ -34,7 +35,6 @@ uniform float u_OneOverFarDistance; // (1.0 / Fardistance)
 uniform float u_FocalLength;
 
 uniform DirectLight u_DirLight;
-uniform float u_WorldScale;
 
 vec3 CalcDirectLight(DirectLight light, vec3 normal, vec3 viewDir, vec3 fragRealPos);
 float GetAmbientOccVal(vec3 normal);
@@ -69,46 +69,9 @@ void main() {
     FragColor = vec4(fragColor * occ, 1.0);
 }
 
-// Deterministic per-sphere hash [0, 1].
-// Uses only XZ (always exact grid multiples regardless of LOD level).
-// Y is excluded: it is an averaged height that can vary slightly with FP rounding
-// across compute dispatches, which would cause visible color changes on LOD rebuild.
-float sphereHash(vec3 center) {
-    vec2 p = round(center.xz * 2.0);
-    p = fract(p * vec2(0.1031, 0.1030));
-    p += dot(p, p.yx + 33.33);
-    return fract((p.x + p.y) * p.x);
-}
-
 vec3 CalcDirectLight(DirectLight light, vec3 normal, vec3 viewDir, vec3 fragRealPos) {
-    // Normalize by world scale so colour band thresholds stay at real-world metre values.
-    float h = v_Sphere.center.y / u_WorldScale;
-
-    // Height colour bands matched to the terrain scale (1 world unit = 1 m).
-    vec3 deepOcean    = vec3(0.10, 0.28, 0.55);
-    vec3 shallowOcean = vec3(0.22, 0.55, 0.82);
-    vec3 beach        = vec3(0.76, 0.71, 0.50);
-    vec3 lowland      = vec3(0.24, 0.50, 0.11);
-    vec3 highland     = vec3(0.17, 0.36, 0.08);
-    vec3 mountain     = vec3(0.44, 0.37, 0.28);
-    vec3 highMountain = vec3(0.58, 0.56, 0.54);
-    vec3 snow         = vec3(0.91, 0.93, 0.95);
-
-    vec3 color;
-    if      (h < -20.0)  color = deepOcean;
-    else if (h <  -3.0)  color = mix(deepOcean,    shallowOcean, smoothstep( -20.0,   -3.0, h));
-    else if (h <   5.0)  color = mix(shallowOcean, beach,        smoothstep(  -3.0,    5.0, h));
-    // shorter green bands
-    else if (h <  50.0)  color = mix(beach,        lowland,      smoothstep(   5.0,   50.0, h));
-    else if (h < 180.0)  color = mix(lowland,      highland,     smoothstep(  50.0,  180.0, h));
-    else if (h < 400.0)  color = mix(highland,     mountain,     smoothstep( 180.0,  400.0, h));
-    else if (h < 800.0)  color = mix(mountain,     highMountain, smoothstep( 400.0,  800.0, h));
-    else                 color = mix(highMountain, snow,         smoothstep( 800.0, 1400.0, h));
-
-    // Per-sphere variation: unique random brightness/tint offset per sphere.
-    float n = sphereHash(v_Sphere.center);
-    color *= 0.88 + n * 0.24; // +-12 % brightness spread
-    color  = clamp(color, 0.0, 1.0);
+    // Material colour, resolved per sphere in the vertex shader.
+    vec3 color = v_.Color;
 
     // Ambient + diffuse lighting.
     vec3 result = light.ambient * color;
@@ -23,9 +23,16 @@ out SphereData {
 
 out VertData {
     flat uint AmbientOcclusion;
+    flat vec3 Color;
 } v_;
 
+// TerrainMaterial palette, indexed by the low byte of ChunkTypeAndFlags.
+layout(std430, binding = 4) readonly buffer MaterialPaletteBuffer {
+    vec4 palette[];
+};
+
 bool IsSphereVisible(vec3 pos, float radius);
+float sphereHash(vec3 center);
 
 // Uniforms 
 uniform mat4 u_View;      // world-to-view matrix
@@ -103,6 +110,8 @@ void main(){
     v_Sphere.viewZOverFocalLength = zLenght / u_FocalLength;
     v_Sphere.pixelCenter = (ndc.xy*0.5 + 0.5) * u_Resolution;
     v_.AmbientOcclusion = aAmbientOcclusion;
+    // Per-sphere variation: unique random brightness offset per sphere.
+    v_.Color = clamp(palette[aChunkTypeFlags & 0xFFu].rgb * (0.88 + sphereHash(sphereCenter) * 0.24), 0.0, 1.0);
     // set the values
     gl_Position = u_Proj * vec4(viewCenterXY, viewCenter.z, 1.0);;
     gl_PointSize = pointSize;
@@ -110,6 +119,17 @@ void main(){
 
 
 
+// Deterministic per-sphere hash [0, 1].
+// Uses only XZ (always exact grid multiples regardless of LOD level).
+// Y is excluded: it is an averaged height that can vary slightly with FP rounding
+// across compute dispatches, which would cause visible color changes on LOD rebuild.
+float sphereHash(vec3 center) {
+    vec2 p = round(center.xz * 2.0);
+    p = fract(p * vec2(0.1031, 0.1030));
+    p += dot(p, p.yx + 33.33);
+    return fract((p.x + p.y) * p.x);
+}
+
 bool IsSphereVisible(vec3 pos, float radius){
     for (int i = 0; i < 6; i++){
         // Calculate signed distance from sphere center to the plane
@@ -3,8 +3,10 @@
 // Compact 8-byte vertex stream
 //   location 0: ivec3 chunk-local position in half-radius units (int16 x 3)
 //   location 1: uint  block-size step (uint8) -> world radius = step * SPHERE_RADIUS
+//   location 2: uint  TerrainMaterial index (uint8)
 layout (location = 0) in ivec3 aLocal;
 layout (location = 1) in uint  aLodStep;
+layout (location = 2) in uint  aMaterial;
 
 out SphereData {
     vec3 center;
@@ -14,6 +16,10 @@ out SphereData {
     vec2 pixelCenter;
 } v_Sphere;
 
+out VertData {
+    flat vec3 Color;
+} v_;
+
 struct ChunkInfoLO {
     int   posX;
     int   posZ;
@@ -32,6 +38,11 @@ layout(std430, binding = 3) readonly buffer VisibleChunkIdxBuffer {
     uint visibleChunkIdx[];
 };
 
+// TerrainMaterial palette, shared with atom.vert.
+layout(std430, binding = 4) readonly buffer MaterialPaletteBuffer {
+    vec4 palette[];
+};
+
 uniform mat4  u_View;
 uniform mat4  u_Proj;
 uniform vec3  u_CamPos;
@@ -49,6 +60,7 @@ uniform uint  u_ChunkSize;
 uniform float u_LodOversize;
 
 bool IsSphereVisible(vec3 pos, float radius);
+float sphereHash(vec3 center);
 
 void main(){
     uint chunkIdx = visibleChunkIdx[gl_DrawID];
@@ -112,10 +124,18 @@ void main(){
     v_Sphere.centerToCam          = -camToCenter;
     v_Sphere.viewZOverFocalLength = zLength / u_FocalLength;
     v_Sphere.pixelCenter          = (ndc.xy * 0.5 + 0.5) * u_Resolution;
+    v_.Color                      = clamp(palette[aMaterial].rgb * (0.88 + sphereHash(sphereCenter) * 0.24), 0.0, 1.0);
     gl_Position                   = u_Proj * vec4(viewCenterXY, viewCenter.z, 1.0);
     gl_PointSize                  = pointSize;
 }
 
+float sphereHash(vec3 center) {
+    vec2 p = round(center.xz * 2.0);
+    p = fract(p * vec2(0.1031, 0.1030));
+    p += dot(p, p.yx + 33.33);
+    return fract((p.x + p.y) * p.x);
+}
+
 bool IsSphereVisible(vec3 pos, float radius) {
     for (int i = 0; i < 6; i++) {
         float dist = dot(pos, u_FrustumPlanes[i].xyz) + u_FrustumPlanes[i].w;
@@ -0,0 +1,122 @@
+#version 460 core
+
+// Instanced scatter prototypes, one draw per ScatterType and no vertex attributes:
+//   gl_VertexID                    - sphere of the prototype (the draw's first = its First)
+//   gl_BaseInstance + gl_InstanceID - slot in the visible list scatter_culler.comp wrote
+// Each sphere is then projected exactly like atom_compact.vert and shaded by
+// atom_compact.frag.
+
+out SphereData {
+    vec3 center;
+    float radius;
+    vec3 centerToCam;
+    float viewZOverFocalLength;
+    vec2 pixelCenter;
+} v_Sphere;
+
+out VertData {
+    flat vec3 Color;
+} v_;
+
+struct ScatterInstance {
+    float x, y, z;
+    uint  packed;   // bits 0..7 type, 8..15 scale (1/64), 16..23 yaw (1/256 turn), 24..31 tint
+};
+
+struct PrototypeSphere {
+    vec4 offsetRadius; // at scale 1, relative to the instance origin
+    vec4 color;
+};
+
+layout(std430, binding = 2) readonly buffer InstanceBuffer {
+    ScatterInstance instances[];
+};
+
+layout(std430, binding = 3) readonly buffer VisibleBuffer {
+    uint visible[];
+};
+
+layout(std430, binding = 5) readonly buffer PrototypeBuffer {
+    PrototypeSphere prototypeSpheres[];
+};
+
+uniform mat4  u_View;
+uniform mat4  u_Proj;
+uniform vec3  u_CamPos;
+uniform vec3  u_CamUp;
+uniform vec3  u_CamRight;
+uniform ivec2 u_Resolution;
+
+uniform vec4  u_FrustumPlanes[6];
+uniform float u_MaxPointSize;
+uniform float u_OneOverFarDistance;
+uniform float u_FocalLength;
+
+bool IsSphereVisible(vec3 pos, float radius);
+
+void main(){
+    ScatterInstance inst = instances[visible[gl_BaseInstance + gl_InstanceID]];
+    PrototypeSphere ps   = prototypeSpheres[gl_VertexID];
+
+    float scale = float((inst.packed >> 8) & 0xFFu) / 64.0;
+    float yaw   = float((inst.packed >> 16) & 0xFFu) * (6.2831853 / 256.0);
+    float tint  = float(inst.packed >> 24) / 255.0;
+    float c = cos(yaw), s = sin(yaw);
+    vec3  o = ps.offsetRadius.xyz;
+
+    vec3  sphereCenter = vec3(inst.x, inst.y, inst.z) + scale * vec3(c * o.x - s * o.z, o.y, s * o.x + c * o.z);
+    float radius       = ps.offsetRadius.w * scale;
+
+    if (!IsSphereVisible(sphereCenter, radius)) {
+        gl_Position = vec4(-1000.0, -1000.0, -1000.0, 1.0);
+        gl_PointSize = 0.0;
+        return;
+    }
+
+    vec3  camToCenter = sphereCenter - u_CamPos;
+    float oc          = length(camToCenter);
+    if (oc < radius * 1.01) {
+        gl_Position = vec4(-1000.0, -1000.0, -1000.0, 1.0);
+        gl_PointSize = 0.0;
+        return;
+    }
+
+    float oc2          = oc * oc;
+    float scaledRadius = radius * oc / sqrt(oc2 - radius * radius);
+    vec3  viewCenter   = (u_View * vec4(sphereCenter, 1.0)).xyz;
+    float zLength      = -viewCenter.z;
+    float semiMajor    = u_FocalLength * scaledRadius * oc / (zLength * zLength);
+    float pointSize    = semiMajor * 2.0;
+
+    if (pointSize > u_MaxPointSize) {
+        gl_Position = vec4(-1000.0, -1000.0, -1000.0, 1.0);
+        gl_PointSize = 0.0;
+        return;
+    }
+
+    vec4 projCenter = u_Proj * vec4(viewCenter, 1.0);
+    vec3 ndc        = projCenter.xyz / projCenter.w;
+
+    vec2  viewCenterXY = viewCenter.xy;
+    float viewXYSize2  = dot(viewCenterXY, viewCenterXY);
+    float oa2          = scaledRadius * scaledRadius + oc * oc;
+    float offsetSize   = (zLength * zLength * oa2) / (oc2 * oc2 - viewXYSize2 * oa2);
+    viewCenterXY *= offsetSize;
+
+    v_Sphere.center               = sphereCenter;
+    v_Sphere.radius               = radius;
+    v_Sphere.centerToCam          = -camToCenter;
+    v_Sphere.viewZOverFocalLength = zLength / u_FocalLength;
+    v_Sphere.pixelCenter          = (ndc.xy * 0.5 + 0.5) * u_Resolution;
+    v_.Color                      = clamp(ps.color.rgb * (0.85 + tint * 0.3), 0.0, 1.0);
+    gl_Position                   = u_Proj * vec4(viewCenterXY, viewCenter.z, 1.0);
+    gl_PointSize                  = pointSize;
+}
+
+bool IsSphereVisible(vec3 pos, float radius) {
+    for (int i = 0; i < 6; i++) {
+        float dist = dot(pos, u_FrustumPlanes[i].xyz) + u_FrustumPlanes[i].w;
+        if (dist < -radius * 2.3) return false;
+    }
+    return true;
+}
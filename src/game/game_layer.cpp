@@ -4,7 +4,6 @@
 #include "core/input.hpp"
 #include "core/log.hpp"
 #include "io/save_manager.hpp"
-#include "world/terrain_generator.hpp"
 
 #include <string>
 
@@ -12,7 +11,6 @@
 #include <GLFW/glfw3.h>
 
 namespace {
-    // Shared between the world streamer and the spawn-height query so terrain matches.
     const Seed256 kWorldSeed{941456789ULL, 423654321ULL, 111222333ULL, 444555666ULL};
     constexpr const char* kSaveRoot       = "data/save";
     constexpr const char* kPlayerSaveName = "player";
@@ -31,7 +29,9 @@ GameLayer::GameLayer()
               return hw > 1u ? hw - 1u : 1u;
           }(),
           .seed           = kWorldSeed,
-          .worldDir       = "data/world"
+          .worldDir       = "data/world",
+          .erosion        = TerrainErosion::Hydraulic,
+          .density        = TerrainDensity::NarrowBand
       })
 {}
 
@@ -54,10 +54,9 @@ void GameLayer::OnAttach() {
                  m_SavedPosition.Value().x, m_SavedPosition.Value().y, m_SavedPosition.Value().z);
     } else {
         // No save - sample terrain at spawn coords and place camera a short distance above.
-        TerrainGenerator terrain(kWorldSeed);
         const float spawnX = 0.0f;
         const float spawnZ = 0.0f;
-        const float groundY = terrain.GetHeight(spawnX, spawnZ);
+        const float groundY = m_World.SampleHeight(spawnX, spawnZ);
         m_Camera.SetPosition(glm::vec3(spawnX, groundY + 4.0f, spawnZ));
         m_Camera.SetOrientation(-90.0f, -10.0f);
         LOG_INFO("[GameLayer] Fresh spawn at terrain height %.1f", groundY);
@@ -71,6 +70,8 @@ void GameLayer::OnAttach() {
 
     // Trigger the first streaming tick so workers begin generating chunks
     m_Camera.Update();
+    m_Camera.CalculateFrustum();
+    m_World.SetViewFrustum(m_Camera.GetFrustum());
     m_World.Update(m_Camera.GetPosition());
 }
 
@@ -113,6 +114,7 @@ void GameLayer::OnUpdate(float deltaTime) {
 
     m_Camera.Update();
     m_Camera.CalculateFrustum();
+    m_World.SetViewFrustum(m_Camera.GetFrustum());
 
     if (m_World.Update(m_Camera.GetPosition()))
         m_Renderer.SyncChunks(m_World);
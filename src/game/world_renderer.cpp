@@ -1,7 +1,9 @@
 #include "game/world_renderer.hpp"
+#include "renderer/draw_array_command.hpp"
 #include "world/world_handler.hpp"
 #include "world/sphere.hpp"
 #include "world/config.hpp"
+#include "world/terrain_material.hpp"
 #include "core/log.hpp"
 
 #include <glm/glm.hpp>
@@ -64,11 +66,37 @@ void WorldRenderer::Init(uint32_t renderDist) {
     m_ChunkInfoCPU_LO.reserve(m_MaxChunks);
     SetupVAO_LO();
 
+    // --- Scatter pipeline buffers. Every chunk takes a full MAX_PER_CHUNK slab, so the
+    // slabs never fragment and the whole HQ load ring always fits.
+    std::vector<ScatterPrototypeSphere> prototypeSpheres;
+    ScatterLayer::BuildPrototypes(prototypeSpheres, m_Prototypes);
+    m_MaxInstances           = hqLoadChunks * ScatterLayer::MAX_PER_CHUNK;
+    m_PrototypeSSBO          = GLBuffer(static_cast<uint32_t>(prototypeSpheres.size() * sizeof(ScatterPrototypeSphere)),
+                                        prototypeSpheres.data(), GL_STATIC_DRAW);
+    m_InstanceSSBO           = GLBuffer(m_MaxInstances * static_cast<uint32_t>(sizeof(ScatterInstance)), nullptr, GL_DYNAMIC_DRAW);
+    m_ScatterMem             = std::make_unique<MemoryManager>(m_MaxInstances);
+    m_ChunkInfoSSBO_Scatter  = GLBuffer(hqLoadChunks * static_cast<uint32_t>(sizeof(ChunkInfo)), nullptr, GL_DYNAMIC_DRAW);
+    m_DrawCmdBuf_Scatter     = GLBuffer(SCATTER_TYPES * static_cast<uint32_t>(sizeof(DrawArraysIndirectCommand)),
+                                        nullptr, GL_DYNAMIC_DRAW);
+    m_VisibleIdxSSBO_Scatter = GLBuffer(SCATTER_TYPES * m_MaxInstances * static_cast<uint32_t>(sizeof(uint32_t)),
+                                        nullptr, GL_DYNAMIC_DRAW);
+    m_ChunkInfoCPU_Scatter.reserve(hqLoadChunks);
+    glCreateVertexArrays(1, &m_VAO_Scatter);
+    LOG_INFO("[WorldRenderer] Scatter: %u instance slots (~%u KB), %zu prototype spheres",
+             m_MaxInstances, m_MaxInstances * static_cast<uint32_t>(sizeof(ScatterInstance)) / 1024u,
+             prototypeSpheres.size());
+
+    // --- Material palette, read by both vertex shaders
+    const auto palette    = TerrainMaterial::BuildPalette();
+    m_MaterialPaletteSSBO = GLBuffer(static_cast<uint32_t>(sizeof(palette)), palette.data(), GL_STATIC_DRAW);
+
     // --- Shaders
     m_CullerShader_HQ = std::make_unique<Shader>("res/shaders/frustum_culler.comp");
     m_CullerShader_LO = std::make_unique<Shader>("res/shaders/frustum_culler_lo.comp");
     m_AtomShader_HQ   = std::make_unique<Shader>("res/shaders/atom.vert",         "res/shaders/atom.frag");
     m_AtomShader_LO   = std::make_unique<Shader>("res/shaders/atom_compact.vert", "res/shaders/atom_compact.frag");
+    m_CullerShader_Scatter = std::make_unique<Shader>("res/shaders/scatter_culler.comp");
+    m_ScatterShader        = std::make_unique<Shader>("res/shaders/scatter.vert", "res/shaders/atom_compact.frag");
 
     m_AtomShader_HQ->Bind();
     m_AtomShader_HQ->SetFloat3("u_DirLight.direction", glm::normalize(glm::vec3(1.0f, -1.0f, 1.0f)));
@@ -76,7 +104,6 @@ void WorldRenderer::Init(uint32_t renderDist) {
     m_AtomShader_HQ->SetFloat3("u_DirLight.diffuse",   glm::vec3(0.5f));
     m_AtomShader_HQ->SetFloat3("u_DirLight.specular",  glm::vec3(0.5f));
     m_AtomShader_HQ->SetInt("u_Texture", 0);
-    m_AtomShader_HQ->SetFloat("u_WorldScale", FEATURE_SCALE);
     m_AtomShader_HQ->Unbind();
 
     m_AtomShader_LO->Bind();
@@ -84,12 +111,18 @@ void WorldRenderer::Init(uint32_t renderDist) {
     m_AtomShader_LO->SetFloat3("u_DirLight.ambient",   glm::vec3(0.5f));
     m_AtomShader_LO->SetFloat3("u_DirLight.diffuse",   glm::vec3(0.5f));
     m_AtomShader_LO->SetFloat3("u_DirLight.specular",  glm::vec3(0.5f));
-    m_AtomShader_LO->SetFloat("u_WorldScale",   FEATURE_SCALE);
     m_AtomShader_LO->SetFloat("u_SphereRadius", SPHERE_RADIUS);
     m_AtomShader_LO->SetFloat("u_LodOversize", LOD_OVERSIZE);
     glUniform1ui(glGetUniformLocation(m_AtomShader_LO->GetRendererID(), "u_ChunkSize"), CHUNK_SIZE);
     m_AtomShader_LO->Unbind();
 
+    m_ScatterShader->Bind();
+    m_ScatterShader->SetFloat3("u_DirLight.direction", glm::normalize(glm::vec3(1.0f, -1.0f, 1.0f)));
+    m_ScatterShader->SetFloat3("u_DirLight.ambient",   glm::vec3(0.5f));
+    m_ScatterShader->SetFloat3("u_DirLight.diffuse",   glm::vec3(0.5f));
+    m_ScatterShader->SetFloat3("u_DirLight.specular",  glm::vec3(0.5f));
+    m_ScatterShader->Unbind();
+
     glEnable(GL_PROGRAM_POINT_SIZE);
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
@@ -143,6 +176,12 @@ void WorldRenderer::SetupVAO_LO() {
     glVertexArrayAttribIFormat(m_VAO_LO, 1, 1, GL_UNSIGNED_BYTE,
                                static_cast<GLuint>(offsetof(CompactSphere, lodStep)));
     glVertexArrayAttribBinding(m_VAO_LO, 1, 0);
+
+    // Location 2: uint (material) from uint8
+    glEnableVertexArrayAttrib(m_VAO_LO, 2);
+    glVertexArrayAttribIFormat(m_VAO_LO, 2, 1, GL_UNSIGNED_BYTE,
+                               static_cast<GLuint>(offsetof(CompactSphere, color)));
+    glVertexArrayAttribBinding(m_VAO_LO, 2, 0);
 }
 
 // --- SyncChunks
@@ -268,7 +307,8 @@ void WorldRenderer::SyncChunks(WorldHandler& world) {
                 const ChunkCoordinates coords(m_CamChunk.X + dx, m_CamChunk.Z + dz);
                 const uint64_t key = coords.GetKey();
                 if (m_HQSlot.count(key)) continue;
-                if (!world.GetChunk(coords)) continue;
+                const Chunk* chunk = world.GetChunk(coords);
+                if (!chunk || chunk->IsLODOnly()) continue; // arrives again once promoted
                 PendingUpload pu{};
                 pu.key    = key;
                 pu.coords = coords;
@@ -288,6 +328,12 @@ void WorldRenderer::SyncChunks(WorldHandler& world) {
 
         const uint64_t key = coords.GetKey();
         const float distSq = static_cast<float>(dx * dx + dz * dz);
+        const Chunk*   chunk = world.GetChunk(coords);
+        if (!chunk) continue;
+
+        // Promoted to full detail: swap the coarse LO slab for the real LODs.
+        auto lo = m_LOSlot.find(key);
+        if (lo != m_LOSlot.end() && lo->second.lodOnly && !chunk->IsLODOnly()) EvictLO(key);
 
         if (!m_LOSlot.count(key)) {
             PendingUpload pu{};
@@ -296,7 +342,7 @@ void WorldRenderer::SyncChunks(WorldHandler& world) {
             pu.distSq = distSq;
             m_PendingLO.push(pu);
         }
-        if (cheby <= hqLoadD && !m_HQSlot.count(key)) {
+        if (cheby <= hqLoadD && !chunk->IsLODOnly() && !m_HQSlot.count(key)) {
             PendingUpload pu{};
             pu.key    = key;
             pu.coords = coords;
@@ -323,8 +369,8 @@ void WorldRenderer::UpdateUploads(const WorldHandler& world) {
             if (m_HQSlot.count(pu.key)) continue;
             if (!InSquare(m_CamChunk, pu.coords, hqLoadD)) continue;
             const Chunk* chunk = world.GetChunk(pu.coords);
-            if (!chunk) continue;
-            UploadHQ(*chunk);
+            if (!chunk || chunk->IsLODOnly()) continue;
+            if (UploadHQ(*chunk)) UploadScatter(*chunk);
         }
     }
 
@@ -423,6 +469,7 @@ bool WorldRenderer::UploadLO(const Chunk& chunk) {
     entry.slot         = static_cast<uint32_t>(m_ChunkInfoCPU_LO.size());
     entry.vboOffset    = offset;
     entry.vboTotalSize = totalCount;
+    entry.lodOnly      = chunk.IsLODOnly();
 
     m_ChunkInfoCPU_LO.push_back(info);
     m_LOSlot[chunk.GetCoordinates().GetKey()] = entry;
@@ -430,10 +477,48 @@ bool WorldRenderer::UploadLO(const Chunk& chunk) {
     return true;
 }
 
+void WorldRenderer::PatchLO(const Chunk& chunk, std::span<const LODPatch> patches, bool rebuilt) {
+    const uint64_t key = chunk.GetCoordinates().GetKey();
+    auto it = m_LOSlot.find(key);
+    if (it == m_LOSlot.end()) return;
+    if (rebuilt) {
+        EvictLO(key);
+        UploadLO(chunk);
+        return;
+    }
+
+    const LOEntry&     entry = it->second;
+    const ChunkLODSet& lods  = chunk.GetLODs();
+    ChunkInfoLO&       info  = m_ChunkInfoCPU_LO[entry.slot];
+
+    // Slab-relative indices; the chunk already holds the patched spheres.
+    std::vector<uint32_t> indices;
+    indices.reserve(patches.size());
+    for (const LODPatch& patch : patches) indices.push_back(lods.lodOffsets[patch.Level] + patch.Index);
+    std::sort(indices.begin(), indices.end());
+
+    for (size_t first = 0; first < indices.size();) {
+        size_t last = first + 1;
+        while (last < indices.size() && indices[last] == indices[last - 1] + 1u) ++last;
+        m_SphereVBO_LO.SetData(lods.data.data() + indices[first],
+                               static_cast<uint32_t>(last - first) * static_cast<uint32_t>(sizeof(CompactSphere)),
+                               (entry.vboOffset + indices[first]) * static_cast<uint32_t>(sizeof(CompactSphere)));
+        first = last;
+    }
+
+    const BoundBox& bb = chunk.GetBounds();
+    if (info.bbMinY != bb.m_Min.y || info.bbMaxY != bb.m_Max.y) {
+        info.bbMinY = bb.m_Min.y;
+        info.bbMaxY = bb.m_Max.y;
+        m_ChunkInfoLODirty = true;
+    }
+}
+
 void WorldRenderer::EvictHQ(uint64_t key) {
     auto it = m_HQSlot.find(key);
     if (it == m_HQSlot.end()) return;
     const HQEntry entry = it->second;
+    EvictScatter(key);
 
     m_HQMem->Free(entry.vboOffset, entry.vboSize);
 
@@ -468,12 +553,79 @@ void WorldRenderer::EvictLO(uint64_t key) {
     m_ChunkInfoLODirty = true;
 }
 
+bool WorldRenderer::UploadScatter(const Chunk& chunk) {
+    const std::vector<ScatterInstance>& instances = chunk.GetScatter();
+    if (instances.empty()) return false;
+
+    uint32_t offset = 0;
+    if (!m_ScatterMem->Allocate(ScatterLayer::MAX_PER_CHUNK, offset)) {
+        LOG_WARN("[WorldRenderer] Scatter buffer full, dropping chunk (%d,%d)",
+                 chunk.GetCoordinates().X, chunk.GetCoordinates().Z);
+        return false;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(instances.size());
+    m_InstanceSSBO.SetData(instances.data(),
+                           count * static_cast<uint32_t>(sizeof(ScatterInstance)),
+                           offset * static_cast<uint32_t>(sizeof(ScatterInstance)));
+
+    // Chunk bounds = union of the instances' bounding spheres.
+    glm::vec3 bbMin( std::numeric_limits<float>::max());
+    glm::vec3 bbMax(-std::numeric_limits<float>::max());
+    for (const ScatterInstance& inst : instances) {
+        const ScatterPrototype& proto = m_Prototypes[static_cast<size_t>(inst.GetType())];
+        const float     scale  = inst.GetScale();
+        const glm::vec3 centre(inst.X, inst.Y + proto.BoundCenterY * scale, inst.Z);
+        const glm::vec3 extent(proto.BoundRadius * scale);
+        bbMin = glm::min(bbMin, centre - extent);
+        bbMax = glm::max(bbMax, centre + extent);
+    }
+
+    ChunkInfo info{};
+    info.offset = offset;
+    info.size   = count;
+    info.posX   = chunk.GetCoordinates().X;
+    info.posZ   = chunk.GetCoordinates().Z;
+    info.bbMinX = bbMin.x;  info.bbMinY = bbMin.y;  info.bbMinZ = bbMin.z;
+    info.bbMaxX = bbMax.x;  info.bbMaxY = bbMax.y;  info.bbMaxZ = bbMax.z;
+
+    HQEntry entry{};
+    entry.slot      = static_cast<uint32_t>(m_ChunkInfoCPU_Scatter.size());
+    entry.vboOffset = offset;
+    entry.vboSize   = ScatterLayer::MAX_PER_CHUNK;
+
+    m_ChunkInfoCPU_Scatter.push_back(info);
+    m_ScatterSlot[chunk.GetCoordinates().GetKey()] = entry;
+    m_ChunkInfoScatterDirty = true;
+    return true;
+}
+
+void WorldRenderer::EvictScatter(uint64_t key) {
+    auto it = m_ScatterSlot.find(key);
+    if (it == m_ScatterSlot.end()) return;
+    const HQEntry entry = it->second;
+
+    m_ScatterMem->Free(entry.vboOffset, entry.vboSize);
+
+    const uint32_t last = static_cast<uint32_t>(m_ChunkInfoCPU_Scatter.size()) - 1u;
+    if (entry.slot != last) {
+        const uint64_t lastKey =
+            ChunkCoordinates(m_ChunkInfoCPU_Scatter[last].posX, m_ChunkInfoCPU_Scatter[last].posZ).GetKey();
+        m_ChunkInfoCPU_Scatter[entry.slot] = m_ChunkInfoCPU_Scatter[last];
+        m_ScatterSlot[lastKey].slot        = entry.slot;
+    }
+    m_ChunkInfoCPU_Scatter.pop_back();
+    m_ScatterSlot.erase(it);
+    m_ChunkInfoScatterDirty = true;
+}
+
 // --- Render
 
 void WorldRenderer::Render(const Camera& cam) {
     if (!m_Initialized) return;
     RenderLO(cam);
     RenderHQ(cam);
+    RenderScatter(cam);
 }
 
 void WorldRenderer::RenderHQ(const Camera& cam) {
@@ -495,6 +647,7 @@ void WorldRenderer::RenderHQ(const Camera& cam) {
     m_ChunkInfoSSBO_HQ.BindBase(GL_SHADER_STORAGE_BUFFER, 0);
     m_DrawCmdSSBO_HQ.BindBase(GL_SHADER_STORAGE_BUFFER, 1);
     m_VisibleCountBuf_HQ.BindBase(GL_ATOMIC_COUNTER_BUFFER, 2);
+    m_MaterialPaletteSSBO.BindBase(GL_SHADER_STORAGE_BUFFER, 4);
 
     m_CullerShader_HQ->Bind();
     const GLuint cullID = m_CullerShader_HQ->GetRendererID();
@@ -564,6 +717,7 @@ void WorldRenderer::RenderLO(const Camera& cam) {
     m_DrawCmdSSBO_LO.BindBase(GL_SHADER_STORAGE_BUFFER, 1);
     m_VisibleCountBuf_LO.BindBase(GL_ATOMIC_COUNTER_BUFFER, 2);
     m_VisibleChunkIdxSSBO_LO.BindBase(GL_SHADER_STORAGE_BUFFER, 3);
+    m_MaterialPaletteSSBO.BindBase(GL_SHADER_STORAGE_BUFFER, 4);
 
     m_CullerShader_LO->Bind();
     const GLuint cullID = m_CullerShader_LO->GetRendererID();
@@ -621,6 +775,80 @@ void WorldRenderer::RenderLO(const Camera& cam) {
     m_VisibleCountBuf_LO.Unbind(GL_PARAMETER_BUFFER);
 }
 
+void WorldRenderer::RenderScatter(const Camera& cam) {
+    if (m_ChunkInfoCPU_Scatter.empty()) return;
+
+    // Fresh commands every frame: the culler only adds to instanceCount.
+    std::array<DrawArraysIndirectCommand, SCATTER_TYPES> cmds;
+    std::array<float, SCATTER_TYPES * 2>                 bounds;
+    for (uint32_t t = 0; t < SCATTER_TYPES; ++t) {
+        cmds[t] = DrawArraysIndirectCommand(m_Prototypes[t].Count, 0u, m_Prototypes[t].First, t * m_MaxInstances);
+        bounds[2 * t]     = m_Prototypes[t].BoundCenterY;
+        bounds[2 * t + 1] = m_Prototypes[t].BoundRadius;
+    }
+    m_DrawCmdBuf_Scatter.SetData(cmds.data(), static_cast<uint32_t>(sizeof(cmds)), 0);
+
+    if (m_ChunkInfoScatterDirty) {
+        m_ChunkInfoSSBO_Scatter.SetData(m_ChunkInfoCPU_Scatter.data(),
+            static_cast<uint32_t>(m_ChunkInfoCPU_Scatter.size() * sizeof(ChunkInfo)), 0);
+        m_ChunkInfoScatterDirty = false;
+    }
+
+    Frustum frustum = cam.GetFrustum();
+    frustum.Normalize();
+    const float* planes = frustum.GetData();
+
+    m_ChunkInfoSSBO_Scatter.BindBase(GL_SHADER_STORAGE_BUFFER, 0);
+    m_DrawCmdBuf_Scatter.BindBase(GL_SHADER_STORAGE_BUFFER, 1);
+    m_InstanceSSBO.BindBase(GL_SHADER_STORAGE_BUFFER, 2);
+    m_VisibleIdxSSBO_Scatter.BindBase(GL_SHADER_STORAGE_BUFFER, 3);
+    m_PrototypeSSBO.BindBase(GL_SHADER_STORAGE_BUFFER, 5);
+
+    m_CullerShader_Scatter->Bind();
+    const GLuint cullID = m_CullerShader_Scatter->GetRendererID();
+    glUniform4fv(glGetUniformLocation(cullID, "u_FrustumPlanes"), 6, planes);
+    glUniform1ui(glGetUniformLocation(cullID, "u_ChunkCount"),
+                 static_cast<uint32_t>(m_ChunkInfoCPU_Scatter.size()));
+    glUniform2f(glGetUniformLocation(cullID, "u_CamChunkXZ"),
+                static_cast<float>(m_CamChunk.X), static_cast<float>(m_CamChunk.Z));
+    glUniform1ui(glGetUniformLocation(cullID, "u_HqRenderRange"), HQ_RENDER_RANGE);
+    glUniform2fv(glGetUniformLocation(cullID, "u_PrototypeBounds"), SCATTER_TYPES, bounds.data());
+
+    const uint32_t groups = (static_cast<uint32_t>(m_ChunkInfoCPU_Scatter.size()) + 63u) / 64u;
+    glDispatchCompute(groups, 1, 1);
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+    const float focalLen = static_cast<float>(cam.GetHeight()) /
+                           (2.0f * std::tan(cam.GetFovYRad() * 0.5f));
+    float pointSizeRange[2] = {1.0f, 64.0f};
+    glGetFloatv(GL_POINT_SIZE_RANGE, pointSizeRange);
+
+    m_ScatterShader->Bind();
+    m_ScatterShader->SetMat4("u_View",  cam.GetViewMatrix());
+    m_ScatterShader->SetMat4("u_Proj",  cam.GetProjMatrix());
+    m_ScatterShader->SetFloat3("u_CamPos",   cam.GetPosition());
+    m_ScatterShader->SetFloat3("u_CamUp",    cam.GetUp());
+    m_ScatterShader->SetFloat3("u_CamRight", cam.GetRight());
+    m_ScatterShader->SetFloat("u_FocalLength",        focalLen);
+    m_ScatterShader->SetFloat("u_OneOverFarDistance", 1.0f / cam.GetFar());
+    m_ScatterShader->SetFloat("u_MaxPointSize",       pointSizeRange[1]);
+
+    const GLuint drawID = m_ScatterShader->GetRendererID();
+    glUniform2i(glGetUniformLocation(drawID, "u_Resolution"),
+                cam.GetWidth(), cam.GetHeight());
+    glUniform4fv(glGetUniformLocation(drawID, "u_FrustumPlanes"), 6, planes);
+
+    // One instanced draw per prototype.
+    m_DrawCmdBuf_Scatter.Bind(GL_DRAW_INDIRECT_BUFFER);
+    glBindVertexArray(m_VAO_Scatter);
+
+    glMultiDrawArraysIndirect(GL_POINTS, nullptr, static_cast<GLsizei>(SCATTER_TYPES), 0);
+
+    glBindVertexArray(0);
+    m_DrawCmdBuf_Scatter.Unbind(GL_DRAW_INDIRECT_BUFFER);
+}
+
 // --- GetSphereCount
 
 uint32_t WorldRenderer::GetSphereCount() const noexcept {
@@ -637,20 +865,26 @@ uint32_t WorldRenderer::GetSphereCount() const noexcept {
 void WorldRenderer::Shutdown() {
     if (m_VAO_HQ) { glDeleteVertexArrays(1, &m_VAO_HQ); m_VAO_HQ = 0; }
     if (m_VAO_LO) { glDeleteVertexArrays(1, &m_VAO_LO); m_VAO_LO = 0; }
+    if (m_VAO_Scatter) { glDeleteVertexArrays(1, &m_VAO_Scatter); m_VAO_Scatter = 0; }
 
     m_CullerShader_HQ.reset();
     m_CullerShader_LO.reset();
     m_AtomShader_HQ.reset();
     m_AtomShader_LO.reset();
+    m_CullerShader_Scatter.reset();
+    m_ScatterShader.reset();
 
     m_ChunkInfoCPU_HQ.clear();
     m_ChunkInfoCPU_LO.clear();
     m_HQSlot.clear();
     m_LOSlot.clear();
+    m_ChunkInfoCPU_Scatter.clear();
+    m_ScatterSlot.clear();
     while (!m_PendingHQ.empty()) m_PendingHQ.pop();
     while (!m_PendingLO.empty()) m_PendingLO.pop();
     m_HQMem.reset();
     m_LOMem.reset();
+    m_ScatterMem.reset();
     m_Initialized = false;
 }
 
@@ -5,11 +5,14 @@
 #include "renderer/camera.hpp"
 #include "util/memory_manager.hpp"
 #include "world/chunk.hpp"
+#include "world/scatter_layer.hpp"
 
 #include <glad/glad.h>
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <queue>
+#include <span>
 #include <vector>
 #include <unordered_map>
 
@@ -53,6 +56,15 @@ static_assert(sizeof(ChunkInfoLO) == 48, "ChunkInfoLO size mismatch with shader"
 //   - Culler skips chunks inside HQ_RENDER_RANGE and picks the LOD slice per
 //     distance ring.
 //   - Uses frustum_culler_lo.comp + atom_compact.vert/frag.
+//
+// Scatter pipeline (16-byte ScatterInstance, trees and boulders):
+//   - Follows the HQ pipeline: a chunk's instances are uploaded and evicted with
+//     its HQ slab, and drawn within HQ_RENDER_RANGE.
+//   - Each ScatterType's prototype spheres are uploaded once. scatter_culler.comp
+//     tests every instance of the visible chunks and lists it under its type; one
+//     instanced indirect draw per type then expands the prototype per instance.
+//   - Uses scatter_culler.comp + scatter.vert / atom_compact.frag. Chunk slots reuse
+//     ChunkInfo (offset / size index the instance buffer).
 class WorldRenderer {
 public:
     WorldRenderer() = default;
@@ -71,6 +83,11 @@ public:
     // Drain up to CHUNK_UPLOAD_PER_FRAME entries from each pending queue (nearest first).
     void UpdateUploads(const WorldHandler& world);
 
+    // Brings the chunk's resident LO slab in line after Chunk::UpdateLODs. The patches are
+    // written as range writes, adjacent blocks merged into one; rebuilt (UpdateLODs returned
+    // false) re-uploads the whole slab instead. Chunks without a slab are left to UploadLO.
+    void PatchLO(const Chunk& chunk, std::span<const LODPatch> patches, bool rebuilt);
+
     void Render(const Camera& cam);
 
     uint32_t GetSphereCount() const noexcept;
@@ -86,11 +103,14 @@ private:
     bool     GrowVBO_LO();
     void     RenderHQ(const Camera& cam);
     void     RenderLO(const Camera& cam);
+    void     RenderScatter(const Camera& cam);
 
     bool     UploadHQ(const Chunk& chunk);
     bool     UploadLO(const Chunk& chunk);
     void     EvictHQ(uint64_t key);
     void     EvictLO(uint64_t key);
+    bool     UploadScatter(const Chunk& chunk);
+    void     EvictScatter(uint64_t key);
 
     static bool InSquare(ChunkCoordinates a, ChunkCoordinates b, int32_t dist) noexcept;
 
@@ -99,6 +119,8 @@ private:
     std::unique_ptr<Shader>  m_CullerShader_LO;
     std::unique_ptr<Shader>  m_AtomShader_HQ;
     std::unique_ptr<Shader>  m_AtomShader_LO;
+    std::unique_ptr<Shader>  m_CullerShader_Scatter;
+    std::unique_ptr<Shader>  m_ScatterShader;
 
     // --- HQ pipeline buffers
     GLBuffer  m_SphereVBO_HQ;
@@ -130,9 +152,22 @@ private:
         uint32_t slot;          // index in m_ChunkInfoCPU_LO
         uint32_t vboOffset;     // base of slab
         uint32_t vboTotalSize;  // sum of all LOD counts in the slab
+        bool     lodOnly;       // uploaded from a LOD-only chunk; replaced once it is promoted
     };
     std::unordered_map<uint64_t, LOEntry> m_LOSlot;
 
+    // --- Scatter pipeline buffers
+    GLBuffer  m_PrototypeSSBO;           // ScatterPrototypeSphere list of every type
+    GLBuffer  m_InstanceSSBO;            // MAX_PER_CHUNK-instance slab per chunk
+    GLBuffer  m_ChunkInfoSSBO_Scatter;
+    GLBuffer  m_DrawCmdBuf_Scatter;      // one DrawArraysIndirectCommand per ScatterType
+    GLBuffer  m_VisibleIdxSSBO_Scatter;  // SCATTER_TYPES x m_MaxInstances instance indices
+    GLuint    m_VAO_Scatter = 0;         // no attributes, bound for the draw only
+    std::unique_ptr<MemoryManager>  m_ScatterMem;
+    std::vector<ChunkInfo>          m_ChunkInfoCPU_Scatter;
+    std::array<ScatterPrototype, SCATTER_TYPES> m_Prototypes{};
+    std::unordered_map<uint64_t, HQEntry> m_ScatterSlot; // vboOffset / vboSize index m_InstanceSSBO
+
     // --- Pending uploads (nearest first)
     struct PendingUpload {
         uint64_t         key;
@@ -143,6 +178,9 @@ private:
     std::priority_queue<PendingUpload> m_PendingHQ;
     std::priority_queue<PendingUpload> m_PendingLO;
 
+    // --- Shared: TerrainMaterial palette (vec4 per material byte), binding 4 for both atom shaders
+    GLBuffer  m_MaterialPaletteSSBO;
+
     // --- State
     uint32_t m_RenderDist     = 0;
     uint32_t m_LoadDist       = 0;
@@ -150,9 +188,11 @@ private:
     uint32_t m_MaxChunks      = 0;
     uint32_t m_MaxSpheresHQ   = 0;
     uint32_t m_MaxSpheresLO   = 0;
+    uint32_t m_MaxInstances   = 0;  // instance slots; every HQ-loaded chunk fits a full slab
     ChunkCoordinates m_CamChunk{0, 0};
     ChunkCoordinates m_LastSyncCenter{INT32_MAX, INT32_MAX};
     bool     m_Initialized      = false;
     bool     m_ChunkInfoHQDirty = false;
     bool     m_ChunkInfoLODirty = false;
+    bool     m_ChunkInfoScatterDirty = false;
 };
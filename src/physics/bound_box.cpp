@@ -27,6 +27,19 @@ bool BoundBox::IsOnFrustum(const Frustum& frustum) const {
     return true;
 }
 
+BoundBox::FrustumTest BoundBox::TestFrustum(const Frustum& frustum) const {
+    FrustumTest result = FrustumTest::Inside;
+    for (const auto& plane : frustum.Planes) {
+        // Most-aligned corner behind the plane -> whole box outside
+        if (plane.GetSignedDistance(GetPositiveVertex(plane.Normal)) < 0.0f)
+            return FrustumTest::Outside;
+        // Least-aligned corner behind the plane -> box straddles it
+        if (plane.GetSignedDistance(GetNegativeVertex(plane.Normal)) < 0.0f)
+            result = FrustumTest::Intersect;
+    }
+    return result;
+}
+
 glm::vec3 BoundBox::GetPositiveVertex(const glm::vec3& normal) const {
     glm::vec3 p = m_Min;
     if (normal.x >= 0) p.x = m_Max.x;
@@ -3,9 +3,13 @@
 #include "physics/frustum.hpp"
 #include <glm/glm.hpp>
 
+#include <cstdint>
+
 
 class BoundBox {
 public:
+    enum class FrustumTest : uint8_t { Outside, Intersect, Inside };
+
     BoundBox() = default;
     BoundBox(const glm::vec3& min, const glm::vec3& max);
     BoundBox(float x_min, float x_max, float y_min, float y_max, float z_min, float z_max);
@@ -13,6 +17,9 @@ public:
     // Checks if the box is inside or intersecting the frustum
     bool IsOnFrustum(const Frustum& frustum) const;
 
+    // Like IsOnFrustum, but also tells a box fully inside from one crossing a plane
+    FrustumTest TestFrustum(const Frustum& frustum) const;
+
     // Getters
     glm::vec3 GetCenter() const { return (m_Min + m_Max) * 0.5f; }
     glm::vec3 GetSize() const { return m_Max - m_Min; } // No abs needed if min < max
@@ -45,7 +45,7 @@ struct Plane {
     // Returns > 0 if point is in front (normal direction), < 0 if behind.
     float GetSignedDistance(const glm::vec3 &point) const {
         // Standard Plane Equation: Ax + By + Cz + D
-        return glm::dot(Normal, point) - Distance;
+        return glm::dot(Normal, point) + Distance;
     }
 };
 
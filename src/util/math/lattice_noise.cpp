@@ -0,0 +1,503 @@
+#include "util/math/lattice_noise.hpp"
+#include "util/math/noise_scalar.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define LATTICE_NOISE_X86 1
+    #include <immintrin.h>
+    #define NOISE_TARGET_SSE41 __attribute__((target("sse4.1")))
+    #define NOISE_TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+// Fixed-point layout:
+//   world coordinate  Q8  (1/256 world unit), |value| < 2^30 after the octave offset
+//   cell fraction t   Q16 in [0, 2^16)
+//   corner dot        Q13 (gradient . offset / 8), |value| <= 3 * 2^13
+//   fade weight       Q12 in [0, 2^12]
+//   octave output     Q15 in [-32767, 32767]
+// Dots, fade weights, the normalisation and the octave amplitudes all fit in 16
+// bits, so the SIMD kernels use 16-bit multiplies (pmulhuw / pmaddwd); only the
+// lattice hash needs a full 32-bit multiply.
+namespace {
+    constexpr float    FIXED_SCALE = 256.0f;
+    constexpr int32_t  ONE         = 1 << 16;
+    constexpr int32_t  NORM        = 18477;   // Q13 lattice value -> Q15 output: x NORM / 2^12
+    constexpr int32_t  FADE_ONE    = 1 << 12;
+    constexpr int32_t  CLAMP       = 32767;
+    constexpr int32_t  OFFSET_MASK = (1 << 20) - 1;
+    constexpr float    OUT_SCALE   = 1.0f / 32768.0f;
+
+    constexpr uint32_t PRIME_X  = static_cast<uint32_t>(NoiseScalar::PRIME_X);
+    constexpr uint32_t PRIME_Z  = static_cast<uint32_t>(NoiseScalar::PRIME_Y);
+    constexpr uint32_t HASH_MUL16 = 0xeb2d; // low half of NoiseScalar::HASH_MUL
+
+    using Octave = LatticeNoise::Octave;
+
+    // --- Scalar reference ---
+
+    inline int32_t ToFixed(float v) noexcept {
+        v = std::min(std::max(v, -LatticeNoise::LIMIT), LatticeNoise::LIMIT);
+        return static_cast<int32_t>(std::floor(v * FIXED_SCALE));
+    }
+
+    // Corner hash: one 16-bit multiply of the low halves; the gradient reads bits 13..15,
+    // which depend on every input bit of that half.
+    inline uint32_t Hash(uint32_t seed, uint32_t xp, uint32_t zp) noexcept {
+        return (((seed ^ xp ^ zp) & 0xFFFF) * HASH_MUL16) & 0xFFFF;
+    }
+
+    // Gradient (+-1, +-2) or (+-2, +-1) picked by hash bits 13..15.
+    inline void GradVec(uint32_t h, int32_t& gx, int32_t& gz) noexcept {
+        const int32_t a = 1 + static_cast<int32_t>((h >> 13) & 1);
+        gx = ((h >> 14) & 1) ? -a : a;
+        gz = ((h >> 15) & 1) ? -(3 - a) : (3 - a);
+    }
+
+    // Corner offset (Q16, |d| < 2^16) dotted with the gradient, in Q13.
+    inline int32_t Grad(uint32_t h, int32_t dx, int32_t dz) noexcept {
+        int32_t gx, gz;
+        GradVec(h, gx, gz);
+        return (gx * dx + gz * dz) >> 3;
+    }
+
+    // a + (b - a) * w as a * (1 - w) + b * w, w in Q12; |a|, |b| <= 3 * 2^13.
+    inline int32_t Lerp(int32_t a, int32_t b, int32_t w) noexcept {
+        return (a * (FADE_ONE - w) + b * w) >> 12;
+    }
+
+    // Quintic 6t^5 - 15t^4 + 10t^3, Q16 in, Q12 out.
+    // Every product is of two values below 2^16, high half kept (inner >> 4 <= 40960).
+    inline int32_t Fade(int32_t t) noexcept {
+        const uint32_t u     = static_cast<uint32_t>(t);
+        const uint32_t t2    = (u * u) >> 16;
+        const uint32_t t3    = (t2 * u) >> 16;
+        const int32_t  inner = 6 * static_cast<int32_t>(t2) - 15 * t + 10 * ONE; // [ONE, 10 * ONE]
+        return static_cast<int32_t>((t3 * static_cast<uint32_t>(inner >> 4)) >> 16);
+    }
+
+    // Cell fraction of a masked coordinate, rescaled to Q16 (one of the shifts is 0).
+    inline int32_t Frac(int32_t fixed, int32_t shift) noexcept {
+        const int32_t m = fixed & ((1 << shift) - 1);
+        return (m << std::max(16 - shift, 0)) >> std::max(shift - 16, 0);
+    }
+
+    // One octave at fixed-point (fx, fz), Q15.
+    inline int32_t Single(const Octave& o, int32_t fx, int32_t fz) noexcept {
+        fx += o.OffsetX;
+        fz += o.OffsetZ;
+        const int32_t  tx = Frac(fx, o.Shift), tz = Frac(fz, o.Shift);
+        const uint32_t xp = static_cast<uint32_t>(fx >> o.Shift) * PRIME_X;
+        const uint32_t zp = static_cast<uint32_t>(fz >> o.Shift) * PRIME_Z;
+        const uint32_t s  = static_cast<uint32_t>(o.Seed);
+
+        const int32_t d00 = Grad(Hash(s, xp,           zp),           tx,       tz);
+        const int32_t d10 = Grad(Hash(s, xp + PRIME_X, zp),           tx - ONE, tz);
+        const int32_t d01 = Grad(Hash(s, xp,           zp + PRIME_Z), tx,       tz - ONE);
+        const int32_t d11 = Grad(Hash(s, xp + PRIME_X, zp + PRIME_Z), tx - ONE, tz - ONE);
+
+        const int32_t u = Fade(tx), v = Fade(tz);
+        const int32_t n = Lerp(Lerp(d00, d10, u), Lerp(d01, d11, u), v);
+        return std::clamp((n * NORM) >> 12, -CLAMP, CLAMP);
+    }
+
+    template <NoiseLayer::Fractal F>
+    inline float FractalScalar(const Octave* oct, int32_t octaves, float x, float z) noexcept {
+        const int32_t fx = ToFixed(x), fz = ToFixed(z);
+        if constexpr (F == NoiseLayer::Fractal::None)
+            return static_cast<float>(Single(oct[0], fx, fz)) * OUT_SCALE;
+
+        int32_t sum = 0;
+        for (int32_t o = 0; o < octaves; ++o) {
+            int32_t n = Single(oct[o], fx, fz);
+            if constexpr (F == NoiseLayer::Fractal::Ridged) n = CLAMP - 2 * (n < 0 ? -n : n);
+            sum += (n * oct[o].Amp) >> 15;
+        }
+        return static_cast<float>(sum) * OUT_SCALE;
+    }
+
+    template <NoiseLayer::Fractal F>
+    void EvaluateScalar(const Octave* oct, int32_t octaves, const float* xs, const float* zs, float* out, size_t count) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = FractalScalar<F>(oct, octaves, xs[i], zs[i]);
+    }
+
+#if LATTICE_NOISE_X86
+
+    // --- SSE4.1 kernel (4 lanes) ---
+    // Same integer steps as the scalar reference. Lanes holding values below 2^16
+    // (or in int16 range with a zero upper half on the other operand) let the 16-bit
+    // multiplies produce exact 32-bit results.
+
+    NOISE_TARGET_SSE41 inline __m128i ToFixedSSE41(__m128 v) {
+        v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-LatticeNoise::LIMIT)), _mm_set1_ps(LatticeNoise::LIMIT));
+        return _mm_cvtps_epi32(_mm_floor_ps(_mm_mul_ps(v, _mm_set1_ps(FIXED_SCALE))));
+    }
+
+    // |g| * d is d or 2d (blend); psign applies the hash sign bits (h | 1 keeps the selector non-zero).
+    NOISE_TARGET_SSE41 inline __m128i GradSSE41(__m128i seedX, __m128i zp, __m128i dx, __m128i dz) {
+        const __m128i h    = _mm_mullo_epi16(_mm_xor_si128(seedX, zp), _mm_set1_epi32(HASH_MUL16));
+        const __m128i h1   = _mm_or_si128(h, _mm_set1_epi32(1));
+        const __m128i one  = _mm_set1_epi32(1);
+        const __m128i wide = _mm_cmpeq_epi32(_mm_and_si128(_mm_srli_epi32(h, 13), one), one); // |gx| = 2, |gz| = 1
+        const __m128i px   = _mm_blendv_epi8(dx, _mm_add_epi32(dx, dx), wide);
+        const __m128i pz   = _mm_blendv_epi8(_mm_add_epi32(dz, dz), dz, wide);
+        const __m128i gx   = _mm_sign_epi32(px, _mm_slli_epi32(h1, 17)); // bit 14 -> sign
+        const __m128i gz   = _mm_sign_epi32(pz, _mm_slli_epi32(h1, 16)); // bit 15 -> sign
+        return _mm_srai_epi32(_mm_add_epi32(gx, gz), 3);
+    }
+
+    NOISE_TARGET_SSE41 inline __m128i FadeSSE41(__m128i t) {
+        const __m128i t2    = _mm_mulhi_epu16(t, t);
+        const __m128i t3    = _mm_mulhi_epu16(t2, t);
+        const __m128i six   = _mm_add_epi32(_mm_slli_epi32(t2, 2), _mm_slli_epi32(t2, 1));
+        const __m128i inner = _mm_add_epi32(_mm_sub_epi32(six, _mm_sub_epi32(_mm_slli_epi32(t, 4), t)), _mm_set1_epi32(10 * ONE));
+        return _mm_mulhi_epu16(t3, _mm_srai_epi32(inner, 4));
+    }
+
+    // (1 - w, w) packed as 16-bit halves, for LerpSSE41.
+    NOISE_TARGET_SSE41 inline __m128i WeightsSSE41(__m128i w) {
+        return _mm_or_si128(_mm_sub_epi32(_mm_set1_epi32(FADE_ONE), w), _mm_slli_epi32(w, 16));
+    }
+
+    // a * (1 - w) + b * w in one pmaddwd on (a, b) packed as 16-bit halves.
+    NOISE_TARGET_SSE41 inline __m128i LerpSSE41(__m128i a, __m128i b, __m128i weights) {
+        const __m128i ab = _mm_blend_epi16(a, _mm_slli_epi32(b, 16), 0xAA);
+        return _mm_srai_epi32(_mm_madd_epi16(ab, weights), 12);
+    }
+
+    NOISE_TARGET_SSE41 inline __m128i SingleSSE41(const Octave& o, __m128i fx, __m128i fz) {
+        fx = _mm_add_epi32(fx, _mm_set1_epi32(o.OffsetX));
+        fz = _mm_add_epi32(fz, _mm_set1_epi32(o.OffsetZ));
+
+        const __m128i shift = _mm_cvtsi32_si128(o.Shift);
+        const __m128i lsh   = _mm_cvtsi32_si128(std::max(16 - o.Shift, 0));
+        const __m128i rsh   = _mm_cvtsi32_si128(std::max(o.Shift - 16, 0));
+        const __m128i mask  = _mm_set1_epi32((1 << o.Shift) - 1);
+        const __m128i tx = _mm_srl_epi32(_mm_sll_epi32(_mm_and_si128(fx, mask), lsh), rsh);
+        const __m128i tz = _mm_srl_epi32(_mm_sll_epi32(_mm_and_si128(fz, mask), lsh), rsh);
+
+        // Only the low 16 bits reach the hash, so the primes are applied with 16-bit multiplies.
+        const __m128i px   = _mm_set1_epi32(static_cast<int32_t>(PRIME_X & 0xFFFF));
+        const __m128i pz   = _mm_set1_epi32(static_cast<int32_t>(PRIME_Z & 0xFFFF));
+        const __m128i xp   = _mm_mullo_epi16(_mm_sra_epi32(fx, shift), px);
+        const __m128i zp   = _mm_mullo_epi16(_mm_sra_epi32(fz, shift), pz);
+        const __m128i xpN  = _mm_add_epi32(xp, px);
+        const __m128i zpN  = _mm_add_epi32(zp, pz);
+        const __m128i txN  = _mm_sub_epi32(tx, _mm_set1_epi32(ONE));
+        const __m128i tzN  = _mm_sub_epi32(tz, _mm_set1_epi32(ONE));
+        const __m128i seed = _mm_set1_epi32(o.Seed);
+        const __m128i sx0  = _mm_xor_si128(seed, xp);
+        const __m128i sx1  = _mm_xor_si128(seed, xpN);
+
+        const __m128i d00 = GradSSE41(sx0, zp,  tx,  tz);
+        const __m128i d10 = GradSSE41(sx1, zp,  txN, tz);
+        const __m128i d01 = GradSSE41(sx0, zpN, tx,  tzN);
+        const __m128i d11 = GradSSE41(sx1, zpN, txN, tzN);
+
+        const __m128i u = WeightsSSE41(FadeSSE41(tx)), v = WeightsSSE41(FadeSSE41(tz));
+        const __m128i n = LerpSSE41(LerpSSE41(d00, d10, u), LerpSSE41(d01, d11, u), v);
+        const __m128i r = _mm_srai_epi32(_mm_madd_epi16(n, _mm_set1_epi32(NORM)), 12);
+        return _mm_max_epi32(_mm_min_epi32(r, _mm_set1_epi32(CLAMP)), _mm_set1_epi32(-CLAMP));
+    }
+
+    template <NoiseLayer::Fractal F>
+    NOISE_TARGET_SSE41 inline __m128 FractalSSE41(const Octave* oct, int32_t octaves, __m128 x, __m128 z) {
+        const __m128i fx = ToFixedSSE41(x), fz = ToFixedSSE41(z);
+        if constexpr (F == NoiseLayer::Fractal::None)
+            return _mm_mul_ps(_mm_cvtepi32_ps(SingleSSE41(oct[0], fx, fz)), _mm_set1_ps(OUT_SCALE));
+
+        __m128i sum = _mm_setzero_si128();
+        for (int32_t o = 0; o < octaves; ++o) {
+            __m128i n = SingleSSE41(oct[o], fx, fz);
+            if constexpr (F == NoiseLayer::Fractal::Ridged)
+                n = _mm_sub_epi32(_mm_set1_epi32(CLAMP), _mm_slli_epi32(_mm_abs_epi32(n), 1));
+            sum = _mm_add_epi32(sum, _mm_srai_epi32(_mm_madd_epi16(n, _mm_set1_epi32(oct[o].Amp)), 15));
+        }
+        return _mm_mul_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(OUT_SCALE));
+    }
+
+    template <NoiseLayer::Fractal F>
+    NOISE_TARGET_SSE41 void EvaluateSSE41(const Octave* oct, int32_t octaves, const float* xs, const float* zs,
+                                          float* out, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, FractalSSE41<F>(oct, octaves, _mm_loadu_ps(xs + i), _mm_loadu_ps(zs + i)));
+
+        if (i < count) { // tail: pad with the last sample
+            alignas(16) float tx[4], tz[4], to[4];
+            for (size_t k = 0; k < 4; ++k) {
+                const size_t src = std::min(i + k, count - 1);
+                tx[k] = xs[src];
+                tz[k] = zs[src];
+            }
+            _mm_store_ps(to, FractalSSE41<F>(oct, octaves, _mm_load_ps(tx), _mm_load_ps(tz)));
+            std::memcpy(out + i, to, (count - i) * sizeof(float));
+        }
+    }
+
+    // --- AVX2 kernel (8 lanes) ---
+
+    NOISE_TARGET_AVX2 inline __m256i ToFixedAVX2(__m256 v) {
+        v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-LatticeNoise::LIMIT)), _mm256_set1_ps(LatticeNoise::LIMIT));
+        return _mm256_cvtps_epi32(_mm256_floor_ps(_mm256_mul_ps(v, _mm256_set1_ps(FIXED_SCALE))));
+    }
+
+    // Magnitude by variable shift instead of a blend.
+    NOISE_TARGET_AVX2 inline __m256i GradAVX2(__m256i seedX, __m256i zp, __m256i dx, __m256i dz) {
+        const __m256i h    = _mm256_mullo_epi16(_mm256_xor_si256(seedX, zp), _mm256_set1_epi32(HASH_MUL16));
+        const __m256i h1   = _mm256_or_si256(h, _mm256_set1_epi32(1));
+        const __m256i wide = _mm256_and_si256(_mm256_srli_epi32(h, 13), _mm256_set1_epi32(1));
+        const __m256i px   = _mm256_sllv_epi32(dx, wide);
+        const __m256i pz   = _mm256_sllv_epi32(dz, _mm256_xor_si256(wide, _mm256_set1_epi32(1)));
+        const __m256i gx   = _mm256_sign_epi32(px, _mm256_slli_epi32(h1, 17));
+        const __m256i gz   = _mm256_sign_epi32(pz, _mm256_slli_epi32(h1, 16));
+        return _mm256_srai_epi32(_mm256_add_epi32(gx, gz), 3);
+    }
+
+    NOISE_TARGET_AVX2 inline __m256i FadeAVX2(__m256i t) {
+        const __m256i t2    = _mm256_mulhi_epu16(t, t);
+        const __m256i t3    = _mm256_mulhi_epu16(t2, t);
+        const __m256i six   = _mm256_add_epi32(_mm256_slli_epi32(t2, 2), _mm256_slli_epi32(t2, 1));
+        const __m256i inner = _mm256_add_epi32(_mm256_sub_epi32(six, _mm256_sub_epi32(_mm256_slli_epi32(t, 4), t)),
+                                               _mm256_set1_epi32(10 * ONE));
+        return _mm256_mulhi_epu16(t3, _mm256_srai_epi32(inner, 4));
+    }
+
+    NOISE_TARGET_AVX2 inline __m256i WeightsAVX2(__m256i w) {
+        return _mm256_or_si256(_mm256_sub_epi32(_mm256_set1_epi32(FADE_ONE), w), _mm256_slli_epi32(w, 16));
+    }
+
+    NOISE_TARGET_AVX2 inline __m256i LerpAVX2(__m256i a, __m256i b, __m256i weights) {
+        const __m256i ab = _mm256_blend_epi16(a, _mm256_slli_epi32(b, 16), 0xAA);
+        return _mm256_srai_epi32(_mm256_madd_epi16(ab, weights), 12);
+    }
+
+    NOISE_TARGET_AVX2 inline __m256i SingleAVX2(const Octave& o, __m256i fx, __m256i fz) {
+        fx = _mm256_add_epi32(fx, _mm256_set1_epi32(o.OffsetX));
+        fz = _mm256_add_epi32(fz, _mm256_set1_epi32(o.OffsetZ));
+
+        const __m128i shift = _mm_cvtsi32_si128(o.Shift);
+        const __m128i lsh   = _mm_cvtsi32_si128(std::max(16 - o.Shift, 0));
+        const __m128i rsh   = _mm_cvtsi32_si128(std::max(o.Shift - 16, 0));
+        const __m256i mask  = _mm256_set1_epi32((1 << o.Shift) - 1);
+        const __m256i tx = _mm256_srl_epi32(_mm256_sll_epi32(_mm256_and_si256(fx, mask), lsh), rsh);
+        const __m256i tz = _mm256_srl_epi32(_mm256_sll_epi32(_mm256_and_si256(fz, mask), lsh), rsh);
+
+        // Only the low 16 bits reach the hash, so the primes are applied with 16-bit multiplies.
+        const __m256i px   = _mm256_set1_epi32(static_cast<int32_t>(PRIME_X & 0xFFFF));
+        const __m256i pz   = _mm256_set1_epi32(static_cast<int32_t>(PRIME_Z & 0xFFFF));
+        const __m256i xp   = _mm256_mullo_epi16(_mm256_sra_epi32(fx, shift), px);
+        const __m256i zp   = _mm256_mullo_epi16(_mm256_sra_epi32(fz, shift), pz);
+        const __m256i xpN  = _mm256_add_epi32(xp, px);
+        const __m256i zpN  = _mm256_add_epi32(zp, pz);
+        const __m256i txN  = _mm256_sub_epi32(tx, _mm256_set1_epi32(ONE));
+        const __m256i tzN  = _mm256_sub_epi32(tz, _mm256_set1_epi32(ONE));
+        const __m256i seed = _mm256_set1_epi32(o.Seed);
+        const __m256i sx0  = _mm256_xor_si256(seed, xp);
+        const __m256i sx1  = _mm256_xor_si256(seed, xpN);
+
+        const __m256i d00 = GradAVX2(sx0, zp,  tx,  tz);
+        const __m256i d10 = GradAVX2(sx1, zp,  txN, tz);
+        const __m256i d01 = GradAVX2(sx0, zpN, tx,  tzN);
+        const __m256i d11 = GradAVX2(sx1, zpN, txN, tzN);
+
+        const __m256i u = WeightsAVX2(FadeAVX2(tx)), v = WeightsAVX2(FadeAVX2(tz));
+        const __m256i n = LerpAVX2(LerpAVX2(d00, d10, u), LerpAVX2(d01, d11, u), v);
+        const __m256i r = _mm256_srai_epi32(_mm256_madd_epi16(n, _mm256_set1_epi32(NORM)), 12);
+        return _mm256_max_epi32(_mm256_min_epi32(r, _mm256_set1_epi32(CLAMP)), _mm256_set1_epi32(-CLAMP));
+    }
+
+    template <NoiseLayer::Fractal F>
+    NOISE_TARGET_AVX2 inline __m256 FractalAVX2(const Octave* oct, int32_t octaves, __m256 x, __m256 z) {
+        const __m256i fx = ToFixedAVX2(x), fz = ToFixedAVX2(z);
+        if constexpr (F == NoiseLayer::Fractal::None)
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(SingleAVX2(oct[0], fx, fz)), _mm256_set1_ps(OUT_SCALE));
+
+        __m256i sum = _mm256_setzero_si256();
+        for (int32_t o = 0; o < octaves; ++o) {
+            __m256i n = SingleAVX2(oct[o], fx, fz);
+            if constexpr (F == NoiseLayer::Fractal::Ridged)
+                n = _mm256_sub_epi32(_mm256_set1_epi32(CLAMP), _mm256_slli_epi32(_mm256_abs_epi32(n), 1));
+            sum = _mm256_add_epi32(sum, _mm256_srai_epi32(_mm256_madd_epi16(n, _mm256_set1_epi32(oct[o].Amp)), 15));
+        }
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(sum), _mm256_set1_ps(OUT_SCALE));
+    }
+
+    template <NoiseLayer::Fractal F>
+    NOISE_TARGET_AVX2 void EvaluateAVX2(const Octave* oct, int32_t octaves, const float* xs, const float* zs,
+                                        float* out, size_t count) {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(out + i, FractalAVX2<F>(oct, octaves, _mm256_loadu_ps(xs + i), _mm256_loadu_ps(zs + i)));
+
+        if (i < count) { // tail: pad with the last sample
+            alignas(32) float tx[8], tz[8], to[8];
+            for (size_t k = 0; k < 8; ++k) {
+                const size_t src = std::min(i + k, count - 1);
+                tx[k] = xs[src];
+                tz[k] = zs[src];
+            }
+            _mm256_store_ps(to, FractalAVX2<F>(oct, octaves, _mm256_load_ps(tx), _mm256_load_ps(tz)));
+            std::memcpy(out + i, to, (count - i) * sizeof(float));
+        }
+    }
+
+#endif // LATTICE_NOISE_X86
+
+    template <NoiseLayer::Fractal F>
+    void Dispatch(const Octave* oct, int32_t octaves, const float* xs, const float* zs, float* out, size_t count) {
+        switch (NoiseBatch::GetISA()) {
+#if LATTICE_NOISE_X86
+            case NoiseBatch::ISA::AVX2:  EvaluateAVX2<F>(oct, octaves, xs, zs, out, count);  return;
+            case NoiseBatch::ISA::SSE41: EvaluateSSE41<F>(oct, octaves, xs, zs, out, count); return;
+#endif
+            default:                     EvaluateScalar<F>(oct, octaves, xs, zs, out, count); return;
+        }
+    }
+}
+
+LatticeNoise::LatticeNoise(int32_t seed, float frequency, NoiseLayer::Fractal fractal, int32_t octaves, float gain)
+    : m_Fractal(fractal),
+      m_Octaves(fractal == NoiseLayer::Fractal::None ? 1 : std::clamp(octaves, 1, MAX_OCTAVES)) {
+    // Power-of-two cell size nearest (in log scale) to 1 / frequency, in fixed-point units.
+    const double period = static_cast<double>(FIXED_SCALE) / static_cast<double>(frequency);
+    int32_t shift = 1;
+    while (shift < 30 && static_cast<double>(1 << (shift + 1)) <= period * 1.4142135623730951)
+        ++shift;
+
+    // Amplitudes follow NoiseLayer::Bounding (weighted strength 0); floored to Q15 so
+    // they never sum past 1.
+    double total = 0.0, amp = 1.0;
+    for (int32_t o = 0; o < m_Octaves; ++o) {
+        total += amp;
+        amp *= gain;
+    }
+    amp = 1.0 / total;
+
+    for (int32_t o = 0; o < m_Octaves; ++o) {
+        Octave& oct = m_Oct[o];
+        oct.Seed  = NoiseScalar::WrapAdd(seed, o);
+        oct.Shift = std::max(shift - o, 1);
+        const uint32_t h = Hash(static_cast<uint32_t>(oct.Seed), PRIME_X * static_cast<uint32_t>(o + 1), PRIME_Z);
+        oct.OffsetX = static_cast<int32_t>(h & OFFSET_MASK);
+        oct.OffsetZ = static_cast<int32_t>((h >> 11) & OFFSET_MASK);
+        oct.Amp     = std::min(static_cast<int32_t>(std::floor(amp * 32768.0)), CLAMP); // int16 for pmaddwd
+        amp *= gain;
+    }
+}
+
+float LatticeNoise::GetCellSize() const noexcept {
+    return GetWavelength(0);
+}
+
+float LatticeNoise::GetNoise(float x, float z) const noexcept {
+    switch (m_Fractal) {
+        case NoiseLayer::Fractal::None:   return FractalScalar<NoiseLayer::Fractal::None>(m_Oct.data(), 1, x, z);
+        case NoiseLayer::Fractal::FBm:    return FractalScalar<NoiseLayer::Fractal::FBm>(m_Oct.data(), m_Octaves, x, z);
+        case NoiseLayer::Fractal::Ridged: return FractalScalar<NoiseLayer::Fractal::Ridged>(m_Oct.data(), m_Octaves, x, z);
+    }
+    return 0.0f;
+}
+
+void LatticeNoise::GetNoise(const float* xs, const float* zs, float* out, size_t count) const {
+    if (count == 0) return;
+    switch (m_Fractal) {
+        case NoiseLayer::Fractal::None:   Dispatch<NoiseLayer::Fractal::None>(m_Oct.data(), 1, xs, zs, out, count);            return;
+        case NoiseLayer::Fractal::FBm:    Dispatch<NoiseLayer::Fractal::FBm>(m_Oct.data(), m_Octaves, xs, zs, out, count);    return;
+        case NoiseLayer::Fractal::Ridged: Dispatch<NoiseLayer::Fractal::Ridged>(m_Oct.data(), m_Octaves, xs, zs, out, count); return;
+    }
+}
+
+void LatticeNoise::GetNoise(const float* xs, const float* zs, float* out, size_t count, int32_t octaves) const {
+    if (octaves >= m_Octaves) {
+        GetNoise(xs, zs, out, count);
+        return;
+    }
+    if (octaves <= 0) {
+        std::fill(out, out + count, 0.0f);
+        return;
+    }
+    if (count == 0) return;
+    // None has a single octave, handled above.
+    if (m_Fractal == NoiseLayer::Fractal::FBm) Dispatch<NoiseLayer::Fractal::FBm>(m_Oct.data(), octaves, xs, zs, out, count);
+    else                                       Dispatch<NoiseLayer::Fractal::Ridged>(m_Oct.data(), octaves, xs, zs, out, count);
+}
+
+int32_t LatticeNoise::OctavesAbove(float minWavelength) const noexcept {
+    int32_t o = 0;
+    while (o < m_Octaves && GetWavelength(o) >= minWavelength) ++o;
+    return o;
+}
+
+float LatticeNoise::GetWavelength(int32_t o) const noexcept {
+    return static_cast<float>(1 << m_Oct[o].Shift) / FIXED_SCALE;
+}
+
+float LatticeNoise::GetNoiseDeriv(float x, float z, float& outDx, float& outDz) const noexcept {
+    const int32_t fx = ToFixed(x), fz = ToFixed(z);
+    float   gx = 0.0f, gz = 0.0f;
+    int32_t sum = 0; // FractalScalar's sum, so the value needs no second pass
+
+    for (int32_t o = 0; o < m_Octaves; ++o) {
+        const Octave& oct = m_Oct[o];
+        const int32_t n   = Single(oct, fx, fz);
+        switch (m_Fractal) {
+            case NoiseLayer::Fractal::None:   sum = n; break;
+            case NoiseLayer::Fractal::FBm:    sum += (n * oct.Amp) >> 15; break;
+            case NoiseLayer::Fractal::Ridged: sum += ((CLAMP - 2 * (n < 0 ? -n : n)) * oct.Amp) >> 15; break;
+        }
+        if (n == CLAMP || n == -CLAMP) continue; // a saturated octave is flat
+
+        const int32_t ox = fx + oct.OffsetX, oz = fz + oct.OffsetZ;
+        const float   tx = static_cast<float>(Frac(ox, oct.Shift)) / ONE;
+        const float   tz = static_cast<float>(Frac(oz, oct.Shift)) / ONE;
+        const uint32_t xp = static_cast<uint32_t>(ox >> oct.Shift) * PRIME_X;
+        const uint32_t zp = static_cast<uint32_t>(oz >> oct.Shift) * PRIME_Z;
+        const uint32_t s  = static_cast<uint32_t>(oct.Seed);
+
+        // Corner gradients and dot products in cell units.
+        int32_t g[4][2];
+        GradVec(Hash(s, xp,           zp),           g[0][0], g[0][1]);
+        GradVec(Hash(s, xp + PRIME_X, zp),           g[1][0], g[1][1]);
+        GradVec(Hash(s, xp,           zp + PRIME_Z), g[2][0], g[2][1]);
+        GradVec(Hash(s, xp + PRIME_X, zp + PRIME_Z), g[3][0], g[3][1]);
+        const float a00 = g[0][0] * tx          + g[0][1] * tz;
+        const float a10 = g[1][0] * (tx - 1.0f) + g[1][1] * tz;
+        const float a01 = g[2][0] * tx          + g[2][1] * (tz - 1.0f);
+        const float a11 = g[3][0] * (tx - 1.0f) + g[3][1] * (tz - 1.0f);
+
+        auto fade      = [](float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); };
+        auto fadeSlope = [](float t) { return 30.0f * t * t * (t - 1.0f) * (t - 1.0f); };
+        const float u = fade(tx), du = fadeSlope(tx);
+        const float v = fade(tz), dv = fadeSlope(tz);
+
+        const float x0 = a00 + (a10 - a00) * u, x1 = a01 + (a11 - a01) * u;
+        const float dx0 = g[0][0] + (g[1][0] - g[0][0]) * u + (a10 - a00) * du;
+        const float dx1 = g[2][0] + (g[3][0] - g[2][0]) * u + (a11 - a01) * du;
+        const float dz0 = g[0][1] + (g[1][1] - g[0][1]) * u;
+        const float dz1 = g[2][1] + (g[3][1] - g[2][1]) * u;
+        float dnx = dx0 + (dx1 - dx0) * v;
+        float dnz = dz0 + (dz1 - dz0) * v + (x1 - x0) * dv;
+
+        // Cell units -> world units, lattice value -> output scale, octave amplitude.
+        const float amp = (m_Fractal == NoiseLayer::Fractal::None) ? 1.0f : static_cast<float>(oct.Amp) / 32768.0f;
+        float w = static_cast<float>(NORM) / 16384.0f * amp / (static_cast<float>(1 << oct.Shift) / FIXED_SCALE);
+        if (m_Fractal == NoiseLayer::Fractal::Ridged)
+            w *= (n < 0) ? 2.0f : -2.0f;
+        gx += dnx * w;
+        gz += dnz * w;
+    }
+
+    outDx = gx;
+    outDz = gz;
+    return static_cast<float>(sum) * OUT_SCALE;
+}
+
+void LatticeNoise::GetNoiseDeriv(const float* xs, const float* zs, float* out, float* outDx, float* outDz,
+                                 size_t count) const noexcept {
+    for (size_t i = 0; i < count; ++i)
+        out[i] = GetNoiseDeriv(xs[i], zs[i], outDx[i], outDz[i]);
+}
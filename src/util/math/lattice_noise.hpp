@@ -0,0 +1,77 @@
+#pragma once
+
+#include "util/math/noise_batch.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// 2D gradient noise evaluated entirely in integer / fixed-point arithmetic.
+//
+// Input coordinates are snapped to a 1/256 fixed-point grid (exact for every
+// float the terrain passes in below LIMIT). Cells are powers of two on that grid,
+// so lattice index and fraction are shifts and masks; corners are hashed with
+// 32-bit wrapping multiplies, gradients come from hash bits (no table lookups),
+// and interpolation and octave sums are bounded integer products. The only float
+// operations are the floor of the scaled input and one exact power-of-two scale
+// of the result, so every kernel (scalar, SSE4.1, AVX2) and every compiler
+// produces the same bits.
+//
+// Not a drop-in for StaticNoise: the cell size is the power of two nearest to
+// 1 / frequency, lacunarity is fixed at 2 and the pattern is Perlin-like rather
+// than OpenSimplex2. Octaves are scaled to the spread of the OpenSimplex2 modules
+// (similar standard deviation) and clamped to [-1, 1]; a single octave saturates
+// on roughly 6% of samples.
+class LatticeNoise {
+public:
+    static constexpr int32_t MAX_OCTAVES = 8;
+    static constexpr float   LIMIT       = 4000000.0f; // |x|, |z| clamp in world units
+
+    LatticeNoise() : LatticeNoise(1337, 0.01f) {}
+
+    // gain is applied in Q15, like the per-octave amplitudes of NoiseLayer.
+    LatticeNoise(int32_t seed, float frequency,
+                 NoiseLayer::Fractal fractal = NoiseLayer::Fractal::None, int32_t octaves = 1,
+                 float gain = 0.5f);
+
+    float GetNoise(float x, float z) const noexcept;
+
+    // out[i] = GetNoise(xs[i], zs[i]) for i < count, on the NoiseBatch::GetISA() kernel.
+    void GetNoise(const float* xs, const float* zs, float* out, size_t count) const;
+
+    // Same, summing only the first 'octaves' octaves (their amplitudes unchanged, so
+    // still deterministic); 0 octaves reads 0.
+    void GetNoise(const float* xs, const float* zs, float* out, size_t count, int32_t octaves) const;
+
+    // Number of leading octaves whose cell size is at least minWavelength, and the
+    // cell size of octave o (the lattice counterpart of a wavelength).
+    int32_t OctavesAbove(float minWavelength) const noexcept;
+    float   GetWavelength(int32_t o) const noexcept;
+    int32_t GetOctaves() const noexcept { return m_Octaves; }
+
+    // GetNoise(x, z) (same bits) plus its gradient d/dx, d/dz. The gradient is
+    // computed in float from the same corner data and is not part of the
+    // determinism guarantee.
+    float GetNoiseDeriv(float x, float z, float& outDx, float& outDz) const noexcept;
+
+    // out[i] = GetNoiseDeriv(xs[i], zs[i], outDx[i], outDz[i]) for i < count (scalar loop).
+    void GetNoiseDeriv(const float* xs, const float* zs, float* out, float* outDx, float* outDz,
+                       size_t count) const noexcept;
+
+    // World units per lattice cell of the first octave.
+    float GetCellSize() const noexcept;
+
+    // Per-octave constants, shared with the batch kernels.
+    struct Octave {
+        int32_t Seed;
+        int32_t Shift;         // log2 of the cell size in fixed-point units
+        int32_t OffsetX;       // fixed-point offset, breaks octave lattice alignment
+        int32_t OffsetZ;
+        int32_t Amp;           // Q15, at most 32767
+    };
+
+private:
+    NoiseLayer::Fractal              m_Fractal = NoiseLayer::Fractal::None;
+    int32_t                          m_Octaves = 1;
+    std::array<Octave, MAX_OCTAVES>  m_Oct{};
+};
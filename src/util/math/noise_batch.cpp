@@ -0,0 +1,798 @@
+#include "util/math/noise_batch.hpp"
+#include "util/math/noise_scalar.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define NOISE_BATCH_X86 1
+    #include <immintrin.h>
+    #define NOISE_TARGET_SSE41 __attribute__((target("sse4.1")))
+    // Deliberately "avx2" without "fma": FMA would let the compiler fuse the
+    // mul/add pairs and break bit-equality with the scalar FastNoiseLite path.
+    #define NOISE_TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+// --- NoiseLayer ---
+
+float NoiseLayer::Bounding() const noexcept {
+    // Same loop as FastNoiseLite::CalculateFractalBounding.
+    const float gain = Gain < 0 ? -Gain : Gain;
+    float amp        = gain;
+    float ampFractal = 1.0f;
+    for (int32_t i = 1; i < Octaves; i++) {
+        ampFractal += amp;
+        amp *= gain;
+    }
+    return 1 / ampFractal;
+}
+
+void NoiseLayer::Apply(FastNoiseLite& noise) const {
+    noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    noise.SetSeed(Seed);
+    noise.SetFrequency(Frequency);
+    switch (FractalType) {
+        case Fractal::None:   noise.SetFractalType(FastNoiseLite::FractalType_None);   break;
+        case Fractal::FBm:    noise.SetFractalType(FastNoiseLite::FractalType_FBm);    break;
+        case Fractal::Ridged: noise.SetFractalType(FastNoiseLite::FractalType_Ridged); break;
+    }
+    noise.SetFractalOctaves(Octaves);
+    noise.SetFractalLacunarity(Lacunarity);
+    noise.SetFractalGain(Gain);
+}
+
+namespace {
+
+using namespace NoiseScalar;
+
+constexpr int32_t kMaxOctaves = 16;
+
+// Per-call constants derived from a NoiseLayer.
+struct Prepared {
+    int32_t            seed;
+    float              frequency;
+    float              lacunarity;
+    NoiseLayer::Fractal fractal;
+    int32_t            octaves;
+    float              amps[kMaxOctaves];
+    float              slopes[kMaxOctaves]; // amps[o] * lacunarity^o: octave weight in the gradient
+};
+
+// keep > 0 truncates the octave loop after the amplitudes are set for all 'octaves'.
+Prepared Prepare(const NoiseLayer& layer, NoiseLayer::Fractal fractal, int32_t octaves, int32_t keep = 0) {
+    Prepared p{};
+    p.seed       = layer.Seed;
+    p.frequency  = layer.Frequency;
+    p.lacunarity = layer.Lacunarity;
+    p.fractal    = fractal;
+    p.octaves    = std::clamp(octaves, 1, kMaxOctaves);
+
+    // Amplitude sequence of GenFractalFBm / GenFractalRidged. With weighted
+    // strength 0 the per-octave Lerp term is exactly 1, so amp only follows gain.
+    NoiseLayer fixed = layer;
+    fixed.Octaves    = p.octaves;
+    float amp = fixed.Bounding(), scale = 1.0f;
+    for (int32_t o = 0; o < p.octaves; ++o) {
+        p.amps[o]   = amp;
+        p.slopes[o] = amp * scale;
+        amp   *= layer.Gain;
+        scale *= layer.Lacunarity;
+    }
+    if (keep > 0) p.octaves = std::min(keep, p.octaves);
+    return p;
+}
+
+// --- Scalar kernel ---
+
+// OCT > 0 fixes the octave count at compile time (loop fully unrolled);
+// OCT == 0 takes it from Prepared at runtime.
+template <NoiseLayer::Fractal F, int32_t OCT>
+inline float FractalScalar(const Prepared& p, float x, float y) {
+    x *= p.frequency;
+    y *= p.frequency;
+    Skew(x, y);
+
+    if constexpr (F == NoiseLayer::Fractal::None) {
+        return Simplex2(p.seed, x, y);
+    } else {
+        const int32_t octaves = OCT > 0 ? OCT : p.octaves;
+        float sum = 0;
+        for (int32_t o = 0; o < octaves; ++o) {
+            float noise = Simplex2(WrapAdd(p.seed, o), x, y);
+            if constexpr (F == NoiseLayer::Fractal::FBm) {
+                sum += noise * p.amps[o];
+            } else {
+                noise = noise < 0 ? -noise : noise;
+                sum += (noise * -2 + 1) * p.amps[o];
+            }
+            x *= p.lacunarity;
+            y *= p.lacunarity;
+        }
+        return sum;
+    }
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+void EvaluateScalar(const Prepared& p, const float* xs, const float* zs, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        out[i] = FractalScalar<F, OCT>(p, xs[i], zs[i]);
+}
+
+// FractalScalar plus its gradient; the operations of StaticNoise::GetNoiseDeriv.
+template <NoiseLayer::Fractal F, int32_t OCT>
+inline float FractalDerivScalar(const Prepared& p, float x, float y, float& outDx, float& outDy) {
+    x *= p.frequency;
+    y *= p.frequency;
+    Skew(x, y);
+
+    // Gradient with respect to the skewed coordinates, chained through the skew at the end.
+    float gx = 0, gy = 0;
+    float sum;
+    if constexpr (F == NoiseLayer::Fractal::None) {
+        sum = Simplex2Deriv(p.seed, x, y, gx, gy);
+    } else {
+        sum = 0;
+        const int32_t octaves = OCT > 0 ? OCT : p.octaves;
+        for (int32_t o = 0; o < octaves; ++o) {
+            float dx, dy;
+            float noise = Simplex2Deriv(WrapAdd(p.seed, o), x, y, dx, dy);
+            float w = p.slopes[o];
+            if constexpr (F == NoiseLayer::Fractal::FBm) {
+                sum += noise * p.amps[o];
+            } else {
+                if (noise < 0) w = -w;
+                noise = noise < 0 ? -noise : noise;
+                sum += (noise * -2 + 1) * p.amps[o];
+                w *= -2.0f;
+            }
+            gx += dx * w;
+            gy += dy * w;
+            x *= p.lacunarity;
+            y *= p.lacunarity;
+        }
+    }
+
+    const float sk = (gx + gy) * F2;
+    outDx = (gx + sk) * p.frequency;
+    outDy = (gy + sk) * p.frequency;
+    return sum;
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+void EvaluateDerivScalar(const Prepared& p, const float* xs, const float* zs,
+                         float* out, float* outDx, float* outDz, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        out[i] = FractalDerivScalar<F, OCT>(p, xs[i], zs[i], outDx[i], outDz[i]);
+}
+
+#if NOISE_BATCH_X86
+
+// --- SSE4.1 kernel (4 lanes) ---
+
+NOISE_TARGET_SSE41 inline void GradVecSSE41(__m128i seed, __m128i xp, __m128i yp, __m128& xg, __m128& yg) {
+    __m128i hash = _mm_mullo_epi32(_mm_xor_si128(_mm_xor_si128(seed, xp), yp), _mm_set1_epi32(HASH_MUL));
+    hash = _mm_xor_si128(hash, _mm_srai_epi32(hash, 15));
+    hash = _mm_and_si128(hash, _mm_set1_epi32(127 << 1));
+
+    alignas(16) int32_t idx[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(idx), hash);
+    xg = _mm_setr_ps(Gradients2D[idx[0]],     Gradients2D[idx[1]],
+                     Gradients2D[idx[2]],     Gradients2D[idx[3]]);
+    yg = _mm_setr_ps(Gradients2D[idx[0] | 1], Gradients2D[idx[1] | 1],
+                     Gradients2D[idx[2] | 1], Gradients2D[idx[3] | 1]);
+}
+
+NOISE_TARGET_SSE41 inline __m128 GradSSE41(__m128i seed, __m128i xp, __m128i yp, __m128 xd, __m128 yd) {
+    __m128 xg, yg;
+    GradVecSSE41(seed, xp, yp, xg, yg);
+    return _mm_add_ps(_mm_mul_ps(xd, xg), _mm_mul_ps(yd, yg));
+}
+
+NOISE_TARGET_SSE41 inline __m128 SimplexSSE41(__m128i seed, __m128 x, __m128 y) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    // FastFloor: truncate, then step down for negative inputs.
+    __m128i i = _mm_add_epi32(_mm_cvttps_epi32(x), _mm_castps_si128(_mm_cmplt_ps(x, zero)));
+    __m128i j = _mm_add_epi32(_mm_cvttps_epi32(y), _mm_castps_si128(_mm_cmplt_ps(y, zero)));
+    const __m128 xi = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+    const __m128 yi = _mm_sub_ps(y, _mm_cvtepi32_ps(j));
+
+    const __m128 t  = _mm_mul_ps(_mm_add_ps(xi, yi), _mm_set1_ps(G2));
+    const __m128 x0 = _mm_sub_ps(xi, t);
+    const __m128 y0 = _mm_sub_ps(yi, t);
+
+    i = _mm_mullo_epi32(i, _mm_set1_epi32(PRIME_X));
+    j = _mm_mullo_epi32(j, _mm_set1_epi32(PRIME_Y));
+    const __m128i iNext = _mm_add_epi32(i, _mm_set1_epi32(PRIME_X));
+    const __m128i jNext = _mm_add_epi32(j, _mm_set1_epi32(PRIME_Y));
+
+    const __m128 a  = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0));
+    const __m128 aa = _mm_mul_ps(a, a);
+    __m128 n0 = _mm_mul_ps(_mm_mul_ps(aa, aa), GradSSE41(seed, i, j, x0, y0));
+    n0 = _mm_and_ps(n0, _mm_cmpgt_ps(a, zero));
+
+    const __m128 c  = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(C_T), t), _mm_add_ps(_mm_set1_ps(C_A), a));
+    const __m128 x2 = _mm_add_ps(x0, _mm_set1_ps(OFF_2));
+    const __m128 y2 = _mm_add_ps(y0, _mm_set1_ps(OFF_2));
+    const __m128 cc = _mm_mul_ps(c, c);
+    __m128 n2 = _mm_mul_ps(_mm_mul_ps(cc, cc), GradSSE41(seed, iNext, jNext, x2, y2));
+    n2 = _mm_and_ps(n2, _mm_cmpgt_ps(c, zero));
+
+    // Middle vertex: (0,1) when y0 > x0, otherwise (1,0).
+    const __m128  upper  = _mm_cmpgt_ps(y0, x0);
+    const __m128  offG2  = _mm_set1_ps(OFF_G2);
+    const __m128  offG2m = _mm_set1_ps(OFF_G2_M1);
+    const __m128  x1 = _mm_add_ps(x0, _mm_blendv_ps(offG2m, offG2, upper));
+    const __m128  y1 = _mm_add_ps(y0, _mm_blendv_ps(offG2, offG2m, upper));
+    const __m128i xp1 = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(iNext), _mm_castsi128_ps(i), upper));
+    const __m128i yp1 = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(j), _mm_castsi128_ps(jNext), upper));
+    const __m128  b  = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1));
+    const __m128  bb = _mm_mul_ps(b, b);
+    __m128 n1 = _mm_mul_ps(_mm_mul_ps(bb, bb), GradSSE41(seed, xp1, yp1, x1, y1));
+    n1 = _mm_and_ps(n1, _mm_cmpgt_ps(b, zero));
+
+    return _mm_mul_ps(_mm_add_ps(_mm_add_ps(n0, n1), n2), _mm_set1_ps(SIMPLEX_OUT));
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+NOISE_TARGET_SSE41 inline __m128 FractalSSE41(const Prepared& p, __m128 x, __m128 y) {
+    x = _mm_mul_ps(x, _mm_set1_ps(p.frequency));
+    y = _mm_mul_ps(y, _mm_set1_ps(p.frequency));
+    const __m128 t = _mm_mul_ps(_mm_add_ps(x, y), _mm_set1_ps(F2));
+    x = _mm_add_ps(x, t);
+    y = _mm_add_ps(y, t);
+
+    if constexpr (F == NoiseLayer::Fractal::None)
+        return SimplexSSE41(_mm_set1_epi32(p.seed), x, y);
+
+    const __m128 lac     = _mm_set1_ps(p.lacunarity);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 sum = _mm_setzero_ps();
+    const int32_t octaves = OCT > 0 ? OCT : p.octaves;
+    for (int32_t o = 0; o < octaves; ++o) {
+        __m128 noise = SimplexSSE41(_mm_set1_epi32(WrapAdd(p.seed, o)), x, y);
+        if constexpr (F == NoiseLayer::Fractal::FBm) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(noise, _mm_set1_ps(p.amps[o])));
+        } else {
+            noise = _mm_and_ps(noise, absMask);
+            const __m128 ridge = _mm_add_ps(_mm_mul_ps(noise, _mm_set1_ps(-2.0f)), _mm_set1_ps(1.0f));
+            sum = _mm_add_ps(sum, _mm_mul_ps(ridge, _mm_set1_ps(p.amps[o])));
+        }
+        x = _mm_mul_ps(x, lac);
+        y = _mm_mul_ps(y, lac);
+    }
+    return sum;
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+NOISE_TARGET_SSE41 void EvaluateSSE41(const Prepared& p, const float* xs, const float* zs, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(out + i, FractalSSE41<F, OCT>(p, _mm_loadu_ps(xs + i), _mm_loadu_ps(zs + i)));
+
+    if (i < count) { // tail: pad with the last sample
+        alignas(16) float tx[4], tz[4], to[4];
+        for (size_t k = 0; k < 4; ++k) {
+            const size_t src = std::min(i + k, count - 1);
+            tx[k] = xs[src];
+            tz[k] = zs[src];
+        }
+        _mm_store_ps(to, FractalSSE41<F, OCT>(p, _mm_load_ps(tx), _mm_load_ps(tz)));
+        std::memcpy(out + i, to, (count - i) * sizeof(float));
+    }
+}
+
+// --- SSE4.1 gradient kernel ---
+
+// One corner of NoiseScalar::Simplex2Deriv, zeroed where w <= 0. Adds the corner's
+// d/dx0, d/dy0 to d0 / e0 and returns its value.
+NOISE_TARGET_SSE41 inline __m128 CornerDerivSSE41(__m128i seed, __m128i xp, __m128i yp, __m128 px, __m128 py,
+                                                  __m128 w, __m128& d0, __m128& e0) {
+    __m128 gx, gy;
+    GradVecSSE41(seed, xp, yp, gx, gy);
+    const __m128 dot  = _mm_add_ps(_mm_mul_ps(px, gx), _mm_mul_ps(py, gy));
+    const __m128 w2   = _mm_mul_ps(w, w);
+    const __m128 w4   = _mm_mul_ps(w2, w2);
+    const __m128 k    = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(-8.0f), w2), w), dot);
+    const __m128 live = _mm_cmpgt_ps(w, _mm_setzero_ps());
+    d0 = _mm_add_ps(d0, _mm_and_ps(_mm_add_ps(_mm_mul_ps(w4, gx), _mm_mul_ps(k, px)), live));
+    e0 = _mm_add_ps(e0, _mm_and_ps(_mm_add_ps(_mm_mul_ps(w4, gy), _mm_mul_ps(k, py)), live));
+    return _mm_and_ps(_mm_mul_ps(w4, dot), live);
+}
+
+NOISE_TARGET_SSE41 inline __m128 SimplexDerivSSE41(__m128i seed, __m128 x, __m128 y, __m128& outDx, __m128& outDy) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    __m128i i = _mm_add_epi32(_mm_cvttps_epi32(x), _mm_castps_si128(_mm_cmplt_ps(x, zero)));
+    __m128i j = _mm_add_epi32(_mm_cvttps_epi32(y), _mm_castps_si128(_mm_cmplt_ps(y, zero)));
+    const __m128 xi = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+    const __m128 yi = _mm_sub_ps(y, _mm_cvtepi32_ps(j));
+
+    const __m128 t  = _mm_mul_ps(_mm_add_ps(xi, yi), _mm_set1_ps(G2));
+    const __m128 x0 = _mm_sub_ps(xi, t);
+    const __m128 y0 = _mm_sub_ps(yi, t);
+
+    i = _mm_mullo_epi32(i, _mm_set1_epi32(PRIME_X));
+    j = _mm_mullo_epi32(j, _mm_set1_epi32(PRIME_Y));
+    const __m128i iNext = _mm_add_epi32(i, _mm_set1_epi32(PRIME_X));
+    const __m128i jNext = _mm_add_epi32(j, _mm_set1_epi32(PRIME_Y));
+
+    __m128 d0 = zero, e0 = zero;
+    const __m128 a  = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0));
+    const __m128 n0 = CornerDerivSSE41(seed, i, j, x0, y0, a, d0, e0);
+
+    const __m128 c  = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(C_T), t), _mm_add_ps(_mm_set1_ps(C_A), a));
+    const __m128 x2 = _mm_add_ps(x0, _mm_set1_ps(OFF_2));
+    const __m128 y2 = _mm_add_ps(y0, _mm_set1_ps(OFF_2));
+    const __m128 n2 = CornerDerivSSE41(seed, iNext, jNext, x2, y2, c, d0, e0);
+
+    const __m128  upper  = _mm_cmpgt_ps(y0, x0);
+    const __m128  offG2  = _mm_set1_ps(OFF_G2);
+    const __m128  offG2m = _mm_set1_ps(OFF_G2_M1);
+    const __m128  x1 = _mm_add_ps(x0, _mm_blendv_ps(offG2m, offG2, upper));
+    const __m128  y1 = _mm_add_ps(y0, _mm_blendv_ps(offG2, offG2m, upper));
+    const __m128i xp1 = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(iNext), _mm_castsi128_ps(i), upper));
+    const __m128i yp1 = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(j), _mm_castsi128_ps(jNext), upper));
+    const __m128  b  = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1));
+    const __m128  n1 = CornerDerivSSE41(seed, xp1, yp1, x1, y1, b, d0, e0);
+
+    const __m128 scale = _mm_set1_ps(SIMPLEX_OUT);
+    outDx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1 - G2), d0), _mm_mul_ps(_mm_set1_ps(G2), e0)), scale);
+    outDy = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1 - G2), e0), _mm_mul_ps(_mm_set1_ps(G2), d0)), scale);
+    return _mm_mul_ps(_mm_add_ps(_mm_add_ps(n0, n1), n2), scale);
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+NOISE_TARGET_SSE41 inline __m128 FractalDerivSSE41(const Prepared& p, __m128 x, __m128 y, __m128& outDx, __m128& outDy) {
+    const __m128 freq = _mm_set1_ps(p.frequency);
+    x = _mm_mul_ps(x, freq);
+    y = _mm_mul_ps(y, freq);
+    const __m128 t = _mm_mul_ps(_mm_add_ps(x, y), _mm_set1_ps(F2));
+    x = _mm_add_ps(x, t);
+    y = _mm_add_ps(y, t);
+
+    __m128 gx, gy, sum;
+    if constexpr (F == NoiseLayer::Fractal::None) {
+        sum = SimplexDerivSSE41(_mm_set1_epi32(p.seed), x, y, gx, gy);
+    } else {
+        const __m128 lac     = _mm_set1_ps(p.lacunarity);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 signBit = _mm_castsi128_ps(_mm_set1_epi32(INT32_MIN));
+        gx = gy = sum = _mm_setzero_ps();
+        const int32_t octaves = OCT > 0 ? OCT : p.octaves;
+        for (int32_t o = 0; o < octaves; ++o) {
+            __m128 dx, dy;
+            __m128 noise = SimplexDerivSSE41(_mm_set1_epi32(WrapAdd(p.seed, o)), x, y, dx, dy);
+            __m128 w = _mm_set1_ps(p.slopes[o]);
+            if constexpr (F == NoiseLayer::Fractal::FBm) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(noise, _mm_set1_ps(p.amps[o])));
+            } else {
+                w     = _mm_xor_ps(w, _mm_and_ps(_mm_cmplt_ps(noise, _mm_setzero_ps()), signBit));
+                noise = _mm_and_ps(noise, absMask);
+                const __m128 ridge = _mm_add_ps(_mm_mul_ps(noise, _mm_set1_ps(-2.0f)), _mm_set1_ps(1.0f));
+                sum = _mm_add_ps(sum, _mm_mul_ps(ridge, _mm_set1_ps(p.amps[o])));
+                w   = _mm_mul_ps(w, _mm_set1_ps(-2.0f));
+            }
+            gx = _mm_add_ps(gx, _mm_mul_ps(dx, w));
+            gy = _mm_add_ps(gy, _mm_mul_ps(dy, w));
+            x = _mm_mul_ps(x, lac);
+            y = _mm_mul_ps(y, lac);
+        }
+    }
+
+    const __m128 sk = _mm_mul_ps(_mm_add_ps(gx, gy), _mm_set1_ps(F2));
+    outDx = _mm_mul_ps(_mm_add_ps(gx, sk), freq);
+    outDy = _mm_mul_ps(_mm_add_ps(gy, sk), freq);
+    return sum;
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+NOISE_TARGET_SSE41 void EvaluateDerivSSE41(const Prepared& p, const float* xs, const float* zs,
+                                           float* out, float* outDx, float* outDz, size_t count) {
+    __m128 dx, dz;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, FractalDerivSSE41<F, OCT>(p, _mm_loadu_ps(xs + i), _mm_loadu_ps(zs + i), dx, dz));
+        _mm_storeu_ps(outDx + i, dx);
+        _mm_storeu_ps(outDz + i, dz);
+    }
+
+    if (i < count) { // tail: pad with the last sample
+        alignas(16) float tx[4], tz[4], to[4], tdx[4], tdz[4];
+        for (size_t k = 0; k < 4; ++k) {
+            const size_t src = std::min(i + k, count - 1);
+            tx[k] = xs[src];
+            tz[k] = zs[src];
+        }
+        _mm_store_ps(to, FractalDerivSSE41<F, OCT>(p, _mm_load_ps(tx), _mm_load_ps(tz), dx, dz));
+        _mm_store_ps(tdx, dx);
+        _mm_store_ps(tdz, dz);
+        std::memcpy(out + i,   to,  (count - i) * sizeof(float));
+        std::memcpy(outDx + i, tdx, (count - i) * sizeof(float));
+        std::memcpy(outDz + i, tdz, (count - i) * sizeof(float));
+    }
+}
+
+// --- AVX2 kernel (8 lanes) ---
+
+NOISE_TARGET_AVX2 inline void GradVecAVX2(__m256i seed, __m256i xp, __m256i yp, __m256& xg, __m256& yg) {
+    __m256i hash = _mm256_mullo_epi32(_mm256_xor_si256(_mm256_xor_si256(seed, xp), yp), _mm256_set1_epi32(HASH_MUL));
+    hash = _mm256_xor_si256(hash, _mm256_srai_epi32(hash, 15));
+    hash = _mm256_and_si256(hash, _mm256_set1_epi32(127 << 1));
+
+    xg = _mm256_i32gather_ps(Gradients2D, hash, 4);
+    yg = _mm256_i32gather_ps(Gradients2D, _mm256_or_si256(hash, _mm256_set1_epi32(1)), 4);
+}
+
+NOISE_TARGET_AVX2 inline __m256 GradAVX2(__m256i seed, __m256i xp, __m256i yp, __m256 xd, __m256 yd) {
+    __m256 xg, yg;
+    GradVecAVX2(seed, xp, yp, xg, yg);
+    return _mm256_add_ps(_mm256_mul_ps(xd, xg), _mm256_mul_ps(yd, yg));
+}
+
+NOISE_TARGET_AVX2 inline __m256 SimplexAVX2(__m256i seed, __m256 x, __m256 y) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    __m256i i = _mm256_add_epi32(_mm256_cvttps_epi32(x), _mm256_castps_si256(_mm256_cmp_ps(x, zero, _CMP_LT_OQ)));
+    __m256i j = _mm256_add_epi32(_mm256_cvttps_epi32(y), _mm256_castps_si256(_mm256_cmp_ps(y, zero, _CMP_LT_OQ)));
+    const __m256 xi = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+    const __m256 yi = _mm256_sub_ps(y, _mm256_cvtepi32_ps(j));
+
+    const __m256 t  = _mm256_mul_ps(_mm256_add_ps(xi, yi), _mm256_set1_ps(G2));
+    const __m256 x0 = _mm256_sub_ps(xi, t);
+    const __m256 y0 = _mm256_sub_ps(yi, t);
+
+    i = _mm256_mullo_epi32(i, _mm256_set1_epi32(PRIME_X));
+    j = _mm256_mullo_epi32(j, _mm256_set1_epi32(PRIME_Y));
+    const __m256i iNext = _mm256_add_epi32(i, _mm256_set1_epi32(PRIME_X));
+    const __m256i jNext = _mm256_add_epi32(j, _mm256_set1_epi32(PRIME_Y));
+
+    const __m256 a  = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x0, x0)), _mm256_mul_ps(y0, y0));
+    const __m256 aa = _mm256_mul_ps(a, a);
+    __m256 n0 = _mm256_mul_ps(_mm256_mul_ps(aa, aa), GradAVX2(seed, i, j, x0, y0));
+    n0 = _mm256_and_ps(n0, _mm256_cmp_ps(a, zero, _CMP_GT_OQ));
+
+    const __m256 c  = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(C_T), t), _mm256_add_ps(_mm256_set1_ps(C_A), a));
+    const __m256 x2 = _mm256_add_ps(x0, _mm256_set1_ps(OFF_2));
+    const __m256 y2 = _mm256_add_ps(y0, _mm256_set1_ps(OFF_2));
+    const __m256 cc = _mm256_mul_ps(c, c);
+    __m256 n2 = _mm256_mul_ps(_mm256_mul_ps(cc, cc), GradAVX2(seed, iNext, jNext, x2, y2));
+    n2 = _mm256_and_ps(n2, _mm256_cmp_ps(c, zero, _CMP_GT_OQ));
+
+    const __m256  upper  = _mm256_cmp_ps(y0, x0, _CMP_GT_OQ);
+    const __m256  offG2  = _mm256_set1_ps(OFF_G2);
+    const __m256  offG2m = _mm256_set1_ps(OFF_G2_M1);
+    const __m256  x1 = _mm256_add_ps(x0, _mm256_blendv_ps(offG2m, offG2, upper));
+    const __m256  y1 = _mm256_add_ps(y0, _mm256_blendv_ps(offG2, offG2m, upper));
+    const __m256i xp1 = _mm256_blendv_epi8(iNext, i, _mm256_castps_si256(upper));
+    const __m256i yp1 = _mm256_blendv_epi8(j, jNext, _mm256_castps_si256(upper));
+    const __m256  b  = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x1, x1)), _mm256_mul_ps(y1, y1));
+    const __m256  bb = _mm256_mul_ps(b, b);
+    __m256 n1 = _mm256_mul_ps(_mm256_mul_ps(bb, bb), GradAVX2(seed, xp1, yp1, x1, y1));
+    n1 = _mm256_and_ps(n1, _mm256_cmp_ps(b, zero, _CMP_GT_OQ));
+
+    return _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(n0, n1), n2), _mm256_set1_ps(SIMPLEX_OUT));
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+NOISE_TARGET_AVX2 inline __m256 FractalAVX2(const Prepared& p, __m256 x, __m256 y) {
+    x = _mm256_mul_ps(x, _mm256_set1_ps(p.frequency));
+    y = _mm256_mul_ps(y, _mm256_set1_ps(p.frequency));
+    const __m256 t = _mm256_mul_ps(_mm256_add_ps(x, y), _mm256_set1_ps(F2));
+    x = _mm256_add_ps(x, t);
+    y = _mm256_add_ps(y, t);
+
+    if constexpr (F == NoiseLayer::Fractal::None)
+        return SimplexAVX2(_mm256_set1_epi32(p.seed), x, y);
+
+    const __m256 lac     = _mm256_set1_ps(p.lacunarity);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 sum = _mm256_setzero_ps();
+    const int32_t octaves = OCT > 0 ? OCT : p.octaves;
+    for (int32_t o = 0; o < octaves; ++o) {
+        __m256 noise = SimplexAVX2(_mm256_set1_epi32(WrapAdd(p.seed, o)), x, y);
+        if constexpr (F == NoiseLayer::Fractal::FBm) {
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(noise, _mm256_set1_ps(p.amps[o])));
+        } else {
+            noise = _mm256_and_ps(noise, absMask);
+            const __m256 ridge = _mm256_add_ps(_mm256_mul_ps(noise, _mm256_set1_ps(-2.0f)), _mm256_set1_ps(1.0f));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(ridge, _mm256_set1_ps(p.amps[o])));
+        }
+        x = _mm256_mul_ps(x, lac);
+        y = _mm256_mul_ps(y, lac);
+    }
+    return sum;
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+NOISE_TARGET_AVX2 void EvaluateAVX2(const Prepared& p, const float* xs, const float* zs, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(out + i, FractalAVX2<F, OCT>(p, _mm256_loadu_ps(xs + i), _mm256_loadu_ps(zs + i)));
+
+    if (i < count) { // tail: pad with the last sample
+        alignas(32) float tx[8], tz[8], to[8];
+        for (size_t k = 0; k < 8; ++k) {
+            const size_t src = std::min(i + k, count - 1);
+            tx[k] = xs[src];
+            tz[k] = zs[src];
+        }
+        _mm256_store_ps(to, FractalAVX2<F, OCT>(p, _mm256_load_ps(tx), _mm256_load_ps(tz)));
+        std::memcpy(out + i, to, (count - i) * sizeof(float));
+    }
+}
+
+// --- AVX2 gradient kernel ---
+
+NOISE_TARGET_AVX2 inline __m256 CornerDerivAVX2(__m256i seed, __m256i xp, __m256i yp, __m256 px, __m256 py,
+                                                __m256 w, __m256& d0, __m256& e0) {
+    __m256 gx, gy;
+    GradVecAVX2(seed, xp, yp, gx, gy);
+    const __m256 dot  = _mm256_add_ps(_mm256_mul_ps(px, gx), _mm256_mul_ps(py, gy));
+    const __m256 w2   = _mm256_mul_ps(w, w);
+    const __m256 w4   = _mm256_mul_ps(w2, w2);
+    const __m256 k    = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(-8.0f), w2), w), dot);
+    const __m256 live = _mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_GT_OQ);
+    d0 = _mm256_add_ps(d0, _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(w4, gx), _mm256_mul_ps(k, px)), live));
+    e0 = _mm256_add_ps(e0, _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(w4, gy), _mm256_mul_ps(k, py)), live));
+    return _mm256_and_ps(_mm256_mul_ps(w4, dot), live);
+}
+
+NOISE_TARGET_AVX2 inline __m256 SimplexDerivAVX2(__m256i seed, __m256 x, __m256 y, __m256& outDx, __m256& outDy) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    __m256i i = _mm256_add_epi32(_mm256_cvttps_epi32(x), _mm256_castps_si256(_mm256_cmp_ps(x, zero, _CMP_LT_OQ)));
+    __m256i j = _mm256_add_epi32(_mm256_cvttps_epi32(y), _mm256_castps_si256(_mm256_cmp_ps(y, zero, _CMP_LT_OQ)));
+    const __m256 xi = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+    const __m256 yi = _mm256_sub_ps(y, _mm256_cvtepi32_ps(j));
+
+    const __m256 t  = _mm256_mul_ps(_mm256_add_ps(xi, yi), _mm256_set1_ps(G2));
+    const __m256 x0 = _mm256_sub_ps(xi, t);
+    const __m256 y0 = _mm256_sub_ps(yi, t);
+
+    i = _mm256_mullo_epi32(i, _mm256_set1_epi32(PRIME_X));
+    j = _mm256_mullo_epi32(j, _mm256_set1_epi32(PRIME_Y));
+    const __m256i iNext = _mm256_add_epi32(i, _mm256_set1_epi32(PRIME_X));
+    const __m256i jNext = _mm256_add_epi32(j, _mm256_set1_epi32(PRIME_Y));
+
+    __m256 d0 = zero, e0 = zero;
+    const __m256 a  = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x0, x0)), _mm256_mul_ps(y0, y0));
+    const __m256 n0 = CornerDerivAVX2(seed, i, j, x0, y0, a, d0, e0);
+
+    const __m256 c  = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(C_T), t), _mm256_add_ps(_mm256_set1_ps(C_A), a));
+    const __m256 x2 = _mm256_add_ps(x0, _mm256_set1_ps(OFF_2));
+    const __m256 y2 = _mm256_add_ps(y0, _mm256_set1_ps(OFF_2));
+    const __m256 n2 = CornerDerivAVX2(seed, iNext, jNext, x2, y2, c, d0, e0);
+
+    const __m256  upper  = _mm256_cmp_ps(y0, x0, _CMP_GT_OQ);
+    const __m256  offG2  = _mm256_set1_ps(OFF_G2);
+    const __m256  offG2m = _mm256_set1_ps(OFF_G2_M1);
+    const __m256  x1 = _mm256_add_ps(x0, _mm256_blendv_ps(offG2m, offG2, upper));
+    const __m256  y1 = _mm256_add_ps(y0, _mm256_blendv_ps(offG2, offG2m, upper));
+    const __m256i xp1 = _mm256_blendv_epi8(iNext, i, _mm256_castps_si256(upper));
+    const __m256i yp1 = _mm256_blendv_epi8(j, jNext, _mm256_castps_si256(upper));
+    const __m256  b  = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x1, x1)), _mm256_mul_ps(y1, y1));
+    const __m256  n1 = CornerDerivAVX2(seed, xp1, yp1, x1, y1, b, d0, e0);
+
+    const __m256 scale = _mm256_set1_ps(SIMPLEX_OUT);
+    outDx = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(1 - G2), d0), _mm256_mul_ps(_mm256_set1_ps(G2), e0)), scale);
+    outDy = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(1 - G2), e0), _mm256_mul_ps(_mm256_set1_ps(G2), d0)), scale);
+    return _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(n0, n1), n2), scale);
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+NOISE_TARGET_AVX2 inline __m256 FractalDerivAVX2(const Prepared& p, __m256 x, __m256 y, __m256& outDx, __m256& outDy) {
+    const __m256 freq = _mm256_set1_ps(p.frequency);
+    x = _mm256_mul_ps(x, freq);
+    y = _mm256_mul_ps(y, freq);
+    const __m256 t = _mm256_mul_ps(_mm256_add_ps(x, y), _mm256_set1_ps(F2));
+    x = _mm256_add_ps(x, t);
+    y = _mm256_add_ps(y, t);
+
+    __m256 gx, gy, sum;
+    if constexpr (F == NoiseLayer::Fractal::None) {
+        sum = SimplexDerivAVX2(_mm256_set1_epi32(p.seed), x, y, gx, gy);
+    } else {
+        const __m256 lac     = _mm256_set1_ps(p.lacunarity);
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const __m256 signBit = _mm256_castsi256_ps(_mm256_set1_epi32(INT32_MIN));
+        gx = gy = sum = _mm256_setzero_ps();
+        const int32_t octaves = OCT > 0 ? OCT : p.octaves;
+        for (int32_t o = 0; o < octaves; ++o) {
+            __m256 dx, dy;
+            __m256 noise = SimplexDerivAVX2(_mm256_set1_epi32(WrapAdd(p.seed, o)), x, y, dx, dy);
+            __m256 w = _mm256_set1_ps(p.slopes[o]);
+            if constexpr (F == NoiseLayer::Fractal::FBm) {
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(noise, _mm256_set1_ps(p.amps[o])));
+            } else {
+                w     = _mm256_xor_ps(w, _mm256_and_ps(_mm256_cmp_ps(noise, _mm256_setzero_ps(), _CMP_LT_OQ), signBit));
+                noise = _mm256_and_ps(noise, absMask);
+                const __m256 ridge = _mm256_add_ps(_mm256_mul_ps(noise, _mm256_set1_ps(-2.0f)), _mm256_set1_ps(1.0f));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(ridge, _mm256_set1_ps(p.amps[o])));
+                w   = _mm256_mul_ps(w, _mm256_set1_ps(-2.0f));
+            }
+            gx = _mm256_add_ps(gx, _mm256_mul_ps(dx, w));
+            gy = _mm256_add_ps(gy, _mm256_mul_ps(dy, w));
+            x = _mm256_mul_ps(x, lac);
+            y = _mm256_mul_ps(y, lac);
+        }
+    }
+
+    const __m256 sk = _mm256_mul_ps(_mm256_add_ps(gx, gy), _mm256_set1_ps(F2));
+    outDx = _mm256_mul_ps(_mm256_add_ps(gx, sk), freq);
+    outDy = _mm256_mul_ps(_mm256_add_ps(gy, sk), freq);
+    return sum;
+}
+
+template <NoiseLayer::Fractal F, int32_t OCT>
+NOISE_TARGET_AVX2 void EvaluateDerivAVX2(const Prepared& p, const float* xs, const float* zs,
+                                         float* out, float* outDx, float* outDz, size_t count) {
+    __m256 dx, dz;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, FractalDerivAVX2<F, OCT>(p, _mm256_loadu_ps(xs + i), _mm256_loadu_ps(zs + i), dx, dz));
+        _mm256_storeu_ps(outDx + i, dx);
+        _mm256_storeu_ps(outDz + i, dz);
+    }
+
+    if (i < count) { // tail: pad with the last sample
+        alignas(32) float tx[8], tz[8], to[8], tdx[8], tdz[8];
+        for (size_t k = 0; k < 8; ++k) {
+            const size_t src = std::min(i + k, count - 1);
+            tx[k] = xs[src];
+            tz[k] = zs[src];
+        }
+        _mm256_store_ps(to, FractalDerivAVX2<F, OCT>(p, _mm256_load_ps(tx), _mm256_load_ps(tz), dx, dz));
+        _mm256_store_ps(tdx, dx);
+        _mm256_store_ps(tdz, dz);
+        std::memcpy(out + i,   to,  (count - i) * sizeof(float));
+        std::memcpy(outDx + i, tdx, (count - i) * sizeof(float));
+        std::memcpy(outDz + i, tdz, (count - i) * sizeof(float));
+    }
+}
+
+#endif // NOISE_BATCH_X86
+
+std::atomic<uint8_t> s_ActiveISA{0xFF}; // 0xFF = not detected yet
+
+} // namespace
+
+// --- Dispatch ---
+
+NoiseBatch::ISA NoiseBatch::DetectISA() noexcept {
+#if NOISE_BATCH_X86 && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))   return ISA::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return ISA::SSE41;
+#endif
+    return ISA::Scalar;
+}
+
+NoiseBatch::ISA NoiseBatch::GetISA() noexcept {
+    uint8_t isa = s_ActiveISA.load(std::memory_order_relaxed);
+    if (isa == 0xFF) {
+        isa = static_cast<uint8_t>(DetectISA());
+        s_ActiveISA.store(isa, std::memory_order_relaxed);
+    }
+    return static_cast<ISA>(isa);
+}
+
+void NoiseBatch::SetISA(ISA isa) noexcept {
+    const ISA best = DetectISA();
+    if (static_cast<uint8_t>(isa) > static_cast<uint8_t>(best)) isa = best;
+    s_ActiveISA.store(static_cast<uint8_t>(isa), std::memory_order_relaxed);
+}
+
+const char* NoiseBatch::ISAName(ISA isa) noexcept {
+    switch (isa) {
+        case ISA::AVX2:   return "avx2";
+        case ISA::SSE41:  return "sse4.1";
+        case ISA::Scalar: return "scalar";
+    }
+    return "unknown";
+}
+
+namespace {
+    template <NoiseLayer::Fractal F, int32_t OCT>
+    void Dispatch(const Prepared& p, const float* xs, const float* zs, float* out, size_t count) {
+        if (count == 0) return;
+        switch (NoiseBatch::GetISA()) {
+#if NOISE_BATCH_X86
+            case NoiseBatch::ISA::AVX2:  EvaluateAVX2<F, OCT>(p, xs, zs, out, count);  return;
+            case NoiseBatch::ISA::SSE41: EvaluateSSE41<F, OCT>(p, xs, zs, out, count); return;
+#endif
+            default:                     EvaluateScalar<F, OCT>(p, xs, zs, out, count); return;
+        }
+    }
+
+    template <NoiseLayer::Fractal F, int32_t OCT>
+    void DispatchDeriv(const Prepared& p, const float* xs, const float* zs,
+                       float* out, float* outDx, float* outDz, size_t count) {
+        if (count == 0) return;
+        switch (NoiseBatch::GetISA()) {
+#if NOISE_BATCH_X86
+            case NoiseBatch::ISA::AVX2:  EvaluateDerivAVX2<F, OCT>(p, xs, zs, out, outDx, outDz, count);  return;
+            case NoiseBatch::ISA::SSE41: EvaluateDerivSSE41<F, OCT>(p, xs, zs, out, outDx, outDz, count); return;
+#endif
+            default:                     EvaluateDerivScalar<F, OCT>(p, xs, zs, out, outDx, outDz, count); return;
+        }
+    }
+
+    template <NoiseLayer::Fractal F, int32_t OCT>
+    void Dispatch(const NoiseLayer& layer, int32_t octaves, const float* xs, const float* zs,
+                  float* out, size_t count) {
+        if (count == 0) return;
+        Dispatch<F, OCT>(Prepare(layer, F, octaves), xs, zs, out, count);
+    }
+}
+
+void NoiseBatch::Evaluate(const NoiseLayer& layer, const float* xs, const float* zs,
+                          float* out, size_t count) {
+    switch (layer.FractalType) {
+        case NoiseLayer::Fractal::None:   Dispatch<NoiseLayer::Fractal::None,   1>(layer, 1, xs, zs, out, count); return;
+        case NoiseLayer::Fractal::FBm:    Dispatch<NoiseLayer::Fractal::FBm,    0>(layer, layer.Octaves, xs, zs, out, count); return;
+        case NoiseLayer::Fractal::Ridged: Dispatch<NoiseLayer::Fractal::Ridged, 0>(layer, layer.Octaves, xs, zs, out, count); return;
+    }
+}
+
+void NoiseBatch::EvaluateOctaves(const NoiseLayer& layer, int32_t octaves, const float* xs, const float* zs,
+                                 float* out, size_t count) {
+    switch (layer.FractalType) {
+        case NoiseLayer::Fractal::None:
+            Dispatch<NoiseLayer::Fractal::None, 1>(layer, 1, xs, zs, out, count);
+            return;
+        case NoiseLayer::Fractal::FBm:
+            Dispatch<NoiseLayer::Fractal::FBm, 0>(Prepare(layer, layer.FractalType, layer.Octaves, octaves),
+                                                  xs, zs, out, count);
+            return;
+        case NoiseLayer::Fractal::Ridged:
+            Dispatch<NoiseLayer::Fractal::Ridged, 0>(Prepare(layer, layer.FractalType, layer.Octaves, octaves),
+                                                     xs, zs, out, count);
+            return;
+    }
+}
+
+template <NoiseLayer::Fractal F, int32_t Octaves>
+void NoiseBatch::Evaluate(const NoiseLayer& layer, const float* xs, const float* zs,
+                          float* out, size_t count) {
+    static_assert(Octaves >= 1 && Octaves <= MAX_STATIC_OCTAVES);
+    Dispatch<F, Octaves>(layer, Octaves, xs, zs, out, count);
+}
+
+template <NoiseLayer::Fractal F, int32_t Octaves>
+void NoiseBatch::EvaluateDeriv(const NoiseLayer& layer, const float* xs, const float* zs,
+                               float* out, float* outDx, float* outDz, size_t count) {
+    static_assert(Octaves >= 1 && Octaves <= MAX_STATIC_OCTAVES);
+    if (count == 0) return;
+    DispatchDeriv<F, Octaves>(Prepare(layer, F, Octaves), xs, zs, out, outDx, outDz, count);
+}
+
+// --- Explicit instantiations ---
+
+template void NoiseBatch::Evaluate<NoiseLayer::Fractal::None, 1>(const NoiseLayer&, const float*, const float*, float*, size_t);
+template void NoiseBatch::EvaluateDeriv<NoiseLayer::Fractal::None, 1>(const NoiseLayer&, const float*, const float*,
+                                                                      float*, float*, float*, size_t);
+
+#define NOISE_BATCH_INSTANTIATE(OCT)                                                                                      \
+    template void NoiseBatch::Evaluate<NoiseLayer::Fractal::FBm,    OCT>(const NoiseLayer&, const float*, const float*, float*, size_t); \
+    template void NoiseBatch::Evaluate<NoiseLayer::Fractal::Ridged, OCT>(const NoiseLayer&, const float*, const float*, float*, size_t); \
+    template void NoiseBatch::EvaluateDeriv<NoiseLayer::Fractal::FBm,    OCT>(const NoiseLayer&, const float*, const float*,            \
+                                                                           float*, float*, float*, size_t);                         \
+    template void NoiseBatch::EvaluateDeriv<NoiseLayer::Fractal::Ridged, OCT>(const NoiseLayer&, const float*, const float*,            \
+                                                                           float*, float*, float*, size_t);
+
+NOISE_BATCH_INSTANTIATE(1)
+NOISE_BATCH_INSTANTIATE(2)
+NOISE_BATCH_INSTANTIATE(3)
+NOISE_BATCH_INSTANTIATE(4)
+NOISE_BATCH_INSTANTIATE(5)
+NOISE_BATCH_INSTANTIATE(6)
+NOISE_BATCH_INSTANTIATE(7)
+NOISE_BATCH_INSTANTIATE(8)
+
+#undef NOISE_BATCH_INSTANTIATE
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "util/math/FastNoiseLite.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Description of one 2D OpenSimplex2 noise module (optionally fractal).
+// Mirrors the subset of FastNoiseLite settings the terrain uses, so the same
+// module can be evaluated per sample through FastNoiseLite or in batches
+// through NoiseBatch. Weighted strength is always 0 and is not exposed.
+struct NoiseLayer {
+    enum class Fractal : uint8_t { None, FBm, Ridged };
+
+    int32_t Seed       = 1337;
+    float   Frequency  = 0.01f;
+    Fractal FractalType = Fractal::None;
+    int32_t Octaves    = 3;
+    float   Lacunarity = 2.0f;
+    float   Gain       = 0.5f;
+
+    // Same value FastNoiseLite::CalculateFractalBounding produces.
+    float Bounding() const noexcept;
+
+    // Configures a FastNoiseLite instance to produce exactly this layer.
+    void Apply(FastNoiseLite& noise) const;
+};
+
+// Batched evaluation of NoiseLayer over arrays of sample coordinates.
+//
+// Results are bit-identical to FastNoiseLite::GetNoise(float, float) with the
+// same settings: every kernel performs the same float operations in the same
+// order (no FMA contraction, no reciprocal approximations), only several
+// samples at a time. The kernel is picked once at runtime from the CPU features.
+namespace NoiseBatch {
+    enum class ISA : uint8_t { Scalar, SSE41, AVX2 };
+
+    // Best instruction set supported by the running CPU.
+    ISA DetectISA() noexcept;
+
+    // Kernel used by Evaluate. Defaults to DetectISA(); SetISA clamps requests
+    // to what the CPU supports (benchmarks use it to compare kernels).
+    ISA  GetISA() noexcept;
+    void SetISA(ISA isa) noexcept;
+
+    const char* ISAName(ISA isa) noexcept;
+
+    // out[i] = layer noise at (xs[i], zs[i]) for i < count.
+    // out may alias neither xs nor zs.
+    void Evaluate(const NoiseLayer& layer, const float* xs, const float* zs,
+                  float* out, size_t count);
+
+    // Same, with the fractal type and octave count fixed at compile time: the
+    // octave loop is unrolled and layer.FractalType / layer.Octaves are ignored.
+    // Instantiated for Fractal::None with 1 octave and for FBm / Ridged with
+    // 1..MAX_STATIC_OCTAVES octaves.
+    inline constexpr int32_t MAX_STATIC_OCTAVES = 8;
+
+    template <NoiseLayer::Fractal F, int32_t Octaves>
+    void Evaluate(const NoiseLayer& layer, const float* xs, const float* zs,
+                  float* out, size_t count);
+
+    // Evaluate<F, Octaves> plus the analytic gradient d/dx, d/dz of every sample in
+    // input units: the batched StaticNoise::GetNoiseDeriv, same bits for all three
+    // outputs. Ridged octaves take the one-sided slope on their crests. No output may
+    // alias xs or zs. Same instantiations as Evaluate<F, Octaves>.
+    template <NoiseLayer::Fractal F, int32_t Octaves>
+    void EvaluateDeriv(const NoiseLayer& layer, const float* xs, const float* zs,
+                       float* out, float* outDx, float* outDz, size_t count);
+
+    // Only the first 'octaves' octaves of a fractal layer (1 <= octaves <= layer.Octaves),
+    // each at the amplitude it has in the full layer: the full sum with the finer
+    // octaves left out, not a renormalised shorter fractal.
+    void EvaluateOctaves(const NoiseLayer& layer, int32_t octaves, const float* xs, const float* zs,
+                         float* out, size_t count);
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <cstdint>
+
+// Scalar 2D noise primitives replicating FastNoiseLite operation for operation,
+// shared by StaticNoise and the NoiseBatch kernels. Constants are spelled exactly
+// as in FastNoiseLite so they fold to the same floats; integer math wraps the way
+// FastNoiseLite's does on two's-complement targets. Results are bit-identical to
+// FastNoiseLite as long as the compiler does not contract mul/add into FMA.
+namespace NoiseScalar {
+
+    // --- Constants ---
+
+    inline constexpr int32_t PRIME_X  = 501125321;
+    inline constexpr int32_t PRIME_Y  = 1136930381;
+    inline constexpr int32_t HASH_MUL = 0x27d4eb2d;
+
+    // TransformNoiseCoordinate skew (FNfloat = float)
+    inline constexpr float SKEW_SQRT3 = (float)1.7320508075688772935274463415059;
+    inline constexpr float F2         = 0.5f * (SKEW_SQRT3 - 1);
+
+    // SingleSimplex
+    inline constexpr float SQRT3       = 1.7320508075688772935274463415059f;
+    inline constexpr float G2          = (3 - SQRT3) / 6;
+    inline constexpr float C_T         = (float)(2 * (1 - 2 * G2) * (1 / G2 - 2));
+    inline constexpr float C_A         = (float)(-2 * (1 - 2 * G2) * (1 - 2 * G2));
+    inline constexpr float OFF_2       = 2 * (float)G2 - 1;
+    inline constexpr float OFF_G2      = (float)G2;
+    inline constexpr float OFF_G2_M1   = (float)G2 - 1;
+    inline constexpr float SIMPLEX_OUT = 99.83685446303647f;
+
+    // SinglePerlin
+    inline constexpr float PERLIN_OUT = 1.4247691104677813f;
+
+    // SingleCellular (default jitter modifier 1.0)
+    inline constexpr float CELLULAR_JITTER = 0.43701595f * 1.0f;
+
+    // --- Lookup tables (FastNoiseLite::Lookup<float>) ---
+
+    alignas(32) inline constexpr float Gradients2D[256] = {
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+        -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+    };
+
+    alignas(32) inline constexpr float RandVecs2D[512] = {
+        -0.2700222198f, -0.9628540911f, 0.3863092627f, -0.9223693152f, 0.04444859006f, -0.999011673f, -0.5992523158f, -0.8005602176f, -0.7819280288f, 0.6233687174f, 0.9464672271f, 0.3227999196f, -0.6514146797f, -0.7587218957f, 0.9378472289f, 0.347048376f,
+        -0.8497875957f, -0.5271252623f, -0.879042592f, 0.4767432447f, -0.892300288f, -0.4514423508f, -0.379844434f, -0.9250503802f, -0.9951650832f, 0.0982163789f, 0.7724397808f, -0.6350880136f, 0.7573283322f, -0.6530343002f, -0.9928004525f, -0.119780055f,
+        -0.0532665713f, 0.9985803285f, 0.9754253726f, -0.2203300762f, -0.7665018163f, 0.6422421394f, 0.991636706f, 0.1290606184f, -0.994696838f, 0.1028503788f, -0.5379205513f, -0.84299554f, 0.5022815471f, -0.8647041387f, 0.4559821461f, -0.8899889226f,
+        -0.8659131224f, -0.5001944266f, 0.0879458407f, -0.9961252577f, -0.5051684983f, 0.8630207346f, 0.7753185226f, -0.6315704146f, -0.6921944612f, 0.7217110418f, -0.5191659449f, -0.8546734591f, 0.8978622882f, -0.4402764035f, -0.1706774107f, 0.9853269617f,
+        -0.9353430106f, -0.3537420705f, -0.9992404798f, 0.03896746794f, -0.2882064021f, -0.9575683108f, -0.9663811329f, 0.2571137995f, -0.8759714238f, -0.4823630009f, -0.8303123018f, -0.5572983775f, 0.05110133755f, -0.9986934731f, -0.8558373281f, -0.5172450752f,
+        0.09887025282f, 0.9951003332f, 0.9189016087f, 0.3944867976f, -0.2439375892f, -0.9697909324f, -0.8121409387f, -0.5834613061f, -0.9910431363f, 0.1335421355f, 0.8492423985f, -0.5280031709f, -0.9717838994f, -0.2358729591f, 0.9949457207f, 0.1004142068f,
+        0.6241065508f, -0.7813392434f, 0.662910307f, 0.7486988212f, -0.7197418176f, 0.6942418282f, -0.8143370775f, -0.5803922158f, 0.104521054f, -0.9945226741f, -0.1065926113f, -0.9943027784f, 0.445799684f, -0.8951327509f, 0.105547406f, 0.9944142724f,
+        -0.992790267f, 0.1198644477f, -0.8334366408f, 0.552615025f, 0.9115561563f, -0.4111755999f, 0.8285544909f, -0.5599084351f, 0.7217097654f, -0.6921957921f, 0.4940492677f, -0.8694339084f, -0.3652321272f, -0.9309164803f, -0.9696606758f, 0.2444548501f,
+        0.08925509731f, -0.996008799f, 0.5354071276f, -0.8445941083f, -0.1053576186f, 0.9944343981f, -0.9890284586f, 0.1477251101f, 0.004856104961f, 0.9999882091f, 0.9885598478f, 0.1508291331f, 0.9286129562f, -0.3710498316f, -0.5832393863f, -0.8123003252f,
+        0.3015207509f, 0.9534596146f, -0.9575110528f, 0.2883965738f, 0.9715802154f, -0.2367105511f, 0.229981792f, 0.9731949318f, 0.955763816f, -0.2941352207f, 0.740956116f, 0.6715534485f, -0.9971513787f, -0.07542630764f, 0.6905710663f, -0.7232645452f,
+        -0.290713703f, -0.9568100872f, 0.5912777791f, -0.8064679708f, -0.9454592212f, -0.325740481f, 0.6664455681f, 0.74555369f, 0.6236134912f, 0.7817328275f, 0.9126993851f, -0.4086316587f, -0.8191762011f, 0.5735419353f, -0.8812745759f, -0.4726046147f,
+        0.9953313627f, 0.09651672651f, 0.9855650846f, -0.1692969699f, -0.8495980887f, 0.5274306472f, 0.6174853946f, -0.7865823463f, 0.8508156371f, 0.52546432f, 0.9985032451f, -0.05469249926f, 0.1971371563f, -0.9803759185f, 0.6607855748f, -0.7505747292f,
+        -0.03097494063f, 0.9995201614f, -0.6731660801f, 0.739491331f, -0.7195018362f, -0.6944905383f, 0.9727511689f, 0.2318515979f, 0.9997059088f, -0.0242506907f, 0.4421787429f, -0.8969269532f, 0.9981350961f, -0.061043673f, -0.9173660799f, -0.3980445648f,
+        -0.8150056635f, -0.5794529907f, -0.8789331304f, 0.4769450202f, 0.0158605829f, 0.999874213f, -0.8095464474f, 0.5870558317f, -0.9165898907f, -0.3998286786f, -0.8023542565f, 0.5968480938f, -0.5176737917f, 0.8555780767f, -0.8154407307f, -0.5788405779f,
+        0.4022010347f, -0.9155513791f, -0.9052556868f, -0.4248672045f, 0.7317445619f, 0.6815789728f, -0.5647632201f, -0.8252529947f, -0.8403276335f, -0.5420788397f, -0.9314281527f, 0.363925262f, 0.5238198472f, 0.8518290719f, 0.7432803869f, -0.6689800195f,
+        -0.985371561f, -0.1704197369f, 0.4601468731f, 0.88784281f, 0.825855404f, 0.5638819483f, 0.6182366099f, 0.7859920446f, 0.8331502863f, -0.553046653f, 0.1500307506f, 0.9886813308f, -0.662330369f, -0.7492119075f, -0.668598664f, 0.743623444f,
+        0.7025606278f, 0.7116238924f, -0.5419389763f, -0.8404178401f, -0.3388616456f, 0.9408362159f, 0.8331530315f, 0.5530425174f, -0.2989720662f, -0.9542618632f, 0.2638522993f, 0.9645630949f, 0.124108739f, -0.9922686234f, -0.7282649308f, -0.6852956957f,
+        0.6962500149f, 0.7177993569f, -0.9183535368f, 0.3957610156f, -0.6326102274f, -0.7744703352f, -0.9331891859f, -0.359385508f, -0.1153779357f, -0.9933216659f, 0.9514974788f, -0.3076565421f, -0.08987977445f, -0.9959526224f, 0.6678496916f, 0.7442961705f,
+        0.7952400393f, -0.6062947138f, -0.6462007402f, -0.7631674805f, -0.2733598753f, 0.9619118351f, 0.9669590226f, -0.254931851f, -0.9792894595f, 0.2024651934f, -0.5369502995f, -0.8436138784f, -0.270036471f, -0.9628500944f, -0.6400277131f, 0.7683518247f,
+        -0.7854537493f, -0.6189203566f, 0.06005905383f, -0.9981948257f, -0.02455770378f, 0.9996984141f, -0.65983623f, 0.751409442f, -0.6253894466f, -0.7803127835f, -0.6210408851f, -0.7837781695f, 0.8348888491f, 0.5504185768f, -0.1592275245f, 0.9872419133f,
+        0.8367622488f, 0.5475663786f, -0.8675753916f, -0.4973056806f, -0.2022662628f, -0.9793305667f, 0.9399189937f, 0.3413975472f, 0.9877404807f, -0.1561049093f, -0.9034455656f, 0.4287028224f, 0.1269804218f, -0.9919052235f, -0.3819600854f, 0.924178821f,
+        0.9754625894f, 0.2201652486f, -0.3204015856f, -0.9472818081f, -0.9874760884f, 0.1577687387f, 0.02535348474f, -0.9996785487f, 0.4835130794f, -0.8753371362f, -0.2850799925f, -0.9585037287f, -0.06805516006f, -0.99768156f, -0.7885244045f, -0.6150034663f,
+        0.3185392127f, -0.9479096845f, 0.8880043089f, 0.4598351306f, 0.6476921488f, -0.7619021462f, 0.9820241299f, 0.1887554194f, 0.9357275128f, -0.3527237187f, -0.8894895414f, 0.4569555293f, 0.7922791302f, 0.6101588153f, 0.7483818261f, 0.6632681526f,
+        -0.7288929755f, -0.6846276581f, 0.8729032783f, -0.4878932944f, 0.8288345784f, 0.5594937369f, 0.08074567077f, 0.9967347374f, 0.9799148216f, -0.1994165048f, -0.580730673f, -0.8140957471f, -0.4700049791f, -0.8826637636f, 0.2409492979f, 0.9705377045f,
+        0.9437816757f, -0.3305694308f, -0.8927998638f, -0.4504535528f, -0.8069622304f, 0.5906030467f, 0.06258973166f, 0.9980393407f, -0.9312597469f, 0.3643559849f, 0.5777449785f, 0.8162173362f, -0.3360095855f, -0.941858566f, 0.697932075f, -0.7161639607f,
+        -0.002008157227f, -0.9999979837f, -0.1827294312f, -0.9831632392f, -0.6523911722f, 0.7578824173f, -0.4302626911f, -0.9027037258f, -0.9985126289f, -0.05452091251f, -0.01028102172f, -0.9999471489f, -0.4946071129f, 0.8691166802f, -0.2999350194f, 0.9539596344f,
+        0.8165471961f, 0.5772786819f, 0.2697460475f, 0.962931498f, -0.7306287391f, -0.6827749597f, -0.7590952064f, -0.6509796216f, -0.907053853f, 0.4210146171f, -0.5104861064f, -0.8598860013f, 0.8613350597f, 0.5080373165f, 0.5007881595f, -0.8655698812f,
+        -0.654158152f, 0.7563577938f, -0.8382755311f, -0.545246856f, 0.6940070834f, 0.7199681717f, 0.06950936031f, 0.9975812994f, 0.1702942185f, -0.9853932612f, 0.2695973274f, 0.9629731466f, 0.5519612192f, -0.8338697815f, 0.225657487f, -0.9742067022f,
+        0.4215262855f, -0.9068161835f, 0.4881873305f, -0.8727388672f, -0.3683854996f, -0.9296731273f, -0.9825390578f, 0.1860564427f, 0.81256471f, 0.5828709909f, 0.3196460933f, -0.9475370046f, 0.9570913859f, 0.2897862643f, -0.6876655497f, -0.7260276109f,
+        -0.9988770922f, -0.047376731f, -0.1250179027f, 0.992154486f, -0.8280133617f, 0.560708367f, 0.9324863769f, -0.3612051451f, 0.6394653183f, 0.7688199442f, -0.01623847064f, -0.9998681473f, -0.9955014666f, -0.09474613458f, -0.81453315f, 0.580117012f,
+        0.4037327978f, -0.9148769469f, 0.9944263371f, 0.1054336766f, -0.1624711654f, 0.9867132919f, -0.9949487814f, -0.100383875f, -0.6995302564f, 0.7146029809f, 0.5263414922f, -0.85027327f, -0.5395221479f, 0.841971408f, 0.6579370318f, 0.7530729462f,
+        0.01426758847f, -0.9998982128f, -0.6734383991f, 0.7392433447f, 0.639412098f, -0.7688642071f, 0.9211571421f, 0.3891908523f, -0.146637214f, -0.9891903394f, -0.782318098f, 0.6228791163f, -0.5039610839f, -0.8637263605f, -0.7743120191f, -0.6328039957f,
+    };
+
+    // --- Helpers ---
+
+    inline int32_t WrapAdd(int32_t a, int32_t b) noexcept { return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b)); }
+    inline int32_t WrapMul(int32_t a, int32_t b) noexcept { return static_cast<int32_t>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b)); }
+
+    inline int32_t FastFloor(float f) noexcept { return f >= 0 ? static_cast<int32_t>(f) : static_cast<int32_t>(f) - 1; }
+    inline int32_t FastRound(float f) noexcept { return f >= 0 ? static_cast<int32_t>(f + 0.5f) : static_cast<int32_t>(f - 0.5f); }
+
+    inline float Lerp(float a, float b, float t) noexcept { return a + t * (b - a); }
+    inline float InterpQuintic(float t) noexcept { return t * t * t * (t * (t * 6 - 15) + 10); }
+
+    inline int32_t Hash(int32_t seed, int32_t xPrimed, int32_t yPrimed) noexcept {
+        return WrapMul(seed ^ xPrimed ^ yPrimed, HASH_MUL);
+    }
+
+    inline float GradCoord(int32_t seed, int32_t xPrimed, int32_t yPrimed, float xd, float yd) noexcept {
+        int32_t hash = Hash(seed, xPrimed, yPrimed);
+        hash ^= hash >> 15;
+        hash &= 127 << 1;
+        return xd * Gradients2D[hash] + yd * Gradients2D[hash | 1];
+    }
+
+    // The gradient vector GradCoord dots with.
+    inline void GradVec(int32_t seed, int32_t xPrimed, int32_t yPrimed, float& outX, float& outY) noexcept {
+        int32_t hash = Hash(seed, xPrimed, yPrimed);
+        hash ^= hash >> 15;
+        hash &= 127 << 1;
+        outX = Gradients2D[hash];
+        outY = Gradients2D[hash | 1];
+    }
+
+    // OpenSimplex2 coordinate skew (applied after the frequency scale).
+    inline void Skew(float& x, float& y) noexcept {
+        const float t = (x + y) * F2;
+        x += t;
+        y += t;
+    }
+
+    // --- Single-octave kernels (input already scaled / skewed) ---
+
+    inline float Simplex2(int32_t seed, float x, float y) noexcept {
+        int32_t i = FastFloor(x);
+        int32_t j = FastFloor(y);
+        const float xi = x - static_cast<float>(i);
+        const float yi = y - static_cast<float>(j);
+
+        const float t  = (xi + yi) * G2;
+        const float x0 = xi - t;
+        const float y0 = yi - t;
+
+        i = WrapMul(i, PRIME_X);
+        j = WrapMul(j, PRIME_Y);
+
+        float n0 = 0, n1 = 0, n2 = 0;
+
+        const float a = 0.5f - x0 * x0 - y0 * y0;
+        if (a > 0) n0 = (a * a) * (a * a) * GradCoord(seed, i, j, x0, y0);
+
+        const float c = C_T * t + (C_A + a);
+        if (c > 0) {
+            const float x2 = x0 + OFF_2;
+            const float y2 = y0 + OFF_2;
+            n2 = (c * c) * (c * c) * GradCoord(seed, WrapAdd(i, PRIME_X), WrapAdd(j, PRIME_Y), x2, y2);
+        }
+
+        if (y0 > x0) {
+            const float x1 = x0 + OFF_G2;
+            const float y1 = y0 + OFF_G2_M1;
+            const float b  = 0.5f - x1 * x1 - y1 * y1;
+            if (b > 0) n1 = (b * b) * (b * b) * GradCoord(seed, i, WrapAdd(j, PRIME_Y), x1, y1);
+        } else {
+            const float x1 = x0 + OFF_G2_M1;
+            const float y1 = y0 + OFF_G2;
+            const float b  = 0.5f - x1 * x1 - y1 * y1;
+            if (b > 0) n1 = (b * b) * (b * b) * GradCoord(seed, WrapAdd(i, PRIME_X), j, x1, y1);
+        }
+
+        return (n0 + n1 + n2) * SIMPLEX_OUT;
+    }
+
+    // Simplex2 plus its analytic gradient with respect to the (skewed) input x, y.
+    // The value is computed with exactly the operations of Simplex2, so it is bit-identical.
+    inline float Simplex2Deriv(int32_t seed, float x, float y, float& outDx, float& outDy) noexcept {
+        int32_t i = FastFloor(x);
+        int32_t j = FastFloor(y);
+        const float xi = x - static_cast<float>(i);
+        const float yi = y - static_cast<float>(j);
+
+        const float t  = (xi + yi) * G2;
+        const float x0 = xi - t;
+        const float y0 = yi - t;
+
+        i = WrapMul(i, PRIME_X);
+        j = WrapMul(j, PRIME_Y);
+
+        float n0 = 0, n1 = 0, n2 = 0;
+        float d0 = 0, e0 = 0; // d(n)/d(x0), d(n)/d(y0) summed over the corners
+
+        // One corner: n = w^4 * dot(g, p) with w = 0.5 - |p|^2, so dn/dp = w^4 g - 8 w^3 dot(g, p) p.
+        auto corner = [&](float w, int32_t xp, int32_t yp, float px, float py, float& n) {
+            float gx, gy;
+            GradVec(seed, xp, yp, gx, gy);
+            const float dot = px * gx + py * gy;
+            const float w2  = w * w;
+            n = w2 * w2 * dot;
+            const float k = -8.0f * w2 * w * dot;
+            d0 += w2 * w2 * gx + k * px;
+            e0 += w2 * w2 * gy + k * py;
+        };
+
+        const float a = 0.5f - x0 * x0 - y0 * y0;
+        if (a > 0) corner(a, i, j, x0, y0, n0);
+
+        const float c = C_T * t + (C_A + a);
+        if (c > 0) corner(c, WrapAdd(i, PRIME_X), WrapAdd(j, PRIME_Y), x0 + OFF_2, y0 + OFF_2, n2);
+
+        if (y0 > x0) {
+            const float x1 = x0 + OFF_G2;
+            const float y1 = y0 + OFF_G2_M1;
+            const float b  = 0.5f - x1 * x1 - y1 * y1;
+            if (b > 0) corner(b, i, WrapAdd(j, PRIME_Y), x1, y1, n1);
+        } else {
+            const float x1 = x0 + OFF_G2_M1;
+            const float y1 = y0 + OFF_G2;
+            const float b  = 0.5f - x1 * x1 - y1 * y1;
+            if (b > 0) corner(b, WrapAdd(i, PRIME_X), j, x1, y1, n1);
+        }
+
+        // (x0, y0) = (x, y) - G2 * (x + y) + const inside a cell.
+        outDx = ((1 - G2) * d0 - G2 * e0) * SIMPLEX_OUT;
+        outDy = ((1 - G2) * e0 - G2 * d0) * SIMPLEX_OUT;
+        return (n0 + n1 + n2) * SIMPLEX_OUT;
+    }
+
+    inline float Perlin2(int32_t seed, float x, float y) noexcept {
+        int32_t x0 = FastFloor(x);
+        int32_t y0 = FastFloor(y);
+
+        const float xd0 = x - static_cast<float>(x0);
+        const float yd0 = y - static_cast<float>(y0);
+        const float xd1 = xd0 - 1;
+        const float yd1 = yd0 - 1;
+
+        const float xs = InterpQuintic(xd0);
+        const float ys = InterpQuintic(yd0);
+
+        x0 = WrapMul(x0, PRIME_X);
+        y0 = WrapMul(y0, PRIME_Y);
+        const int32_t x1 = WrapAdd(x0, PRIME_X);
+        const int32_t y1 = WrapAdd(y0, PRIME_Y);
+
+        const float xf0 = Lerp(GradCoord(seed, x0, y0, xd0, yd0), GradCoord(seed, x1, y0, xd1, yd0), xs);
+        const float xf1 = Lerp(GradCoord(seed, x0, y1, xd0, yd1), GradCoord(seed, x1, y1, xd1, yd1), xs);
+
+        return Lerp(xf0, xf1, ys) * PERLIN_OUT;
+    }
+
+    // FastNoiseLite defaults: EuclideanSq distance, Distance return type.
+    inline float Cellular2(int32_t seed, float x, float y) noexcept {
+        const int32_t xr = FastRound(x);
+        const int32_t yr = FastRound(y);
+
+        float distance0 = 1e10f;
+
+        int32_t       xPrimed     = WrapMul(xr - 1, PRIME_X);
+        const int32_t yPrimedBase = WrapMul(yr - 1, PRIME_Y);
+
+        for (int32_t xi = xr - 1; xi <= xr + 1; xi++) {
+            int32_t yPrimed = yPrimedBase;
+            for (int32_t yi = yr - 1; yi <= yr + 1; yi++) {
+                const int32_t idx = Hash(seed, xPrimed, yPrimed) & (255 << 1);
+
+                const float vecX = (static_cast<float>(xi) - x) + RandVecs2D[idx]     * CELLULAR_JITTER;
+                const float vecY = (static_cast<float>(yi) - y) + RandVecs2D[idx | 1] * CELLULAR_JITTER;
+
+                const float newDistance = vecX * vecX + vecY * vecY;
+                if (newDistance < distance0) distance0 = newDistance;
+                yPrimed = WrapAdd(yPrimed, PRIME_Y);
+            }
+            xPrimed = WrapAdd(xPrimed, PRIME_X);
+        }
+        return distance0 - 1;
+    }
+}
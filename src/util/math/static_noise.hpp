@@ -0,0 +1,185 @@
+#pragma once
+
+#include "util/math/FastNoiseLite.hpp"
+#include "util/math/noise_batch.hpp"
+#include "util/math/noise_scalar.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+enum class NoiseKind : uint8_t { OpenSimplex2, Perlin, Cellular };
+
+// 2D noise module with its noise type, fractal type and octave count fixed at
+// compile time. Seed, frequency, lacunarity and gain stay runtime values.
+//
+// GetNoise(x, y) produces the same bits as FastNoiseLite::GetNoise configured
+// with Apply(); the type dispatch is gone and the octave loop unrolls, so the
+// whole module inlines into the caller. The batched overload runs the SIMD
+// NoiseBatch kernels for OpenSimplex2 and a scalar loop for the other kinds.
+// Cellular uses FastNoiseLite's defaults (EuclideanSq, Distance, jitter 1).
+template <NoiseKind Kind, NoiseLayer::Fractal Fractal, int32_t Octaves>
+class StaticNoise {
+    static_assert(Octaves >= 1 && Octaves <= NoiseBatch::MAX_STATIC_OCTAVES, "unsupported octave count");
+    static_assert(Fractal != NoiseLayer::Fractal::None || Octaves == 1, "single noise has one octave");
+
+public:
+    StaticNoise() : StaticNoise(1337, 0.01f) {}
+
+    StaticNoise(int32_t seed, float frequency, float lacunarity = 2.0f, float gain = 0.5f) {
+        m_Layer.Seed        = seed;
+        m_Layer.Frequency   = frequency;
+        m_Layer.FractalType = Fractal;
+        m_Layer.Octaves     = Octaves;
+        m_Layer.Lacunarity  = lacunarity;
+        m_Layer.Gain        = gain;
+
+        // Weighted strength is 0, so the amplitude only follows the gain.
+        float amp = m_Layer.Bounding();
+        for (int32_t o = 0; o < Octaves; ++o) {
+            m_Amps[o] = amp;
+            amp *= gain;
+        }
+    }
+
+    float GetNoise(float x, float y) const noexcept {
+        x *= m_Layer.Frequency;
+        y *= m_Layer.Frequency;
+        if constexpr (Kind == NoiseKind::OpenSimplex2) NoiseScalar::Skew(x, y);
+
+        if constexpr (Fractal == NoiseLayer::Fractal::None) {
+            return Single(m_Layer.Seed, x, y);
+        } else {
+            float sum = 0;
+            for (int32_t o = 0; o < Octaves; ++o) {
+                float noise = Single(NoiseScalar::WrapAdd(m_Layer.Seed, o), x, y);
+                if constexpr (Fractal == NoiseLayer::Fractal::FBm) {
+                    sum += noise * m_Amps[o];
+                } else {
+                    noise = noise < 0 ? -noise : noise;
+                    sum += (noise * -2 + 1) * m_Amps[o];
+                }
+                x *= m_Layer.Lacunarity;
+                y *= m_Layer.Lacunarity;
+            }
+            return sum;
+        }
+    }
+
+    // GetNoise(x, y) (same bits) plus its analytic gradient d/dx, d/dy in input units.
+    // OpenSimplex2 only. Ridged octaves are not differentiable where the octave crosses
+    // zero (the ridge crest); the one-sided slope is returned there.
+    float GetNoiseDeriv(float x, float y, float& outDx, float& outDy) const noexcept {
+        static_assert(Kind == NoiseKind::OpenSimplex2, "analytic gradient is only implemented for OpenSimplex2");
+
+        x *= m_Layer.Frequency;
+        y *= m_Layer.Frequency;
+        NoiseScalar::Skew(x, y);
+
+        // Gradient with respect to the skewed coordinates, chained through the skew at the end.
+        float gx = 0, gy = 0;
+        float sum;
+        if constexpr (Fractal == NoiseLayer::Fractal::None) {
+            sum = NoiseScalar::Simplex2Deriv(m_Layer.Seed, x, y, gx, gy);
+        } else {
+            sum = 0;
+            float scale = 1.0f; // d(octave coordinate) / d(skewed coordinate)
+            for (int32_t o = 0; o < Octaves; ++o) {
+                float dx, dy;
+                float noise = NoiseScalar::Simplex2Deriv(NoiseScalar::WrapAdd(m_Layer.Seed, o), x, y, dx, dy);
+                float w = m_Amps[o] * scale;
+                if constexpr (Fractal == NoiseLayer::Fractal::FBm) {
+                    sum += noise * m_Amps[o];
+                } else {
+                    if (noise < 0) w = -w;
+                    noise = noise < 0 ? -noise : noise;
+                    sum += (noise * -2 + 1) * m_Amps[o];
+                    w *= -2.0f;
+                }
+                gx += dx * w;
+                gy += dy * w;
+                x *= m_Layer.Lacunarity;
+                y *= m_Layer.Lacunarity;
+                scale *= m_Layer.Lacunarity;
+            }
+        }
+
+        // Skewed (u, v) = f * (x, y) + f * F2 * (x + y).
+        const float f  = m_Layer.Frequency;
+        const float sk = (gx + gy) * NoiseScalar::F2;
+        outDx = (gx + sk) * f;
+        outDy = (gy + sk) * f;
+        return sum;
+    }
+
+    // out[i] = GetNoiseDeriv(xs[i], ys[i], outDx[i], outDy[i]) for i < count, on the
+    // NoiseBatch kernels (same bits). OpenSimplex2 only.
+    void GetNoiseDeriv(const float* xs, const float* ys, float* out, float* outDx, float* outDy,
+                       size_t count) const {
+        static_assert(Kind == NoiseKind::OpenSimplex2, "analytic gradient is only implemented for OpenSimplex2");
+        NoiseBatch::EvaluateDeriv<Fractal, Octaves>(m_Layer, xs, ys, out, outDx, outDy, count);
+    }
+
+    // out[i] = GetNoise(xs[i], ys[i]) for i < count.
+    void GetNoise(const float* xs, const float* ys, float* out, size_t count) const {
+        if constexpr (Kind == NoiseKind::OpenSimplex2) {
+            NoiseBatch::Evaluate<Fractal, Octaves>(m_Layer, xs, ys, out, count);
+        } else {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = GetNoise(xs[i], ys[i]);
+        }
+    }
+
+    // Same, summing only the first 'octaves' octaves at their full-layer amplitudes
+    // (see NoiseBatch::EvaluateOctaves); 0 octaves reads 0. OpenSimplex2 only.
+    void GetNoise(const float* xs, const float* ys, float* out, size_t count, int32_t octaves) const {
+        static_assert(Kind == NoiseKind::OpenSimplex2, "octave truncation is only implemented for OpenSimplex2");
+        if (octaves >= Octaves) {
+            GetNoise(xs, ys, out, count);
+        } else if (octaves <= 0) {
+            std::fill(out, out + count, 0.0f);
+        } else {
+            NoiseBatch::EvaluateOctaves(m_Layer, octaves, xs, ys, out, count);
+        }
+    }
+
+    // Number of leading octaves whose wavelength (1 / octave frequency) is at least minWavelength.
+    int32_t OctavesAbove(float minWavelength) const noexcept {
+        float wavelength = 1.0f / m_Layer.Frequency;
+        int32_t o = 0;
+        while (o < Octaves && wavelength >= minWavelength) {
+            wavelength /= m_Layer.Lacunarity;
+            ++o;
+        }
+        return o;
+    }
+
+    // Wavelength of octave o.
+    float GetWavelength(int32_t o) const noexcept {
+        float wavelength = 1.0f / m_Layer.Frequency;
+        for (int32_t k = 0; k < o; ++k) wavelength /= m_Layer.Lacunarity;
+        return wavelength;
+    }
+
+    static constexpr int32_t GetOctaves() noexcept { return Octaves; }
+
+    const NoiseLayer& GetLayer() const noexcept { return m_Layer; }
+
+    // Configures a FastNoiseLite instance to produce exactly this module (A/B reference).
+    void Apply(FastNoiseLite& noise) const {
+        m_Layer.Apply(noise);
+        if constexpr (Kind == NoiseKind::Perlin)   noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+        if constexpr (Kind == NoiseKind::Cellular) noise.SetNoiseType(FastNoiseLite::NoiseType_Cellular);
+    }
+
+private:
+    static float Single(int32_t seed, float x, float y) noexcept {
+        if constexpr (Kind == NoiseKind::OpenSimplex2) return NoiseScalar::Simplex2(seed, x, y);
+        else if constexpr (Kind == NoiseKind::Perlin)  return NoiseScalar::Perlin2(seed, x, y);
+        else                                           return NoiseScalar::Cellular2(seed, x, y);
+    }
+
+    NoiseLayer                   m_Layer;
+    std::array<float, Octaves>   m_Amps{};
+};
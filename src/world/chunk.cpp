@@ -3,6 +3,7 @@
 #include "glm/fwd.hpp"
 #include "physics/bound_box.hpp"
 #include "world/sphere.hpp"
+#include "world/terrain_material.hpp"
 
 #include <algorithm>
 #include <array>
@@ -11,12 +12,33 @@
 #include <cstring>
 #include <iterator>
 #include <limits>
+#include <span>
 #include <string>
+#include <utility>
 #include <format>
 
 Chunk::Chunk(int32_t x, int32_t z) : m_Coordinates({x, z})
 {  }
 
+namespace {
+    // Material of a merged block: the surface cell whose height is closest to the
+    // block's sphere height, so the colour matches where the sphere is drawn.
+    // Empty cells (lowest float) are never closest while the block has a surface.
+    uint8_t BlockMaterial(const float* cellH, const uint8_t* cellMat, uint32_t bx, uint32_t bz,
+                          uint32_t size, float height) {
+        uint8_t best = TerrainMaterial::NONE;
+        float   bestDist = std::numeric_limits<float>::max();
+        for (uint32_t dz = 0; dz < size; ++dz) {
+            for (uint32_t dx = 0; dx < size; ++dx) {
+                const uint32_t ci   = (bz + dz) * CHUNK_SIZE + (bx + dx);
+                const float    dist = std::abs(cellH[ci] - height);
+                if (dist < bestDist) { bestDist = dist; best = cellMat[ci]; }
+            }
+        }
+        return best;
+    }
+}
+
 // move data
 Chunk::Chunk(Chunk&& other){
     GPUInfo = other.GPUInfo;
@@ -26,83 +48,107 @@ Chunk::Chunk(Chunk&& other){
     m_Bounds = other.m_Bounds;
     m_Spheres = std::move(other.m_Spheres);
     m_LODs = std::move(other.m_LODs);
+    m_Scatter = std::move(other.m_Scatter);
+    m_LODOnly = other.m_LODOnly;
+    m_OmittedWavelength = other.m_OmittedWavelength;
+    m_LODDirty = other.m_LODDirty;
 }
 
 bool Chunk::AddSphere(const Sphere& sphere) {
-    // Insert while maintaining order (based on LocalIndex) for binary search/locality
-    uint32_t insertIndex;
+    // SphereColumns inserts in order (CellIndex, then height)
+    // Update bound box
+    float worldY = (float)sphere.Position.DiscreteHeight * SPHERE_RADIUS;
+
+    Sphere added = sphere;
+    if (added.GetMaterial() == TerrainMaterial::NONE) added.SetMaterial(TerrainMaterial::FromHeight(worldY));
 
-    if (BinarySearch(sphere.Position, insertIndex)){
+    if (!m_Spheres.Insert(added)){
         LOG_WARN("[CHUNK] Sphere at position already exists, skipping add.");
         return false;
     }
 
-    m_Spheres.emplace(m_Spheres.begin()+insertIndex, sphere);
-
-    // Update bound box
-    float worldY = (float)sphere.Position.DiscreteHeight * SPHERE_RADIUS;
     m_Bounds.m_Min.y = std::min(worldY-SPHERE_RADIUS, m_Bounds.m_Min.y);
     m_Bounds.m_Max.y = std::max(worldY+SPHERE_RADIUS, m_Bounds.m_Max.y);
 
     IsDirty = true;
+    m_LODDirty.set(sphere.Position.CellIndex);
+    DropScatter(SphereColumns::CellMask().set(sphere.Position.CellIndex));
     return true;
 }
 
 bool Chunk::RemoveSphere(const SpherePosition targetPos) {
-    uint32_t posIndex;
-
-    if (!BinarySearch(targetPos, posIndex)){
+    if (!m_Spheres.Erase(targetPos)){
         LOG_WARN("[CHUNK] Sphere at position does not exist, skipping remove.");
         return false;
     }
 
-    m_Spheres.erase(m_Spheres.begin()+posIndex);
-
     IsDirty = true;
+    m_LODDirty.set(targetPos.CellIndex);
+    DropScatter(SphereColumns::CellMask().set(targetPos.CellIndex));
     return true;
 }
 
-bool Chunk::GetCell(uint8_t x, uint8_t z, uint32_t &outOffset, uint32_t &outSize) const {
-    const uint16_t targetIndex = static_cast<uint16_t>(z * CHUNK_SIZE + x);
+ChunkEditReport Chunk::ApplyEdits(std::span<const SphereEdit> edits) {
+    ChunkEditReport report;
+    if (edits.empty()) return report;
+
+    // Sort 64-bit keys - CellIndex | biased height | batch index - rather than the edits
+    // themselves: unique keys make a plain sort stable, and moving 8 bytes beats 28.
+    std::vector<uint64_t> keys(edits.size());
+    for (size_t i = 0; i < edits.size(); ++i) {
+        const SpherePosition& pos = edits[i].Target.Position;
+        const uint16_t biased = static_cast<uint16_t>(static_cast<uint16_t>(pos.DiscreteHeight) ^ 0x8000u);
+        keys[i] = (static_cast<uint64_t>(pos.CellIndex) << 48) | (static_cast<uint64_t>(biased) << 32) | i;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<SphereEdit> sorted;
+    sorted.reserve(edits.size());
+    for (const uint64_t key : keys) {
+        SphereEdit& edit = sorted.emplace_back(edits[static_cast<uint32_t>(key)]);
+        Sphere& target = edit.Target;
+        if (edit.Type == SphereEdit::Action::Add && target.GetMaterial() == TerrainMaterial::NONE)
+            target.SetMaterial(TerrainMaterial::FromHeight(target.Position.DiscreteHeight * SPHERE_RADIUS));
+    }
 
-    // -- Lower bound (first sphere with CellIndex == targetIndex) ----------------
-    int64_t left = 0, right = m_Spheres.size();
-    while (left < right){
-        int64_t mid = (right - left)/2 + left;
+    m_Spheres.Merge(sorted, report.TouchedCells, report.Added, report.Removed);
+    if (report.TouchedCells.none()) return report;
 
-        if (targetIndex > m_Spheres[mid].Position.CellIndex){
-            // search in right half
-            left = mid+1;
-        }
-        else { // when target <= mid
-            right = mid;
-        }
-    }
+    CalculateBounds();
+    IsDirty = true;
+    m_LODDirty |= report.TouchedCells;
+    DropScatter(report.TouchedCells);
+    return report;
+}
 
-    // validate lowerbound
-    if (!(left < (int64_t)m_Spheres.size()) || m_Spheres[left].Position.CellIndex != targetIndex){
-        LOG_WARN("[CHUNK] Target cell (%u, %u) not found.", x, z);
+void Chunk::DropScatter(const SphereColumns::CellMask& cells) {
+    // An instance stands on the centre of its candidate cell (ScatterLayer::Populate).
+    const int32_t baseX = m_Coordinates.X * static_cast<int32_t>(CHUNK_SIZE);
+    const int32_t baseZ = m_Coordinates.Z * static_cast<int32_t>(CHUNK_SIZE);
+    std::erase_if(m_Scatter, [&](const ScatterInstance& instance) {
+        const int32_t x = static_cast<int32_t>(std::lround(instance.X / SPHERE_RADIUS)) - baseX;
+        const int32_t z = static_cast<int32_t>(std::lround(instance.Z / SPHERE_RADIUS)) - baseZ;
+        return cells[static_cast<size_t>(z * CHUNK_SIZE + x)];
+    });
+}
+
+bool Chunk::SetShading(const SpherePosition pos, uint16_t ambientOcclusion, const std::array<LightVector, 6>& lights) {
+    if (!m_Spheres.SetShading({ pos, ambientOcclusion, lights })){
+        LOG_WARN("[CHUNK] Sphere at position does not exist, skipping shading.");
         return false;
     }
 
-    outOffset = static_cast<uint32_t>(left); // start index is left
+    IsDirty = true;
+    return true;
+}
 
-    // -- Upper bound (first sphere with CellIndex > targetIndex) -----------------
-    right = m_Spheres.size();
-    while (left < right){
-        int64_t mid = (right-left)/2 + left;
+bool Chunk::GetCell(uint8_t x, uint8_t z, uint32_t &outOffset, uint32_t &outSize) const {
+    const uint16_t targetIndex = static_cast<uint16_t>(z * CHUNK_SIZE + x);
 
-        if (targetIndex < m_Spheres[mid].Position.CellIndex){
-            // search in left half
-            right = mid;
-        }
-        else { // when target >= mid
-            left = mid+1;
-        }
+    if (!m_Spheres.GetCellRange(targetIndex, outOffset, outSize)){
+        LOG_WARN("[CHUNK] Target cell (%u, %u) not found.", x, z);
+        return false;
     }
-
-   // left is now the exclusive upper bound
-    outSize = static_cast<uint32_t>(left) - outOffset;
     return true;
 }
 
@@ -112,36 +158,50 @@ void Chunk::GenerateMesh(std::vector<GPUSphere>& outBuffer, float radius, float
 
     // Full-detail fast path - preserves per-sphere AO and light data, emits ALL layers.
     // Only taken when no LOD constraints are active.
+    // Runs are written out whole with unshaded defaults; the sparse shading table is in
+    // the same order, so its entries are patched in while their run is at hand.
     if (maxError <= 0.0f && maxBlockSize >= CHUNK_SIZE) {
-        outBuffer.reserve(outBuffer.size() + m_Spheres.size());
-        for (const auto& sphere : m_Spheres) {
-            GPUSphere gpu;
-            uint8_t lx, lz; int16_t ly;
-            sphere.Position.GetCoordinates(lx, ly, lz);
-            gpu.PositionRadius    = glm::vec4(chunkWorldX + float(lx) * radius,
-                                              float(ly) * radius,
-                                              chunkWorldZ + float(lz) * radius,
-                                              radius);
-            gpu.ChunkTypeAndFlags = sphere.ChunkTypeAndFlags;
-            gpu.AmbientOcclusion  = sphere.AmbientOcclusion;
-            gpu.Lights            = sphere.Lights;
-            outBuffer.emplace_back(gpu);
+        outBuffer.reserve(outBuffer.size() + m_Spheres.GetSize());
+
+        const std::span<const SphereColumns::ShadedSphere> shades = m_Spheres.GetShading();
+        size_t shade = 0;
+        for (uint32_t run = 0; run < m_Spheres.RunCount(); ++run) {
+            const uint16_t cell   = m_Spheres.GetRunCell(run);
+            const int16_t  bottom = m_Spheres.GetRunBottom(run);
+            const int16_t  top    = m_Spheres.GetRunTop(run);
+
+            GPUSphere gpu{};
+            gpu.PositionRadius    = glm::vec4(chunkWorldX + float(cell % CHUNK_SIZE) * radius, 0.0f,
+                                              chunkWorldZ + float(cell / CHUNK_SIZE) * radius, radius);
+            gpu.ChunkTypeAndFlags = m_Spheres.GetRunFlags(run);
+            const size_t first    = outBuffer.size();
+            for (int32_t y = bottom; y <= top; ++y) {
+                gpu.PositionRadius.y = float(y) * radius;
+                outBuffer.emplace_back(gpu);
+            }
+
+            for (; shade < shades.size() && shades[shade].Position.CellIndex == cell &&
+                   shades[shade].Position.DiscreteHeight <= top; ++shade) {
+                GPUSphere& lit       = outBuffer[first + (shades[shade].Position.DiscreteHeight - bottom)];
+                lit.AmbientOcclusion = shades[shade].AmbientOcclusion;
+                lit.Lights           = shades[shade].Lights;
+            }
         }
         return;
     }
 
     // Adaptive LOD path.
-    // Build per-cell surface height (world-space float, highest sphere wins).
+    // Build per-cell surface height (world-space float, highest sphere wins): runs are
+    // sorted by height, so the last run of a cell holds its top sphere.
     constexpr uint32_t NCELLS  = CHUNK_SIZE * CHUNK_SIZE;
     constexpr float    EMPTY   = std::numeric_limits<float>::lowest();
-    std::array<float, NCELLS> cellH;
+    std::array<float, NCELLS>   cellH;
+    std::array<uint8_t, NCELLS> cellMat{};
     cellH.fill(EMPTY);
-    for (const auto& sphere : m_Spheres) {
-        const uint16_t ci = sphere.Position.CellIndex;
-        if (ci < NCELLS) {
-            const float h = float(sphere.Position.DiscreteHeight) * radius;
-            if (h > cellH[ci]) cellH[ci] = h;
-        }
+    for (uint32_t run = 0; run < m_Spheres.RunCount(); ++run) {
+        const uint16_t ci = m_Spheres.GetRunCell(run);
+        cellH[ci]   = float(m_Spheres.GetRunTop(run)) * radius;
+        cellMat[ci] = m_Spheres.GetRunMaterial(run);
     }
 
     // Iterative DFS quadtree subdivision.
@@ -185,34 +245,70 @@ void Chunk::GenerateMesh(std::vector<GPUSphere>& outBuffer, float radius, float
 
         // Emit one sphere for this block.
         // Center is the geometric middle of the block's cell grid.
-        // Use average height - gives correct biome colour and smooth visual impression.
+        // Use average height - gives a smooth visual impression.
+        const float avgY = hSum / float(cnt);
         GPUSphere gpu{};
         gpu.PositionRadius = glm::vec4(
             chunkWorldX + (float(bx) + float(size - 1) * 0.5f) * radius,
-            hSum / float(cnt),
+            avgY,
             chunkWorldZ + (float(bz) + float(size - 1) * 0.5f) * radius,
             radius * float(size));
+        gpu.ChunkTypeAndFlags = BlockMaterial(cellH.data(), cellMat.data(), bx, bz, size, avgY);
         outBuffer.emplace_back(gpu);
     }
 }
 
+namespace {
+    constexpr float EMPTY_CELL = std::numeric_limits<float>::lowest();
+
+    // LOD block (bx, bz) of blockSize cells from the cell surface heights (EMPTY_CELL where
+    // a column has no sphere). False, and nothing written, when the whole block is empty.
+    bool BuildLODBlock(const float* cellH, const uint8_t* cellMat, uint32_t bx, uint32_t bz,
+                       uint32_t blockSize, CompactSphere& out) {
+        float    sum = 0.0f;
+        uint32_t cnt = 0;
+        for (uint32_t dz = 0; dz < blockSize; ++dz) {
+            for (uint32_t dx = 0; dx < blockSize; ++dx) {
+                const uint32_t ci = (bz * blockSize + dz) * CHUNK_SIZE + (bx * blockSize + dx);
+                const float h = cellH[ci];
+                if (h != EMPTY_CELL) { sum += h; ++cnt; }
+            }
+        }
+        if (cnt == 0) return false;
+
+        const int32_t halfRadX = static_cast<int32_t>(2u * bx * blockSize + blockSize - 1u);
+        const int32_t halfRadZ = static_cast<int32_t>(2u * bz * blockSize + blockSize - 1u);
+        const float   avgY     = sum / static_cast<float>(cnt);
+        const int32_t halfRadY = static_cast<int32_t>(std::lround(2.0f * avgY / SPHERE_RADIUS));
+
+        out = CompactSphere{};
+        out.lx      = static_cast<int16_t>(halfRadX);
+        out.ly      = static_cast<int16_t>(halfRadY);
+        out.lz      = static_cast<int16_t>(halfRadZ);
+        out.lodStep = static_cast<uint8_t>(blockSize);
+        out.color   = BlockMaterial(cellH, cellMat, bx * blockSize, bz * blockSize, blockSize, avgY);
+        return true;
+    }
+}
+
 void Chunk::GenerateLODs() {
+    if (m_LODOnly) return;
+
     constexpr uint32_t NCELLS = static_cast<uint32_t>(CHUNK_SIZE) * static_cast<uint32_t>(CHUNK_SIZE);
-    constexpr float    EMPTY  = std::numeric_limits<float>::lowest();
 
-    std::array<float, NCELLS> cellH;
-    cellH.fill(EMPTY);
-    for (const auto& sphere : m_Spheres) {
-        const uint16_t ci = sphere.Position.CellIndex;
-        if (ci < NCELLS) {
-            const float h = float(sphere.Position.DiscreteHeight) * SPHERE_RADIUS;
-            if (h > cellH[ci]) cellH[ci] = h;
-        }
+    std::array<float, NCELLS>   cellH;
+    std::array<uint8_t, NCELLS> cellMat{};
+    cellH.fill(EMPTY_CELL);
+    for (uint32_t run = 0; run < m_Spheres.RunCount(); ++run) { // last run of a cell is its top
+        const uint16_t ci = m_Spheres.GetRunCell(run);
+        cellH[ci]   = float(m_Spheres.GetRunTop(run)) * SPHERE_RADIUS;
+        cellMat[ci] = m_Spheres.GetRunMaterial(run);
     }
 
     m_LODs.data.clear();
     m_LODs.lodOffsets.fill(0);
     m_LODs.lodCounts.fill(0);
+    m_LODDirty.reset();
 
     for (uint32_t lod = 0; lod < LOD_LEVELS; ++lod) {
         const uint32_t blockSize    = 1u << lod;
@@ -222,28 +318,8 @@ void Chunk::GenerateLODs() {
         uint32_t emitted = 0;
         for (uint32_t bz = 0; bz < blocksPerRow; ++bz) {
             for (uint32_t bx = 0; bx < blocksPerRow; ++bx) {
-                float    sum = 0.0f;
-                uint32_t cnt = 0;
-                for (uint32_t dz = 0; dz < blockSize; ++dz) {
-                    for (uint32_t dx = 0; dx < blockSize; ++dx) {
-                        const uint32_t ci = (bz * blockSize + dz) * CHUNK_SIZE + (bx * blockSize + dx);
-                        const float h = cellH[ci];
-                        if (h != EMPTY) { sum += h; ++cnt; }
-                    }
-                }
-                if (cnt == 0) continue;
-
-                const int32_t halfRadX = static_cast<int32_t>(2u * bx * blockSize + blockSize - 1u);
-                const int32_t halfRadZ = static_cast<int32_t>(2u * bz * blockSize + blockSize - 1u);
-                const float   avgY     = sum / static_cast<float>(cnt);
-                const int32_t halfRadY = static_cast<int32_t>(std::lround(2.0f * avgY / SPHERE_RADIUS));
-
-                CompactSphere cs{};
-                cs.lx      = static_cast<int16_t>(halfRadX);
-                cs.ly      = static_cast<int16_t>(halfRadY);
-                cs.lz      = static_cast<int16_t>(halfRadZ);
-                cs.lodStep = static_cast<uint8_t>(blockSize);
-                cs.color   = 0;
+                CompactSphere cs;
+                if (!BuildLODBlock(cellH.data(), cellMat.data(), bx, bz, blockSize, cs)) continue;
                 m_LODs.data.push_back(cs);
                 ++emitted;
             }
@@ -252,6 +328,132 @@ void Chunk::GenerateLODs() {
     }
 }
 
+bool Chunk::UpdateLODs(std::vector<LODPatch>& outPatches) {
+    if (m_LODDirty.none()) return true;
+    if (m_LODOnly) {
+        m_LODDirty.reset();
+        return true;
+    }
+    if (m_LODs.data.empty()) {
+        GenerateLODs();
+        return false;
+    }
+
+    constexpr uint32_t NCELLS   = static_cast<uint32_t>(CHUNK_SIZE) * static_cast<uint32_t>(CHUNK_SIZE);
+    constexpr uint32_t TOP_SIZE = 1u << (LOD_LEVELS - 1u);
+    constexpr uint32_t TOP_ROW  = CHUNK_SIZE / TOP_SIZE;
+
+    // Surface of the cells under the dirty coarsest blocks; every finer dirty block lies inside one.
+    std::array<float, NCELLS>   cellH;
+    std::array<uint8_t, NCELLS> cellMat{};
+    cellH.fill(EMPTY_CELL);
+
+    std::array<uint16_t, NCELLS> dirty;
+    uint32_t dirtyCount = 0;
+    for (uint32_t ci = 0; ci < NCELLS; ++ci)
+        if (m_LODDirty[ci]) dirty[dirtyCount++] = static_cast<uint16_t>(ci);
+
+    std::array<bool, TOP_ROW * TOP_ROW> topDirty{};
+    for (uint32_t i = 0; i < dirtyCount; ++i) {
+        const uint32_t ci  = dirty[i];
+        const uint32_t top = (ci / CHUNK_SIZE / TOP_SIZE) * TOP_ROW + (ci % CHUNK_SIZE) / TOP_SIZE;
+        if (topDirty[top]) continue;
+        topDirty[top] = true;
+
+        const uint32_t x0 = (top % TOP_ROW) * TOP_SIZE;
+        const uint32_t z0 = (top / TOP_ROW) * TOP_SIZE;
+        for (uint32_t z = z0; z < z0 + TOP_SIZE; ++z) { // a block row is a contiguous run range
+            const uint16_t rowEnd = static_cast<uint16_t>(z * CHUNK_SIZE + x0 + TOP_SIZE);
+            uint32_t run = 0, unused = 0;
+            m_Spheres.GetCellRuns(static_cast<uint16_t>(z * CHUNK_SIZE + x0), run, unused);
+            for (; run < m_Spheres.RunCount() && m_Spheres.GetRunCell(run) < rowEnd; ++run) {
+                const uint16_t cell = m_Spheres.GetRunCell(run); // last run of a cell is its top
+                cellH[cell]   = float(m_Spheres.GetRunTop(run)) * SPHERE_RADIUS;
+                cellMat[cell] = m_Spheres.GetRunMaterial(run);
+            }
+        }
+    }
+
+    const size_t firstPatch = outPatches.size();
+    for (uint32_t lod = 0; lod < LOD_LEVELS; ++lod) {
+        const uint32_t blockSize    = 1u << lod;
+        const uint32_t blocksPerRow = CHUNK_SIZE / blockSize;
+        const auto levelBegin = m_LODs.data.begin() + m_LODs.lodOffsets[lod];
+        const auto levelEnd   = levelBegin + m_LODs.lodCounts[lod];
+
+        std::array<bool, NCELLS> blocks{}; // per block of this level
+        for (uint32_t i = 0; i < dirtyCount; ++i) {
+            const uint32_t ci = dirty[i];
+            const uint32_t bx = (ci % CHUNK_SIZE) / blockSize;
+            const uint32_t bz = (ci / CHUNK_SIZE) / blockSize;
+            const uint32_t block = bz * blocksPerRow + bx;
+            if (blocks[block]) continue;
+            blocks[block] = true;
+
+            CompactSphere cs;
+            const bool filled = BuildLODBlock(cellH.data(), cellMat.data(), bx, bz, blockSize, cs);
+
+            // A level holds its non-empty blocks row-major, so (lz, lx) orders it.
+            const int16_t lx = static_cast<int16_t>(2u * bx * blockSize + blockSize - 1u);
+            const int16_t lz = static_cast<int16_t>(2u * bz * blockSize + blockSize - 1u);
+            const auto it = std::lower_bound(levelBegin, levelEnd, std::pair(lz, lx),
+                [](const CompactSphere& s, const std::pair<int16_t, int16_t>& key) {
+                    return std::pair(s.lz, s.lx) < key;
+                });
+            const bool stored = it != levelEnd && it->lz == lz && it->lx == lx;
+
+            if (stored != filled) {
+                // The block appeared or vanished: every later offset of the slab shifts.
+                outPatches.resize(firstPatch);
+                GenerateLODs();
+                return false;
+            }
+            if (!filled || std::memcmp(&*it, &cs, sizeof(CompactSphere)) == 0) continue;
+
+            *it = cs;
+            outPatches.push_back({ lod, static_cast<uint32_t>(it - levelBegin), cs });
+        }
+    }
+    m_LODDirty.reset();
+    return true;
+}
+
+void Chunk::SetLODOnly(ChunkLODSet&& lods, float omittedWavelength) {
+    m_Spheres.Clear();
+    m_Spheres.ShrinkToFit();
+    m_Scatter.clear();
+    m_LODs    = std::move(lods);
+    m_LODOnly = true;
+    m_LODDirty.reset();
+    m_OmittedWavelength = omittedWavelength;
+}
+
+int16_t Chunk::GetSurfaceHeight(uint8_t x, uint8_t z) const {
+    if (m_LODOnly) {
+        constexpr uint32_t BLOCKS = CHUNK_SIZE / 2;
+        if (m_LODs.lodCounts[1] != BLOCKS * BLOCKS) return NO_SURFACE;
+        // LOD1 blocks are row-major; ly is in half-radius units.
+        return static_cast<int16_t>(m_LODs.data[m_LODs.lodOffsets[1] + (z / 2u) * BLOCKS + x / 2u].ly / 2);
+    }
+
+    const int16_t own = GetColumnTop(x, z);
+    if (own != NO_SURFACE) return own;
+
+    // Empty column: highest cardinal neighbour that has a sphere of its own.
+    int16_t top = NO_SURFACE;
+    if (z > 0)              top = std::max(top, GetColumnTop(x, z - 1u));
+    if (z < CHUNK_SIZE - 1) top = std::max(top, GetColumnTop(x, z + 1u));
+    if (x > 0)              top = std::max(top, GetColumnTop(x - 1u, z));
+    if (x < CHUNK_SIZE - 1) top = std::max(top, GetColumnTop(x + 1u, z));
+    return top;
+}
+
+int16_t Chunk::GetColumnTop(uint32_t x, uint32_t z) const {
+    uint32_t first, last; // the cell's top sphere ends its last run
+    m_Spheres.GetCellRuns(static_cast<uint16_t>(z * CHUNK_SIZE + x), first, last);
+    return first == last ? NO_SURFACE : m_Spheres.GetRunTop(last - 1);
+}
+
 void Chunk::CalculateBounds(){
     const int32_t baseX = m_Coordinates.X * static_cast<int32_t>(CHUNK_SIZE);
     const int32_t baseZ = m_Coordinates.Z * static_cast<int32_t>(CHUNK_SIZE);
@@ -262,62 +464,42 @@ void Chunk::CalculateBounds(){
 
     m_Bounds.m_Min.y =  std::numeric_limits<float>::max();
     m_Bounds.m_Max.y = -std::numeric_limits<float>::max();
-    for (const auto& sphere : m_Spheres) {
-        float worldY = sphere.Position.DiscreteHeight * SPHERE_RADIUS;
-        m_Bounds.m_Min.y = std::min(worldY - SPHERE_RADIUS, m_Bounds.m_Min.y);
-        m_Bounds.m_Max.y = std::max(worldY + SPHERE_RADIUS, m_Bounds.m_Max.y);
+    for (uint32_t run = 0; run < m_Spheres.RunCount(); ++run) {
+        const float bottomY = m_Spheres.GetRunBottom(run) * SPHERE_RADIUS;
+        const float topY    = m_Spheres.GetRunTop(run) * SPHERE_RADIUS;
+        m_Bounds.m_Min.y = std::min(bottomY - SPHERE_RADIUS, m_Bounds.m_Min.y);
+        m_Bounds.m_Max.y = std::max(topY + SPHERE_RADIUS, m_Bounds.m_Max.y);
     }
 }
 
 
 bool Chunk::BinarySearch(const SpherePosition targetPos, uint32_t& outIndex) const {
-    int64_t left = 0;
-    int64_t right = m_Spheres.size(); // right is not included in search
-
-    while (left < right) {
-        int64_t mid = (right-left)/2 + left;
-
-        // check local index first
-        if (targetPos == m_Spheres[mid].Position){
-            outIndex = mid;
-            return true;
-        }
-        else if (targetPos < m_Spheres[mid].Position){
-            // search in left half
-            right = mid;
-        }
-        else {
-            left = mid+1;
-        }
-    }
-
-    outIndex = left;
-    return false;
-}
-
-void Chunk::SortSpheres() {
-    std::sort(m_Spheres.begin(), m_Spheres.end(),
-        [](const Sphere& a, const Sphere& b) {
-            return a.Position < b.Position;
-        });
+    // The cell's first sphere index comes from the offset table; its runs are found by a
+    // binary search bounded by that index, then walked up the target column.
+    return m_Spheres.Find(targetPos, outIndex);
 }
 
 void Chunk::ToString(std::string& outStr) const {
     std::format_to(std::back_inserter(outStr), "Chunk [{}, {}] - Total Spheres: {} ;\n", 
-        m_Coordinates.X, m_Coordinates.Z, m_Spheres.size() );
+        m_Coordinates.X, m_Coordinates.Z, m_Spheres.GetSize() );
 
-    for (size_t i = 0; i < m_Spheres.size(); ++i) {
-        std::format_to(std::back_inserter(outStr), "  {}: \n", i);
-        m_Spheres[i].ToString(outStr);
+    for (auto it = m_Spheres.begin(); it != m_Spheres.end(); ++it) {
+        std::format_to(std::back_inserter(outStr), "  {}: \n", it.GetIndex());
+        it->ToString(outStr);
     }
 }
 
 void Chunk::Serialize(std::vector<uint8_t>& buffer){
     // Key(8) | ChunkSize(4) | Payload(chunkSize bytes)
-    // Payload = BBox(24) | SphereCount(4) | Spheres..
-
-    // ChunkPosition(8) | chunkSize(4) | BBOX(24) | SphereCount(4) | Spheres...
-    const uint32_t chunkSize = sizeof(BoundBox) + sizeof(uint32_t) + m_Spheres.size() * sizeof(Sphere);
+    // Payload = BBox(24) | SphereCount(4) | ShadedCount(4) | Spheres.. | Shading..
+    // SphereCount carries COMPACT_RECORDS; without it the payload is the older
+    // BBox(24) | SphereCount(4) | full 26-byte Sphere records.
+
+    // ChunkPosition(8) | chunkSize(4) | BBOX(24) | SphereCount(4) | ShadedCount(4) | Spheres... | Shading...
+    const uint32_t shadedCount = static_cast<uint32_t>(m_Spheres.GetShading().size());
+    const uint32_t chunkSize = sizeof(BoundBox) + 2 * sizeof(uint32_t)
+                             + m_Spheres.GetSize() * SphereColumns::RECORD_SIZE
+                             + shadedCount * sizeof(SphereColumns::ShadedSphere);
     const uint32_t byteSize = sizeof(uint64_t) + sizeof(chunkSize) + chunkSize;
     
     // create sufficient space
@@ -339,18 +521,23 @@ void Chunk::Serialize(std::vector<uint8_t>& buffer){
     std::memcpy(ptr, &m_Bounds, sizeof(m_Bounds));
     ptr += sizeof(m_Bounds);
 
-    // copy sphere count
-    const uint32_t sphereCount = static_cast<uint32_t>(m_Spheres.size());
+    // copy sphere count, flagged as compact records, and shading table size
+    const uint32_t sphereCount = m_Spheres.GetSize() | COMPACT_RECORDS;
     std::memcpy(ptr, &sphereCount, sizeof(sphereCount));
     ptr += sizeof(sphereCount);
+    std::memcpy(ptr, &shadedCount, sizeof(shadedCount));
+    ptr += sizeof(shadedCount);
 
-    // copy spheres
-    std::memcpy(ptr, m_Spheres.data(), m_Spheres.size() * sizeof(Sphere));
+    // copy spheres, expanded from the runs to the on-disk records, then the shading table
+    m_Spheres.WriteRecords(ptr);
+    ptr += m_Spheres.GetSize() * SphereColumns::RECORD_SIZE;
+    m_Spheres.WriteShading(ptr);
 }
 
 void Chunk::Deserialize(const std::vector<uint8_t>& buffer, uint64_t offset){
     // Key(8) | ChunkSize(4) | Payload(chunkSize bytes)
-    // Payload = BBox(24) | SphereCount(4) | Spheres..
+    // Payload = BBox(24) | SphereCount(4) | ShadedCount(4) | Spheres.. | Shading..  (COMPACT_RECORDS set)
+    //         = BBox(24) | SphereCount(4) | Spheres..                              (older saves)
 
     const uint8_t *ptr = buffer.data();
     ptr += offset;
@@ -380,7 +567,39 @@ void Chunk::Deserialize(const std::vector<uint8_t>& buffer, uint64_t offset){
     std::memcpy(&sphereCount, ptr, sizeof(sphereCount));
     ptr += sizeof(sphereCount);
 
-    // read spheres
-    m_Spheres.resize(sphereCount);
-    std::memcpy(m_Spheres.data(), ptr, sizeof(Sphere) * sphereCount);
+    const bool compact = (sphereCount & COMPACT_RECORDS) != 0;
+    sphereCount &= ~COMPACT_RECORDS;
+    uint32_t shadedCount = 0;
+    if (compact) {
+        std::memcpy(&shadedCount, ptr, sizeof(shadedCount));
+        ptr += sizeof(shadedCount);
+    }
+
+    // read spheres back into runs; saves are sorted, anything out of order is inserted
+    m_Spheres.Clear();
+    for (uint32_t i = 0; i < sphereCount; ++i) {
+        Sphere sphere;
+        if (compact) {
+            // no shading here: the table follows, and the sphere's AO and lights stay zero
+            SphereColumns::ReadRecord(ptr, sphere.ChunkTypeAndFlags, sphere.Position);
+            ptr += SphereColumns::RECORD_SIZE;
+        } else {
+            std::memcpy(&sphere, ptr, sizeof(Sphere));
+            ptr += sizeof(Sphere);
+        }
+
+        // Saved before materials existed: height bands only.
+        if (sphere.GetMaterial() == TerrainMaterial::NONE)
+            sphere.SetMaterial(TerrainMaterial::FromHeight(sphere.Position.DiscreteHeight * SPHERE_RADIUS));
+        const bool appended = compact ? m_Spheres.Append(sphere.Position, sphere.ChunkTypeAndFlags)
+                                      : m_Spheres.Append(sphere);
+        if (!appended) m_Spheres.Insert(sphere);
+    }
+    for (uint32_t i = 0; i < shadedCount; ++i) {
+        SphereColumns::ShadedSphere entry;
+        std::memcpy(&entry, ptr, sizeof(entry));
+        ptr += sizeof(entry);
+        m_Spheres.SetShading(entry);
+    }
+    m_Spheres.ShrinkToFit();
 }
\ No newline at end of file
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "physics/bound_box.hpp"
+#include "world/scatter_layer.hpp"
 #include "world/sphere.hpp"
+#include "world/sphere_columns.hpp"
 #include "world/config.hpp"
 
 #include <array>
 #include <cstdint>
+#include <limits>
+#include <span>
 #include <vector>
 #include <string>
 
@@ -44,6 +48,13 @@ struct GPUBufferInfo { // Holds the info about where this chunk located in the g
     uint32_t Count = 0;
 };
 
+// What a Chunk::ApplyEdits batch did.
+struct ChunkEditReport {
+    uint32_t Added   = 0; // Add edits that took effect (no sphere was there)
+    uint32_t Removed = 0; // Remove edits that took effect
+    SphereColumns::CellMask TouchedCells; // cells whose column changed, bit z * CHUNK_SIZE + x
+};
+
 // All LOD levels for one chunk, stored back-to-back in a single buffer.
 // data layout: [LOD0 spheres][LOD1 spheres][LOD2 spheres][LOD3 spheres]
 struct ChunkLODSet {
@@ -52,6 +63,14 @@ struct ChunkLODSet {
     std::array<uint32_t, LOD_LEVELS>    lodCounts{};
 };
 
+// One LOD block rewritten by Chunk::UpdateLODs: the new value of
+// data[lodOffsets[Level] + Index], for a range write into the uploaded slab.
+struct LODPatch {
+    uint32_t      Level;
+    uint32_t      Index; // within the level
+    CompactSphere Sphere;
+};
+
 // --- Chunk Class ---
 class Chunk {
 public:
@@ -73,8 +92,16 @@ public:
     // Core Data
     bool AddSphere(const Sphere& sphere);
     bool RemoveSphere(const SpherePosition targetPos);
+    // Batched AddSphere / RemoveSphere: sorts the edits (a sphere's own edits keep their
+    // order) and merges them in one pass over the spheres, O(spheres + edits log edits)
+    // instead of O(spheres) per edit. Bounds are recalculated and IsDirty set once, and
+    // only if something changed; no warnings for edits that did nothing.
+    ChunkEditReport ApplyEdits(std::span<const SphereEdit> edits);
+    // AO and lights of an existing sphere; all zero clears them. Kept in a sparse table,
+    // see SphereColumns::GetShading.
+    bool SetShading(const SpherePosition pos, uint16_t ambientOcclusion, const std::array<LightVector, 6>& lights);
     
-    // Find range of spheres in a specific cell (x, z)
+    // Find range of spheres in a specific cell (x, z), O(1) from the cell offset table
     bool GetCell(uint8_t x, uint8_t z, uint32_t &outOffset, uint32_t &outSize) const;
 
     // accomplish binary search and if find the sphere returns true, else false and update outIndex
@@ -98,19 +125,56 @@ public:
 
     // Builds all LOD_LEVELS compact LOD meshes from current sphere data.
     // Idempotent. Call after generation/deserialization, before the renderer needs LODs.
+    // No-op on LOD-only chunks (there is no sphere data to build from).
     void GenerateLODs();
 
+    // Brings the LODs up to date with the cells edited since the last GenerateLODs /
+    // UpdateLODs, recomputing only the blocks over them: one block per level per cell.
+    // Blocks whose sphere changed are rewritten and appended to outPatches. Returns false
+    // when a block appeared or vanished - the level's layout shifted, so everything was
+    // regenerated, nothing appended, and the whole slab has to be uploaded again.
+    bool UpdateLODs(std::vector<LODPatch>& outPatches);
+    bool HasStaleLODs() const { return m_LODDirty.any(); }
+
+    // Installs LODs sampled straight from the terrain (ChunkGenerator::GenerateLODOnly).
+    // The chunk then holds no spheres: it can be drawn by the LO pipeline only and
+    // has to be regenerated at full detail before HQ upload or editing.
+    // omittedWavelength: longest noise octave left out of the samples (0 = none).
+    void SetLODOnly(ChunkLODSet&& lods, float omittedWavelength = 0.0f);
+    bool IsLODOnly() const { return m_LODOnly; }
+    float GetOmittedWavelength() const { return m_OmittedWavelength; }
+
+    // Surface height: DiscreteHeight of the top sphere of the cell column, read from the
+    // last run of the cell, so edits show at once. Columns without a sphere (odd cells
+    // skipped on flat ground, or dug out) take the highest cardinal neighbour inside the
+    // chunk; NO_SURFACE if there is none. LOD-only chunks answer from LOD1, one height
+    // per 2x2 cell block. Nothing is cached: safe from any thread that may read the chunk.
+    static constexpr int16_t NO_SURFACE = std::numeric_limits<int16_t>::min();
+    int16_t GetSurfaceHeight(uint8_t x, uint8_t z) const;
+
     // Getters
     const BoundBox& GetBounds() const { return m_Bounds; }
     BoundBox& GetBounds() { return m_Bounds; } // Mutable accessor for updates
 
-    uint32_t GetSize() const {return m_Spheres.size();}
+    uint32_t GetSize() const {return m_Spheres.GetSize();}
     const ChunkCoordinates& GetCoordinates() const { return m_Coordinates; }
-    std::vector<Sphere>& GetSpheres() { return m_Spheres; }
-    const std::vector<Sphere>& GetSpheres() const { return m_Spheres; }
+    SphereColumns& GetSpheres() { return m_Spheres; }
+    const SphereColumns& GetSpheres() const { return m_Spheres; }
     const ChunkLODSet& GetLODs() const { return m_LODs; }
 
+    // RAM held for the spheres (runs and shading), see SphereColumns.
+    size_t GetSphereMemory() const { return m_Spheres.GetMemoryUsage(); }
+
+    // Trees and boulders standing on the chunk (ScatterLayer::Populate). Derived from
+    // the spheres and the seed, never serialized: set again whenever the chunk is loaded.
+    // Edits drop the instances standing on the cells they change; ChunkGenerator::Scatter
+    // places the full set again (e.g. a tree on a column that was built back up).
+    const std::vector<ScatterInstance>& GetScatter() const { return m_Scatter; }
+    void SetScatter(std::vector<ScatterInstance>&& instances) { m_Scatter = std::move(instances); }
+
     // Serializer
+    // Set in the saved sphere count: compact records plus a shading table (see Serialize).
+    static constexpr uint32_t COMPACT_RECORDS = 0x80000000u;
     void Serialize(std::vector<uint8_t>& buffer);
     void Deserialize(const std::vector<uint8_t>& buffer, uint64_t offset);
 
@@ -119,12 +183,17 @@ public:
     bool IsDirty = false; // indicates that the chunk has updated so it needs to be saved to disk
 
 private:
-    // Helper to keep spheres sorted by LocalIndex then Height for binary search
-    void SortSpheres();
+    // Top sphere of a cell column, NO_SURFACE if the cell has none.
+    int16_t GetColumnTop(uint32_t x, uint32_t z) const;
+    // Removes the scatter instances whose candidate cell is set in cells.
+    void DropScatter(const SphereColumns::CellMask& cells);
 
-private:
     ChunkCoordinates m_Coordinates;
     BoundBox m_Bounds;
-    std::vector<Sphere> m_Spheres;
+    SphereColumns m_Spheres; // sorted by CellIndex then height, as column runs
     ChunkLODSet m_LODs;
+    std::vector<ScatterInstance> m_Scatter; // never serialized
+    bool m_LODOnly = false; // LODs only, no spheres (never serialized)
+    float m_OmittedWavelength = 0.0f; // LOD-only: detail octaves left out (never serialized)
+    SphereColumns::CellMask m_LODDirty; // cells edited since the LODs were built
 };
\ No newline at end of file
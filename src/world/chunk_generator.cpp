@@ -1,7 +1,23 @@
 #include "world/chunk_generator.hpp"
 #include "world/chunk.hpp"
+#include "world/gen_profiler.hpp"
+#include "world/terrain_material.hpp"
 
-ChunkGenerator::ChunkGenerator(const Seed256& seed) : m_TerrainGen(seed) {}
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+ChunkGenerator::ChunkGenerator(const Seed256& seed, TerrainSampling sampling, TerrainNoise noise,
+                               TerrainErosion erosion, TerrainDensity density)
+    : m_TerrainGen(seed, sampling, noise), m_ErosionMode(erosion), m_Erosion(m_TerrainGen),
+      m_DensityMode(density), m_Density(m_TerrainGen), m_Scatter(m_TerrainGen) {}
 
 void ChunkGenerator::Generate(Chunk& chunk) const {
     HeightMap heightMap;
@@ -10,27 +26,304 @@ void ChunkGenerator::Generate(Chunk& chunk) const {
     FillChunk(chunk, heightMap);
 }
 
+void ChunkGenerator::GenerateTile(Chunk* const* chunks, size_t count) const {
+    if (count == 0) return;
+
+    // --- 1. Bounding rectangle of the set, in chunks ---
+    int32_t minX = chunks[0]->GetCoordinates().X, maxX = minX;
+    int32_t minZ = chunks[0]->GetCoordinates().Z, maxZ = minZ;
+    for (size_t i = 1; i < count; ++i) {
+        const ChunkCoordinates& c = chunks[i]->GetCoordinates();
+        minX = std::min(minX, c.X); maxX = std::max(maxX, c.X);
+        minZ = std::min(minZ, c.Z); maxZ = std::max(maxZ, c.Z);
+    }
+    const size_t width  = static_cast<size_t>(maxX - minX + 1) * CHUNK_SIZE + 2;
+    const size_t height = static_cast<size_t>(maxZ - minZ + 1) * CHUNK_SIZE + 2;
+
+    // A lone chunk keeps the halo cache path; a sparse set would sample more than it saves.
+    constexpr size_t CHUNK_SAMPLES = (CHUNK_SIZE + 2) * (CHUNK_SIZE + 2);
+    if (count == 1 || width * height > count * CHUNK_SAMPLES) {
+        for (size_t i = 0; i < count; ++i) Generate(*chunks[i]);
+        return;
+    }
+
+    // --- 2. One grid for the whole rectangle, starting one cell before its first chunk ---
+    std::vector<float>   grid(width * height);
+    std::vector<uint8_t> materials(width * height);
+    {
+        GEN_PROFILE_SCOPE(GenProfiler::Stage::HeightMap, count);
+        m_TerrainGen.GetHeightGrid((minX * static_cast<int32_t>(CHUNK_SIZE) - 1) * SPHERE_RADIUS,
+                                   (minZ * static_cast<int32_t>(CHUNK_SIZE) - 1) * SPHERE_RADIUS,
+                                   SPHERE_RADIUS, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                                   grid.data(), materials.data());
+    }
+    Erode((minX * static_cast<int32_t>(CHUNK_SIZE) - 1) * SPHERE_RADIUS,
+          (minZ * static_cast<int32_t>(CHUNK_SIZE) - 1) * SPHERE_RADIUS,
+          SPHERE_RADIUS, static_cast<uint32_t>(width), static_cast<uint32_t>(height), grid.data(), width, count);
+
+    // --- 3. Each chunk reads its (CHUNK_SIZE+2)^2 window ---
+    for (size_t i = 0; i < count; ++i) {
+        const ChunkCoordinates& c = chunks[i]->GetCoordinates();
+        const size_t offsetX = static_cast<size_t>(c.X - minX) * CHUNK_SIZE;
+        const size_t offsetZ = static_cast<size_t>(c.Z - minZ) * CHUNK_SIZE;
+
+        HeightMap heightMap;
+        const size_t offset = offsetZ * width + offsetX;
+        {
+            GEN_PROFILE_SCOPE(GenProfiler::Stage::HeightMap, 0); // counted with the grid
+            DiscretizeHeightMap(grid.data() + offset, materials.data() + offset, width, heightMap);
+        }
+        InitBounds(*chunks[i], heightMap);
+        FillChunk(*chunks[i], heightMap);
+    }
+}
+
+void ChunkGenerator::GenerateLODOnly(Chunk& chunk, float minWavelength) const {
+    constexpr int32_t BLOCKS = CHUNK_SIZE / 2; // LOD1 blocks per side
+    static_assert(LOD_LEVELS == 4, "LOD-only layout assumes LOD0..LOD3");
+
+    const ChunkCoordinates& coords = chunk.GetCoordinates();
+    const int32_t baseX = coords.X * static_cast<int32_t>(CHUNK_SIZE);
+    const int32_t baseZ = coords.Z * static_cast<int32_t>(CHUNK_SIZE);
+
+    // --- 1. One sample at the centre of each 2x2 cell block ---
+    float   samples[BLOCKS * BLOCKS];
+    uint8_t sampleMaterials[BLOCKS * BLOCKS];
+    {
+        GEN_PROFILE_SCOPE(GenProfiler::Stage::HeightMap, 1);
+        m_TerrainGen.GetHeightGrid((baseX + 0.5f) * SPHERE_RADIUS, (baseZ + 0.5f) * SPHERE_RADIUS,
+                                   2 * SPHERE_RADIUS, BLOCKS, BLOCKS, samples, sampleMaterials, minWavelength);
+    }
+    Erode((baseX + 0.5f) * SPHERE_RADIUS, (baseZ + 0.5f) * SPHERE_RADIUS, 2 * SPHERE_RADIUS,
+          BLOCKS, BLOCKS, samples, BLOCKS);
+
+    // Discretised like a surface cell so the levels sit where GenerateLODs would put them.
+    float lod1[BLOCKS * BLOCKS];
+    float minY = samples[0], maxY = samples[0];
+    for (int32_t bz = 0; bz < BLOCKS; ++bz) {
+        for (int32_t bx = 0; bx < BLOCKS; ++bx) {
+            const float h = Discretize(samples[bz * BLOCKS + bx], 2 * bz, 2 * bx) * SPHERE_RADIUS;
+            lod1[bz * BLOCKS + bx] = h;
+            minY = std::min(minY, h);
+            maxY = std::max(maxY, h);
+        }
+    }
+
+    // --- 2. LOD1 from the samples, LOD2 / LOD3 by averaging 2x2 blocks of the level below ---
+    // A merged block keeps the material of the sub-block nearest to its averaged height.
+    GEN_PROFILE_SCOPE(GenProfiler::Stage::LODs, 1);
+    ChunkLODSet lods;
+    lods.data.reserve(BLOCKS * BLOCKS + (BLOCKS / 2) * (BLOCKS / 2) + (BLOCKS / 4) * (BLOCKS / 4));
+
+    float   level[BLOCKS * BLOCKS];
+    uint8_t levelMaterial[BLOCKS * BLOCKS];
+    int32_t side = BLOCKS;
+    std::copy(std::begin(lod1), std::end(lod1), level);
+    std::copy(std::begin(sampleMaterials), std::end(sampleMaterials), levelMaterial);
+    for (uint32_t lod = 1; lod < LOD_LEVELS; ++lod) {
+        const uint32_t blockSize = 1u << lod;
+        if (lod > 1) {
+            const int32_t prev = side;
+            side /= 2;
+            for (int32_t z = 0; z < side; ++z) {
+                for (int32_t x = 0; x < side; ++x) {
+                    const int32_t sub[4] = { (2 * z) * prev + 2 * x,     (2 * z) * prev + 2 * x + 1,
+                                             (2 * z + 1) * prev + 2 * x, (2 * z + 1) * prev + 2 * x + 1 };
+                    const float avg = (level[sub[0]] + level[sub[1]] + level[sub[2]] + level[sub[3]]) * 0.25f;
+                    int32_t nearest = sub[0];
+                    for (int32_t k = 1; k < 4; ++k)
+                        if (std::abs(level[sub[k]] - avg) < std::abs(level[nearest] - avg)) nearest = sub[k];
+                    levelMaterial[z * side + x] = levelMaterial[nearest];
+                    level[z * side + x]         = avg;
+                }
+            }
+        }
+
+        lods.lodOffsets[lod] = static_cast<uint32_t>(lods.data.size());
+        for (int32_t bz = 0; bz < side; ++bz) {
+            for (int32_t bx = 0; bx < side; ++bx) {
+                CompactSphere cs{};
+                cs.lx      = static_cast<int16_t>(2u * bx * blockSize + blockSize - 1u);
+                cs.ly      = static_cast<int16_t>(std::lround(2.0f * level[bz * side + bx] / SPHERE_RADIUS));
+                cs.lz      = static_cast<int16_t>(2u * bz * blockSize + blockSize - 1u);
+                cs.lodStep = static_cast<uint8_t>(blockSize);
+                cs.color   = levelMaterial[bz * side + bx];
+                lods.data.push_back(cs);
+            }
+        }
+        lods.lodCounts[lod] = static_cast<uint32_t>(side * side);
+    }
+    lods.lodOffsets[0] = lods.lodOffsets[1];
+    lods.lodCounts[0]  = lods.lodCounts[1];
+
+    // --- 3. Bounds: same XZ as InitBounds, Y from the sampled surface ---
+    BoundBox& bounds = chunk.GetBounds();
+    bounds.m_Min.x = SPHERE_RADIUS * static_cast<float>(baseX - 1);
+    bounds.m_Min.z = SPHERE_RADIUS * static_cast<float>(baseZ - 1);
+    bounds.m_Max.x = SPHERE_RADIUS * static_cast<float>(baseX + static_cast<int32_t>(CHUNK_SIZE));
+    bounds.m_Max.z = SPHERE_RADIUS * static_cast<float>(baseZ + static_cast<int32_t>(CHUNK_SIZE));
+    bounds.m_Min.y = minY - SPHERE_RADIUS;
+    bounds.m_Max.y = maxY + SPHERE_RADIUS;
+
+    chunk.SetLODOnly(std::move(lods), m_TerrainGen.GetOmittedWavelength(minWavelength));
+}
+
+void ChunkGenerator::GetSurfaceHeights(const int32_t* cellXs, const int32_t* cellZs, int16_t* out,
+                                       size_t count) const {
+    std::vector<float> xs(count), zs(count), heights(count);
+    for (size_t i = 0; i < count; ++i) {
+        xs[i] = static_cast<float>(cellXs[i]) * SPHERE_RADIUS;
+        zs[i] = static_cast<float>(cellZs[i]) * SPHERE_RADIUS;
+    }
+    m_TerrainGen.GetHeights(xs.data(), zs.data(), heights.data(), count);
+    if (m_ErosionMode == TerrainErosion::Hydraulic) {
+        GEN_PROFILE_SCOPE(GenProfiler::Stage::Erosion, 0);
+        m_Erosion.ApplyPoints(xs.data(), zs.data(), heights.data(), count);
+    }
+
+    // Parity is taken from the chunk-local cell, as in FillChunk.
+    constexpr int32_t CS = CHUNK_SIZE;
+    for (size_t i = 0; i < count; ++i)
+        out[i] = Discretize(heights[i], ((cellZs[i] % CS) + CS) % CS, ((cellXs[i] % CS) + CS) % CS);
+}
+
+void ChunkGenerator::Scatter(Chunk& chunk) const {
+    GEN_PROFILE_SCOPE(GenProfiler::Stage::Scatter, 1);
+    std::vector<ScatterInstance> instances;
+    m_Scatter.Populate(chunk, instances);
+    chunk.SetScatter(std::move(instances));
+}
+
+int16_t ChunkGenerator::Discretize(float height, int32_t localZ, int32_t localX) noexcept {
+    int16_t discrY = static_cast<int16_t>(height / SPHERE_RADIUS);
+
+    // even layers like (x+z)=0,2,4 can have even number of multiples of sphereRadius
+    // however odd layers has to be odd number of multiples of sphereRadius 
+    discrY -= static_cast<int16_t>((localZ + localX + discrY) % 2);
+    return discrY;
+}
+
 void ChunkGenerator::GenerateHeightMap(const ChunkCoordinates& coords, HeightMap& outMap) const {
+    GEN_PROFILE_SCOPE(GenProfiler::Stage::HeightMap, 1);
     // generate [-1+x, x+1] height map
+    constexpr int32_t GRID  = CHUNK_SIZE + 2;
+    constexpr int32_t INNER = CHUNK_SIZE - 2; // cells not on any shared edge line
+    const float originX = (coords.X * static_cast<int32_t>(CHUNK_SIZE) - 1) * SPHERE_RADIUS;
+    const float originZ = (coords.Z * static_cast<int32_t>(CHUNK_SIZE) - 1) * SPHERE_RADIUS;
+
+    // --- 1. Shared edges ---
+    // Each edge holds two cell lines: one inner line of each chunk touching it.
+    // Edges already published by a neighbour are copied in and cost no noise.
+    struct EdgeRef {
+        ChunkCoordinates owner;     // west / north chunk of the edge
+        HaloCache::Side  side;
+        int32_t          firstLine; // local index of Lines[0] across the edge
+        bool             hit;
+        HaloCache::Edge  data;
+    };
+    EdgeRef edges[4] = {
+        { coords,                            HaloCache::Side::East,  CHUNK_SIZE - 1, false, {} },
+        { coords,                            HaloCache::Side::South, CHUNK_SIZE - 1, false, {} },
+        { ChunkCoordinates(coords.X - 1, coords.Z), HaloCache::Side::East,  -1, false, {} },
+        { ChunkCoordinates(coords.X, coords.Z - 1), HaloCache::Side::South, -1, false, {} },
+    };
+    // (z, x) of cell 'along' on line 'line' of an edge
+    auto edgeCell = [](const EdgeRef& e, int32_t line, int32_t along, int32_t& z, int32_t& x) {
+        const int32_t across = e.firstLine + line;
+        if (e.side == HaloCache::Side::East) { x = across; z = along - 1; }
+        else                                 { z = across; x = along - 1; }
+    };
+
+    float   heights[GRID * GRID];
+    uint8_t materials[GRID * GRID];
+    bool    known[GRID * GRID] = {};
+    for (EdgeRef& e : edges) {
+        e.hit = m_Halo.Take(e.owner, e.side, e.data);
+        if (!e.hit) continue;
+        for (int32_t line = 0; line < 2; ++line) {
+            for (int32_t along = 0; along < GRID; ++along) {
+                int32_t z, x;
+                edgeCell(e, line, along, z, x);
+                heights[(z + 1) * GRID + (x + 1)]   = e.data.Lines[line][along];
+                materials[(z + 1) * GRID + (x + 1)] = e.data.Materials[line][along];
+                known[(z + 1) * GRID + (x + 1)]     = true;
+            }
+        }
+    }
 
+    // --- 2. Interior ---
+    float   inner[INNER * INNER];
+    uint8_t innerMaterials[INNER * INNER];
+    m_TerrainGen.GetHeightGrid(originX + 2 * SPHERE_RADIUS, originZ + 2 * SPHERE_RADIUS, SPHERE_RADIUS,
+                               INNER, INNER, inner, innerMaterials);
+    for (int32_t z = 0; z < INNER; z++){
+        for (int32_t x = 0; x < INNER; x++){
+            heights[(z + 2) * GRID + (x + 2)]   = inner[z * INNER + x];
+            materials[(z + 2) * GRID + (x + 2)] = innerMaterials[z * INNER + x];
+            known[(z + 2) * GRID + (x + 2)]     = true;
+        }
+    }
+
+    // --- 3. Edge cells no neighbour has published yet ---
+    constexpr int32_t EDGE_CELLS = GRID * GRID - INNER * INNER;
+    float   xs[EDGE_CELLS], zs[EDGE_CELLS], edgeHeights[EDGE_CELLS];
+    uint8_t edgeMaterials[EDGE_CELLS];
+    int32_t cells[EDGE_CELLS];
+    int32_t count = 0;
+    for (int32_t i = 0; i < GRID * GRID; ++i) {
+        if (known[i]) continue;
+        xs[count]    = originX + static_cast<float>(i % GRID) * SPHERE_RADIUS;
+        zs[count]    = originZ + static_cast<float>(i / GRID) * SPHERE_RADIUS;
+        cells[count] = i;
+        ++count;
+    }
+    m_TerrainGen.GetHeights(xs, zs, edgeHeights, static_cast<size_t>(count), edgeMaterials);
+    for (int32_t k = 0; k < count; ++k) {
+        heights[cells[k]]   = edgeHeights[k];
+        materials[cells[k]] = edgeMaterials[k];
+    }
+
+    // --- 4. Publish the edges we computed for the neighbours that still need them ---
+    for (EdgeRef& e : edges) {
+        if (e.hit) continue;
+        for (int32_t line = 0; line < 2; ++line) {
+            for (int32_t along = 0; along < GRID; ++along) {
+                int32_t z, x;
+                edgeCell(e, line, along, z, x);
+                e.data.Lines[line][along]     = heights[(z + 1) * GRID + (x + 1)];
+                e.data.Materials[line][along] = materials[(z + 1) * GRID + (x + 1)];
+            }
+        }
+        m_Halo.Store(e.owner, e.side, e.data);
+    }
+
+    // The halo carries noise heights; each chunk erodes its own copy (the offset is a
+    // function of the position only, so both sides of an edge agree).
+    Erode(originX, originZ, SPHERE_RADIUS, GRID, GRID, heights, GRID);
+    DiscretizeHeightMap(heights, materials, GRID, outMap);
+}
+
+void ChunkGenerator::Erode(float originX, float originZ, float step, uint32_t width, uint32_t height,
+                           float* heights, size_t stride, [[maybe_unused]] size_t chunks) const {
+    if (m_ErosionMode != TerrainErosion::Hydraulic) return;
+    GEN_PROFILE_SCOPE(GenProfiler::Stage::Erosion, chunks);
+    m_Erosion.ApplyGrid(originX, originZ, step, width, height, heights, stride);
+}
+
+void ChunkGenerator::DiscretizeHeightMap(const float* heights, const uint8_t* materials, size_t stride,
+                                         HeightMap& outMap) {
     // find terrain discrete hight map
-    for (int32_t z = -1; z < CHUNK_SIZE+1; z++){
-        float zWorld = (z + coords.Z * static_cast<int32_t>(CHUNK_SIZE)) * SPHERE_RADIUS;
-
-        for (int32_t x = -1; x < CHUNK_SIZE+1; x++){
-            float xWorld = (x + coords.X * static_cast<int32_t>(CHUNK_SIZE)) * SPHERE_RADIUS;
-            float height = m_TerrainGen.GetHeight(xWorld , zWorld);
-            int16_t discrY = static_cast<int16_t>(height / SPHERE_RADIUS);
-
-            // even layers like (x+z)=0,2,4 can have even number of multiples of sphereRadius
-            // however odd layers has to be odd number of multiples of sphereRadius 
-            discrY -= static_cast<int16_t>((z + x + discrY) % 2);
-            outMap.SetHeight(z, x, discrY);
+    for (int32_t z = -1; z < CHUNK_SIZE+1; z++) {
+        for (int32_t x = -1; x < CHUNK_SIZE+1; x++) {
+            const size_t i = static_cast<size_t>(z + 1) * stride + (x + 1);
+            outMap.SetHeight(z, x, Discretize(heights[i], z, x));
+            outMap.SetMaterial(z, x, materials[i]);
         }
     }
 }
 
 void ChunkGenerator::InitBounds(Chunk& chunk, const HeightMap& heightMap) const {
+    GEN_PROFILE_SCOPE(GenProfiler::Stage::Bounds, 1);
     const ChunkCoordinates& coords = chunk.GetCoordinates();
     const int32_t baseX = coords.X * static_cast<int32_t>(CHUNK_SIZE);
     const int32_t baseZ = coords.Z * static_cast<int32_t>(CHUNK_SIZE);
@@ -47,61 +340,254 @@ void ChunkGenerator::InitBounds(Chunk& chunk, const HeightMap& heightMap) const
 }
 
 
-void ChunkGenerator::FillChunk(Chunk& chunk, const HeightMap& heightMap) const {
-    // 8 neighbours (z, x); up, left, rigt, down, diagonals
-    constexpr int8_t NEIGHBOURS[8][2] = {
-        {-1,  0}, { 0, -1}, { 0,  1}, { 1,  0},  // cardinal // up, left, right, down
-        {-1, -1}, {-1,  1}, { 1, -1}, { 1,  1}   // diagonal // top left, top right, bottom left, bottom right 
+namespace {
+    struct ColumnStats {
+        size_t  Total = 0;                                   // spheres over the chunk
+        int32_t MinY  = std::numeric_limits<int32_t>::max(); // lowest sphere bottom / SPHERE_RADIUS
+        int32_t MaxY  = std::numeric_limits<int32_t>::min(); // highest sphere top / SPHERE_RADIUS
     };
 
-    chunk.GetSpheres().reserve(CHUNK_SIZE * CHUNK_SIZE * 2);
+    // CountColumns a row at a time: a 16-cell row is two 8-lane registers.
+#if defined(__SSE2__)
+    ColumnStats CountColumnsSSE2(const HeightMap& heightMap, int16_t* counts) {
+        ColumnStats stats;
+        static_assert(CHUNK_SIZE % 8 == 0, "rows are processed 8 cells per register");
+        const __m128i one     = _mm_set1_epi16(1);
+        const __m128i oddLane = _mm_set_epi16(-1, 0, -1, 0, -1, 0, -1, 0); // x odd
+        __m128i vMin   = _mm_set1_epi16(std::numeric_limits<int16_t>::max());
+        __m128i vMax   = _mm_set1_epi16(std::numeric_limits<int16_t>::min());
+        __m128i vTotal = _mm_setzero_si128();
 
-    for (int32_t z = 0; z < CHUNK_SIZE; z++){ // iterate over z axis
-        for (int32_t x = 0; x < CHUNK_SIZE; x++){ // iterate over x axis
-            const int16_t centerY = heightMap.GetHeight(z, x);
+        for (int32_t z = 0; z < CHUNK_SIZE; z++) {
+            const int16_t* up   = heightMap.GetRow(z - 1) + 1;
+            const int16_t* row  = heightMap.GetRow(z);
+            const int16_t* down = heightMap.GetRow(z + 1) + 1;
+            // Odd layer: (z + x) odd, i.e. odd x on even rows and even x on odd ones.
+            const __m128i oddMask = (z & 1) ? _mm_xor_si128(oddLane, _mm_set1_epi16(-1)) : oddLane;
 
-            // Odd-layer optimisation: skip if all 4 cardinal neighbours share this height
-            if ((z + x) % 2 == 1) {
-                const int16_t refY = heightMap.GetHeight(z + NEIGHBOURS[0][0], x + NEIGHBOURS[0][1]);
-                bool sameHight = true;
+            for (int32_t x = 0; x < CHUNK_SIZE; x += 8) {
+                const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 1 + x));
+                const __m128i n[4] = {
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + x)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 2 + x)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + x)),
+                };
 
-                // Check if 4 neighbour if they have same hight value then you don't need to append this sphere
-                for (int16_t k = 1; k < 4; k++){
-                    if (refY != heightMap.GetHeight(z+NEIGHBOURS[k][0], x+NEIGHBOURS[k][1])){
-                        sameHight = false;
-                        break;
-                    }
+                __m128i count = one;
+                __m128i same  = oddMask;
+                for (int32_t k = 0; k < 4; ++k) {
+                    count = _mm_max_epi16(count, _mm_sub_epi16(c, n[k]));
+                    if (k > 0) same = _mm_and_si128(same, _mm_cmpeq_epi16(n[0], n[k]));
                 }
-                if (sameHight) continue;
+                count = _mm_andnot_si128(same, count);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(counts + z * CHUNK_SIZE + x), count);
+
+                // Skipped lanes must not move the bounds: park them at the neutral extreme.
+                const __m128i lo = _mm_or_si128(_mm_and_si128(same, _mm_set1_epi16(std::numeric_limits<int16_t>::max())),
+                                                _mm_andnot_si128(same, _mm_sub_epi16(c, count)));
+                const __m128i hi = _mm_or_si128(_mm_and_si128(same, _mm_set1_epi16(std::numeric_limits<int16_t>::min())),
+                                                _mm_andnot_si128(same, _mm_add_epi16(c, one)));
+                vMin   = _mm_min_epi16(vMin, lo);
+                vMax   = _mm_max_epi16(vMax, hi);
+                vTotal = _mm_add_epi32(vTotal, _mm_madd_epi16(count, one));
             }
+        }
+
+        alignas(16) int16_t mins[8], maxs[8];
+        alignas(16) int32_t totals[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(mins), vMin);
+        _mm_store_si128(reinterpret_cast<__m128i*>(maxs), vMax);
+        _mm_store_si128(reinterpret_cast<__m128i*>(totals), vTotal);
+        for (int32_t i = 0; i < 8; ++i) {
+            stats.MinY = std::min<int32_t>(stats.MinY, mins[i]);
+            stats.MaxY = std::max<int32_t>(stats.MaxY, maxs[i]);
+        }
+        stats.Total = static_cast<size_t>(totals[0]) + totals[1] + totals[2] + totals[3];
+        return stats;
+    }
+#endif
+
+    ColumnStats CountColumnsScalar(const HeightMap& heightMap, int16_t* counts) {
+        ColumnStats stats;
+        for (int32_t z = 0; z < CHUNK_SIZE; z++) {
+            const int16_t* up   = heightMap.GetRow(z - 1) + 1;
+            const int16_t* row  = heightMap.GetRow(z);
+            const int16_t* down = heightMap.GetRow(z + 1) + 1;
+            for (int32_t x = 0; x < CHUNK_SIZE; x++) {
+                const int16_t c    = row[1 + x];
+                const int16_t n[4] = { up[x], row[x], row[2 + x], down[x] };
+
+                int16_t count = 1;
+                for (int32_t k = 0; k < 4; ++k) count = std::max<int16_t>(count, c - n[k]);
+                if ((z + x) % 2 == 1 && n[0] == n[1] && n[0] == n[2] && n[0] == n[3]) count = 0;
+                counts[z * CHUNK_SIZE + x] = count;
+
+                if (count == 0) continue;
+                stats.Total += static_cast<size_t>(count);
+                stats.MinY   = std::min<int32_t>(stats.MinY, c - count);
+                stats.MaxY   = std::max<int32_t>(stats.MaxY, c + 1);
+            }
+        }
+        return stats;
+    }
+
+#if defined(__SSE2__)
+    std::atomic<uint8_t> s_ColumnKernel{ static_cast<uint8_t>(ChunkGenerator::ColumnKernel::SSE2) };
+#else
+    std::atomic<uint8_t> s_ColumnKernel{ static_cast<uint8_t>(ChunkGenerator::ColumnKernel::Scalar) };
+#endif
+
+    // Spheres FillChunk emits per cell (z * CHUNK_SIZE + x) and their Y extent.
+    //   diff  = max(0, center - each cardinal neighbour)
+    //   count = max(diff, 1): the fills below the surface plus the surface itself
+    //   count = 0 on the odd BCC layer when all 4 cardinal neighbours share one height
+    ColumnStats CountColumns(const HeightMap& heightMap, int16_t* counts) {
+#if defined(__SSE2__)
+        if (ChunkGenerator::GetColumnKernel() == ChunkGenerator::ColumnKernel::SSE2)
+            return CountColumnsSSE2(heightMap, counts);
+#endif
+        return CountColumnsScalar(heightMap, counts);
+    }
+}
+
+ChunkGenerator::ColumnKernel ChunkGenerator::GetColumnKernel() noexcept {
+    return static_cast<ColumnKernel>(s_ColumnKernel.load(std::memory_order_relaxed));
+}
+
+void ChunkGenerator::SetColumnKernel(ColumnKernel kernel) noexcept {
+#if !defined(__SSE2__)
+    kernel = ColumnKernel::Scalar;
+#endif
+    s_ColumnKernel.store(static_cast<uint8_t>(kernel), std::memory_order_relaxed);
+}
+
+const char* ChunkGenerator::ColumnKernelName(ColumnKernel kernel) noexcept {
+    return kernel == ColumnKernel::SSE2 ? "sse2" : "scalar";
+}
+
+void ChunkGenerator::FillChunk(Chunk& chunk, const HeightMap& heightMap) const {
+    if (m_DensityMode == TerrainDensity::NarrowBand) {
+        NarrowBandDensity::Weights weights;
+        bool masked;
+        {
+            GEN_PROFILE_SCOPE(GenProfiler::Stage::Density, 1);
+            masked = m_Density.GetWeights(chunk.GetCoordinates(), heightMap.GetRow(-1), weights);
+        }
+        if (masked) {
+            FillBands(chunk, heightMap, weights);
+            return;
+        }
+    }
+    FillColumns(chunk, heightMap);
+}
+
+void ChunkGenerator::FillColumns(Chunk& chunk, const HeightMap& heightMap) const {
+    GEN_PROFILE_SCOPE(GenProfiler::Stage::Fill, 1);
+    // Pass 1: spheres per cell, a row of CHUNK_SIZE cells at a time.
+    std::array<int16_t, CHUNK_SIZE * CHUNK_SIZE> counts;
+    const ColumnStats stats = CountColumns(heightMap, counts.data());
+
+    // Pass 2: one run per non-empty cell, in cell order, into run arrays sized once.
+    SphereColumns& spheres = chunk.GetSpheres();
+    const uint32_t cells   = static_cast<uint32_t>(CHUNK_SIZE * CHUNK_SIZE - std::count(counts.begin(), counts.end(), 0));
+    spheres.Reserve(spheres.RunCount() + cells);
+
+    for (int32_t z = 0; z < CHUNK_SIZE; z++) {
+        const int16_t* row = heightMap.GetRow(z) + 1;
+        for (int32_t x = 0; x < CHUNK_SIZE; x++) {
+            const int16_t n = counts[z * CHUNK_SIZE + x];
+            if (n == 0) continue;
 
             // Fill every offset between the surface and the lowest cardinal neighbour so
             // adjacent column spheres overlap by 0.5 world units. Even offsets land on the
             // BCC lattice; odd ones do not - they exist purely to close the knife-edge gap
             // where two touching spheres meet at a single point (FP-precision pixel cracks).
-            int16_t cardinalMaxDiff = 0;
-            for (int8_t k = 0; k < 4; ++k) {
-                const int16_t diff = centerY - heightMap.GetHeight(z + NEIGHBOURS[k][0], x + NEIGHBOURS[k][1]);
-                if (diff > cardinalMaxDiff) cardinalMaxDiff = diff;
+            // The whole column is one run, from the surface down n spheres.
+            spheres.AppendRun(static_cast<uint16_t>(z * CHUNK_SIZE + x), row[x], static_cast<uint32_t>(n),
+                              heightMap.GetMaterial(z, x));
+        }
+    }
+
+    // Lowest sphere bottom / highest sphere top over the emitted columns.
+    if (stats.Total > 0) {
+        chunk.GetBounds().m_Min.y = std::min(SPHERE_RADIUS * stats.MinY, chunk.GetBounds().m_Min.y);
+        chunk.GetBounds().m_Max.y = std::max(SPHERE_RADIUS * stats.MaxY, chunk.GetBounds().m_Max.y);
+    }
+}
+
+void ChunkGenerator::FillBands(Chunk& chunk, const HeightMap& heightMap,
+                               const NarrowBandDensity::Weights& weights) const {
+    constexpr int32_t W          = NarrowBandDensity::WINDOW;
+    constexpr int32_t ROCK_DEPTH = 4; // discrete heights below the top where exposed walls turn to rock
+
+    const int16_t* tops = heightMap.GetRow(-1); // the whole window, row-major
+    std::array<uint64_t, W * W> bands;
+    {
+        GEN_PROFILE_SCOPE(GenProfiler::Stage::Density, 0); // counted with the weights
+        m_Density.GetBands(chunk.GetCoordinates(), tops, weights, bands.data());
+    }
+
+    GEN_PROFILE_SCOPE(GenProfiler::Stage::Fill, 1);
+    SphereColumns& spheres = chunk.GetSpheres();
+    int32_t minY = std::numeric_limits<int32_t>::max();
+    int32_t maxY = std::numeric_limits<int32_t>::min();
+
+    for (int32_t z = 0; z < CHUNK_SIZE; z++) {
+        for (int32_t x = 0; x < CHUNK_SIZE; x++) {
+            const int32_t c        = (z + 1) * W + (x + 1);
+            const int32_t n[4]     = { c - W, c - 1, c + 1, c + W };
+            const int16_t top      = tops[c];
+            const uint8_t material = heightMap.GetMaterial(z, x);
+
+            bool plain = bands[c] == NarrowBandDensity::PLAIN;
+            for (int32_t k = 0; k < 4; ++k) plain = plain && bands[n[k]] == NarrowBandDensity::PLAIN;
+
+            if (plain) {
+                // Same column FillColumns emits: surface down to the lowest cardinal
+                // neighbour, odd-layer cells skipped when all four neighbours agree.
+                int16_t count = 1;
+                for (int32_t k = 0; k < 4; ++k) count = std::max<int16_t>(count, top - tops[n[k]]);
+                if ((z + x) % 2 == 1 && tops[n[0]] == tops[n[1]] && tops[n[0]] == tops[n[2]] &&
+                    tops[n[0]] == tops[n[3]])
+                    continue;
+                spheres.AppendRun(static_cast<uint16_t>(z * CHUNK_SIZE + x), top, static_cast<uint32_t>(count),
+                                  material);
+                minY = std::min<int32_t>(minY, top - count);
+                maxY = std::max<int32_t>(maxY, top + 1);
+                continue;
             }
 
-            if (cardinalMaxDiff >= 2) {
-                const int16_t minY = centerY - (cardinalMaxDiff - 1);
-                chunk.GetBounds().m_Min.y = std::min(SPHERE_RADIUS * (minY - 1), chunk.GetBounds().m_Min.y);
+            // Every solid height with air above, below or in a cardinal column, lowest
+            // first. A neighbour can only be open from the bottom of its own band up.
+            int32_t lo = top;
+            for (int32_t k = 0; k < 4; ++k) lo = std::min<int32_t>(lo, tops[n[k]]);
+            lo -= NarrowBandDensity::BAND_BELOW;
+            const int32_t hi = top + NarrowBandDensity::BAND_ABOVE;
 
-                // Lowest first so the vector stays sorted ascending by height.
-                for (int16_t f = cardinalMaxDiff - 1; f >= 1; --f) {
-                    const int16_t fillY = centerY - f;
-                    chunk.GetSpheres().emplace_back(static_cast<uint8_t>(x), fillY, static_cast<uint8_t>(z));
-                }
+            for (int32_t y = lo; y <= hi; ++y) {
+                if (!NarrowBandDensity::IsSolid(bands[c], top, y)) continue;
+                const bool airAbove = !NarrowBandDensity::IsSolid(bands[c], top, y + 1);
+                const bool airBelow = !NarrowBandDensity::IsSolid(bands[c], top, y - 1);
+                bool exposed = airAbove || airBelow;
+                for (int32_t k = 0; k < 4 && !exposed; ++k)
+                    exposed = !NarrowBandDensity::IsSolid(bands[n[k]], tops[n[k]], y);
+                if (!exposed) continue;
+
+                // Undersides and walls well below the surface are bare rock.
+                const bool rock = airBelow || (!airAbove && y < top - ROCK_DEPTH);
+                spheres.AppendRun(static_cast<uint16_t>(z * CHUNK_SIZE + x), static_cast<int16_t>(y), 1,
+                                  rock ? TerrainMaterial::RockFace(y * SPHERE_RADIUS) : material);
+                minY = std::min(minY, y - 1);
+                maxY = std::max(maxY, y + 1);
             }
-            
-            // Insert the surface sphere
-            chunk.GetSpheres().emplace_back(static_cast<uint8_t>(x), centerY, static_cast<uint8_t>(z));
-            const float worldY = centerY * SPHERE_RADIUS;
-            // update min max bound box values again
-            chunk.GetBounds().m_Min.y = std::min(worldY - SPHERE_RADIUS, chunk.GetBounds().m_Min.y);
-            chunk.GetBounds().m_Max.y = std::max(worldY + SPHERE_RADIUS, chunk.GetBounds().m_Max.y);
         }
     }
-}
\ No newline at end of file
+
+    if (minY <= maxY) {
+        chunk.GetBounds().m_Min.y = std::min(SPHERE_RADIUS * minY, chunk.GetBounds().m_Min.y);
+        chunk.GetBounds().m_Max.y = std::max(SPHERE_RADIUS * maxY, chunk.GetBounds().m_Max.y);
+    }
+
+    spheres.ShrinkToFit(); // runs were appended one exposed sphere at a time
+}
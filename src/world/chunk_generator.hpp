@@ -1,9 +1,13 @@
 #pragma once
 
 #include "world/chunk.hpp"
+#include "world/halo_cache.hpp"
+#include "world/scatter_layer.hpp"
+#include "world/terrain_density.hpp"
+#include "world/terrain_erosion.hpp"
 #include "world/terrain_generator.hpp"
 
-class HeightMap { // (CHUNK_SIZE+2)^2 bytes
+class HeightMap { // (CHUNK_SIZE+2)^2 discrete heights and TerrainMaterials
 public:
     HeightMap() = default;
 
@@ -15,30 +19,114 @@ public:
         return m_HeightMap[localZ*(CHUNK_SIZE+2) + localX];
     }
     // The range is [-1, CHUNK_SIZE]
+    // Row localZ from localX = -1: CHUNK_SIZE+2 contiguous heights.
+    const int16_t* GetRow(int32_t localZ) const {
+        return &m_HeightMap[(localZ + 1)*(CHUNK_SIZE+2)];
+    }
     void SetHeight(int32_t localZ, int32_t localX, int16_t val){
         // mapping [-1, CHUNK_SIZE] -> [0, CHUNK_SIZE+1]
         localX += 1;
         localZ += 1;
         m_HeightMap[localZ*(CHUNK_SIZE+2) + localX] = val;
     }
+
+    // Same [-1, CHUNK_SIZE] range as the heights
+    uint8_t GetMaterial(int32_t localZ, int32_t localX) const {
+        return m_Material[(localZ + 1)*(CHUNK_SIZE+2) + (localX + 1)];
+    }
+    void SetMaterial(int32_t localZ, int32_t localX, uint8_t material) {
+        m_Material[(localZ + 1)*(CHUNK_SIZE+2) + (localX + 1)] = material;
+    }
 private:
     std::array<int16_t, (CHUNK_SIZE+2)*(CHUNK_SIZE+2)> m_HeightMap; // 2D int16_t map
+    std::array<uint8_t, (CHUNK_SIZE+2)*(CHUNK_SIZE+2)> m_Material;
 };
 
 // Generates the content of a single Chunk from terrain noise.
-// Stateless -- depends only on TerrainGenerator and chunk coordinates.
+// Output depends only on TerrainGenerator, the erosion mode and chunk coordinates;
+// the halo cache only lets neighbouring chunks share the edge samples they both need.
+// With TerrainErosion::Hydraulic the noise heights are offset by HydraulicErosion
+// before they are discretised (every path: full, tile, LOD-only and surface queries).
+// With TerrainDensity::NarrowBand, chunks where NarrowBandDensity's mask is set are
+// filled from its 3D bands (overhangs, caves) instead of plain columns; LOD-only
+// chunks and surface queries keep the heightfield.
 // Single Responsibility: knows how to fill a Chunk, nothing else.
+// Generate() is thread-safe.
 class ChunkGenerator {
 public:
-    explicit ChunkGenerator(const Seed256& seed);
+    explicit ChunkGenerator(const Seed256& seed, TerrainSampling sampling = TerrainSampling::Exact,
+                            TerrainNoise noise = TerrainNoise::Float,
+                            TerrainErosion erosion = TerrainErosion::None,
+                            TerrainDensity density = TerrainDensity::None);
 
     // Fills chunk with spheres derived from noise. Chunk must already have coordinates set.
     void Generate(Chunk& chunk) const;
 
+    // Generates several chunks from one height grid over their bounding rectangle
+    // ((w*CHUNK_SIZE+2) x (h*CHUNK_SIZE+2) samples), so chunks next to each other sample
+    // their shared edge lines once and the noise runs in a few large batches. Sets that
+    // are too sparse for that to pay off fall back to Generate() per chunk.
+    // Output is the same as Generate() on each chunk. Chunks must have distinct coordinates.
+    void GenerateTile(Chunk* const* chunks, size_t count) const;
+
+    // Far-ring mode: samples the terrain once per LOD1 block (8x8 per chunk instead of
+    // the 18x18 cell grid) and builds LOD1..LOD3 plus Y bounds, without any spheres.
+    // LOD0 aliases LOD1 - it is only drawn inside the HQ load range, where chunks are
+    // regenerated at full detail anyway. Result is marked Chunk::IsLODOnly().
+    // minWavelength > 0 skips the noise octaves shorter than that (see
+    // TerrainGenerator::GetHeightGrid); the chunk records what was left out.
+    void GenerateLODOnly(Chunk& chunk, float minWavelength = 0.0f) const;
+
+    // Surface height (DiscreteHeight) Generate() would give the cell columns at global
+    // cell coordinates (cellXs[i], cellZs[i]), without generating their chunks: the terrain
+    // is sampled at the cell centres in one batch and discretised like FillChunk does.
+    // This is the heightfield surface: NarrowBand overhangs are not included.
+    void GetSurfaceHeights(const int32_t* cellXs, const int32_t* cellZs, int16_t* out, size_t count) const;
+
+    // Replaces the chunk's scatter instances with those ScatterLayer places on its
+    // current spheres. For generated and loaded chunks alike; LOD-only chunks get none.
+    void Scatter(Chunk& chunk) const;
+
+    const TerrainGenerator& GetTerrain() const noexcept { return m_TerrainGen; }
+    TerrainErosion          GetErosion() const noexcept { return m_ErosionMode; }
+    TerrainDensity          GetDensity() const noexcept { return m_DensityMode; }
+
+    // FillChunk's column pass runs on SSE2 where the build targets it (the x86-64
+    // baseline) and as a scalar loop elsewhere; both emit the same spheres.
+    // SetColumnKernel(Scalar) forces the scalar loop for output checks (bench_world
+    // --verify); SSE2 requests fall back to Scalar on builds without it. Process-wide.
+    enum class ColumnKernel : uint8_t { Scalar, SSE2 };
+    static ColumnKernel GetColumnKernel() noexcept;
+    static void         SetColumnKernel(ColumnKernel kernel) noexcept;
+    static const char*  ColumnKernelName(ColumnKernel kernel) noexcept;
+
+    // Hit / miss counters of the shared chunk-edge cache.
+    HaloCache::Stats GetHaloStats() const { return m_Halo.GetStats(); }
+
 private:
     void GenerateHeightMap(const ChunkCoordinates& coords, HeightMap& outMap) const ;
+    // Discretises the (CHUNK_SIZE+2)^2 samples at 'heights' (row pitch 'stride') into outMap,
+    // copying the materials (same layout) alongside.
+    static void DiscretizeHeightMap(const float* heights, const uint8_t* materials, size_t stride,
+                                    HeightMap& outMap);
     void InitBounds(Chunk& chunk, const HeightMap& heightMap) const;
+    // Plain columns, or the density bands where NarrowBand's mask covers the chunk.
     void FillChunk(Chunk& chunk, const HeightMap& heightMap) const ;
+    void FillColumns(Chunk& chunk, const HeightMap& heightMap) const;
+    void FillBands(Chunk& chunk, const HeightMap& heightMap, const NarrowBandDensity::Weights& weights) const;
+
+    // Erosion post-pass over a grid of noise heights covering 'chunks' chunks (no-op without erosion).
+    void Erode(float originX, float originZ, float step, uint32_t width, uint32_t height,
+               float* heights, size_t stride, size_t chunks = 1) const;
+
+    // Discrete surface level for a sampled height; parity follows the BCC layer of (z + x).
+    static int16_t Discretize(float height, int32_t localZ, int32_t localX) noexcept;
 
-    TerrainGenerator m_TerrainGen;
+    TerrainGenerator  m_TerrainGen;
+    mutable HaloCache m_Halo;
+    TerrainErosion    m_ErosionMode;
+    HydraulicErosion  m_Erosion;      // tiles are only built when m_ErosionMode is Hydraulic
+    TerrainDensity    m_DensityMode;
+    NarrowBandDensity m_Density;      // only queried when m_DensityMode is NarrowBand
+    ScatterLayer      m_Scatter;
 };
\ No newline at end of file
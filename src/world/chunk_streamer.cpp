@@ -7,13 +7,56 @@
 
 // ---Construction / destruction ---
 
+namespace {
+    // Bounds pyramids for every region the load ring can overlap, with room for one move.
+    size_t BoundsCapacity(const ChunkStreamer::Config& cfg) {
+        const uint32_t ld = cfg.loadDistance > 0
+            ? cfg.loadDistance
+            : static_cast<uint32_t>(std::ceil(cfg.renderDistance * LOAD_DISTANCE_FACTOR));
+        const size_t side = 2 * (ld / REGION_SIZE) + 3;
+        return 2 * side * side;
+    }
+
+    // How far the erosion pass and the density bands can move spheres away from the
+    // noise heights.
+    TerrainBounds::Range PostPassRange(const ChunkStreamer::Config& cfg) {
+        TerrainBounds::Range range = {0.0f, 0.0f};
+        if (cfg.erosion == TerrainErosion::Hydraulic) {
+            range.Min -= HydraulicErosion::MAX_CARVE;
+            range.Max += HydraulicErosion::MAX_FILL;
+        }
+        if (cfg.density == TerrainDensity::NarrowBand) {
+            range.Min -= NarrowBandDensity::REACH_BELOW;
+            range.Max += NarrowBandDensity::REACH_ABOVE;
+        }
+        return range;
+    }
+
+    // Largest power of two <= requested, capped at 8 so tiles never cross a region.
+    uint32_t TileSize(uint32_t requested) {
+        static_assert(REGION_SIZE % 8 == 0, "super-tiles must nest in regions");
+        uint32_t size = 1;
+        while (size * 2 <= std::min(requested, 8u)) size *= 2;
+        return size;
+    }
+
+    inline int32_t FloorDiv(int32_t a, int32_t b) noexcept {
+        return a / b - (a % b != 0 && (a ^ b) < 0 ? 1 : 0);
+    }
+}
+
 ChunkStreamer::ChunkStreamer(const Config& cfg)
-    : m_Generator(cfg.seed)
+    : m_Generator(cfg.seed, cfg.sampling, cfg.noise, cfg.erosion, cfg.density),
+      m_Bounds(m_Generator.GetTerrain(), BoundsCapacity(cfg), PostPassRange(cfg))
 {
     m_RenderDist = cfg.renderDistance;
     m_LoadDist   = cfg.loadDistance > 0
         ? cfg.loadDistance
         : static_cast<uint32_t>(std::ceil(cfg.renderDistance * LOAD_DISTANCE_FACTOR));
+    m_HQLoadDist = static_cast<uint32_t>(std::ceil(HQ_RENDER_RANGE * HQ_LOAD_FACTOR));
+    m_LODFirst   = cfg.lodFirst;
+    m_OctaveLOD  = cfg.octaveLOD;
+    m_TileSize   = TileSize(cfg.tileSize);
 
     m_WorldDir   = cfg.worldDir;
     m_RegionsDir = cfg.worldDir + "/regions";
@@ -56,6 +99,8 @@ bool ChunkStreamer::Tick(ChunkCoordinates center) {
 
         RequestLoadRing(prevCenter, center, firstTick);
         if (!firstTick) EvictFarChunks(prevCenter, center);
+        if (m_LODFirst) PromoteHQRing(center);
+        if (m_LODFirst && m_OctaveLOD && !firstTick) RefineLODRings(prevCenter, center);
 
         changed = true;
     }
@@ -86,6 +131,29 @@ void ChunkStreamer::FlushAll() {
         sr->region.Unload();
     }
     m_SharedRegions.clear();
+
+    const HaloCache::Stats halo = m_Generator.GetHaloStats();
+    LOG_INFO("[ChunkStreamer] Halo cache: %llu hits / %llu misses (%.1f%%), %llu evicted unused, %zu pending",
+             static_cast<unsigned long long>(halo.Hits), static_cast<unsigned long long>(halo.Misses),
+             halo.HitRate() * 100.0, static_cast<unsigned long long>(halo.Evictions), halo.Size);
+
+    for (const TerrainGraph::NodeStats& node : m_Generator.GetTerrain().GetGraphStats()) {
+        if (node.Skipped == 0) continue;
+        LOG_INFO("[ChunkStreamer] Height graph '%s': %llu samples evaluated, %llu pruned",
+                 node.Name, static_cast<unsigned long long>(node.Evaluated),
+                 static_cast<unsigned long long>(node.Skipped));
+    }
+
+    if (m_Generator.GetTerrain().GetSampling() == TerrainSampling::Cached) {
+        const auto report = m_Generator.GetTerrain().GetCachedErrorReport();
+        LOG_INFO("[ChunkStreamer] Cached terrain sampling: max height error %.4f over %u probes (%u lattice tiles)",
+                 report.MaxError, report.Probes, report.Tiles);
+    }
+}
+
+void ChunkStreamer::SetViewFrustum(const Frustum& frustum) {
+    m_Frustum    = frustum;
+    m_HasFrustum = true;
 }
 
 Chunk* ChunkStreamer::GetChunk(ChunkCoordinates coords) {
@@ -104,6 +172,9 @@ void ChunkStreamer::RequestLoadRing(ChunkCoordinates prevCenter, ChunkCoordinate
     struct Pending {
         ChunkCoordinates coords;
         int32_t          distSq;
+        bool             visible;
+        bool             lodOnly;
+        float            minWavelength;
     };
     std::vector<Pending> pending;
 
@@ -114,7 +185,10 @@ void ChunkStreamer::RequestLoadRing(ChunkCoordinates prevCenter, ChunkCoordinate
         if (m_Cache.Contains(coords)) return;
         const int32_t dx = x - newCenter.X;
         const int32_t dz = z - newCenter.Z;
-        pending.push_back({coords, dx * dx + dz * dz});
+        const bool lodOnly = m_LODFirst && !InSquare(newCenter, coords, static_cast<int32_t>(m_HQLoadDist));
+        const float minWavelength = lodOnly ? LODMinWavelength(std::max(std::abs(dx), std::abs(dz))) : 0.0f;
+        pending.push_back({coords, dx * dx + dz * dz, !m_HasFrustum || IsPredictedVisible(coords), lodOnly,
+                           minWavelength});
     };
 
     const int32_t newXMin = newCenter.X - ld, newXMax = newCenter.X + ld;
@@ -153,27 +227,115 @@ void ChunkStreamer::RequestLoadRing(ChunkCoordinates prevCenter, ChunkCoordinate
         }
     }
 
-    std::sort(pending.begin(), pending.end(),
-              [](const Pending& a, const Pending& b) { return a.distSq < b.distSq; });
+    std::sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+        if (a.visible != b.visible) return a.visible;
+        return a.distSq < b.distSq;
+    });
 
+    // Group by super-tile (and generation mode). A tile's task takes the queue slot of
+    // its nearest chunk, so tiles still go out nearest-first. A LOD-only tile that
+    // straddles a ring boundary is sampled for the finer ring.
+    const int32_t ts = static_cast<int32_t>(m_TileSize);
+    std::vector<LoadTask>                  tasks;
+    std::unordered_map<uint64_t, size_t>   tileTask[2]; // [lodOnly] tile key -> index in tasks
     for (const Pending& p : pending) {
-        const uint64_t key = ChunkCache::MakeKey(p.coords);
-        m_Requested.insert(key);
+        m_Requested.insert(ChunkCache::MakeKey(p.coords));
 
-        const uint32_t wi = m_NextWorker % static_cast<uint32_t>(m_Workers.size());
-        m_NextWorker = (m_NextWorker + 1) % static_cast<uint32_t>(m_Workers.size());
+        const uint64_t tileKey = ChunkCoordinates(FloorDiv(p.coords.X, ts), FloorDiv(p.coords.Z, ts)).GetKey();
+        auto [it, inserted] = tileTask[p.lodOnly].try_emplace(tileKey, tasks.size());
+        if (inserted) {
+            const ChunkCoordinates rc = RegionHandler::ChunkToRegion(p.coords);
+            tasks.push_back(LoadTask{{}, RegionHandler::MakeID(rc.X, rc.Z), p.lodOnly, p.minWavelength});
+        }
+        LoadTask& task = tasks[it->second];
+        task.chunks.push_back(p.coords);
+        task.minWavelength = std::min(task.minWavelength, p.minWavelength);
+    }
 
-        const ChunkCoordinates rc = RegionHandler::ChunkToRegion(p.coords);
-        const uint64_t regionID = RegionHandler::MakeID(rc.X, rc.Z);
+    for (LoadTask& task : tasks)
+        Dispatch(std::move(task));
+}
 
-        {
-            std::unique_lock<std::mutex> lock(m_Workers[wi]->mtx);
-            m_Workers[wi]->loadQueue.push(LoadTask{p.coords, regionID});
+void ChunkStreamer::Dispatch(LoadTask&& task) {
+    const uint32_t wi = m_NextWorker % static_cast<uint32_t>(m_Workers.size());
+    m_NextWorker = (m_NextWorker + 1) % static_cast<uint32_t>(m_Workers.size());
+    {
+        std::unique_lock<std::mutex> lock(m_Workers[wi]->mtx);
+        m_Workers[wi]->loadQueue.push(std::move(task));
+    }
+    m_Workers[wi]->cv.notify_one();
+}
+
+void ChunkStreamer::PromoteHQRing(ChunkCoordinates center) {
+    const int32_t hq = static_cast<int32_t>(m_HQLoadDist);
+    for (int32_t z = center.Z - hq; z <= center.Z + hq; ++z) {
+        for (int32_t x = center.X - hq; x <= center.X + hq; ++x) {
+            const ChunkCoordinates coords(x, z);
+            const Chunk* chunk = m_Cache.Find(coords);
+            if (chunk && chunk->IsLODOnly()) Promote(coords);
         }
-        m_Workers[wi]->cv.notify_one();
     }
 }
 
+void ChunkStreamer::Promote(ChunkCoordinates coords) {
+    if (!m_Promoting.insert(ChunkCache::MakeKey(coords)).second) return; // already in flight
+
+    const ChunkCoordinates rc = RegionHandler::ChunkToRegion(coords);
+    Dispatch(LoadTask{{coords}, RegionHandler::MakeID(rc.X, rc.Z), false});
+}
+
+void ChunkStreamer::RefineLODRings(ChunkCoordinates prevCenter, ChunkCoordinates newCenter) {
+    const int32_t moved = std::max(std::abs(newCenter.X - prevCenter.X), std::abs(newCenter.Z - prevCenter.Z));
+    const int32_t hq    = static_cast<int32_t>(m_HQLoadDist);
+    const int32_t ld    = static_cast<int32_t>(m_LoadDist);
+
+    auto refine = [&](int32_t x, int32_t z, int32_t dist) {
+        const ChunkCoordinates coords(x, z);
+        const Chunk* chunk = m_Cache.Find(coords);
+        if (!chunk || !chunk->IsLODOnly()) return;
+        const float minWavelength = LODMinWavelength(dist);
+        if (chunk->GetOmittedWavelength() < minWavelength) return; // nothing it lacks is visible yet
+        if (!m_Refining.insert(ChunkCache::MakeKey(coords)).second) return;
+
+        const ChunkCoordinates rc = RegionHandler::ChunkToRegion(coords);
+        Dispatch(LoadTask{{coords}, RegionHandler::MakeID(rc.X, rc.Z), true, minWavelength});
+    };
+
+    // Chunks that crossed an inner ring edge lie within 'moved' of it, on the inside.
+    float ringEnd = static_cast<float>(HQ_RENDER_RANGE);
+    for (uint32_t ring = 0; ring + 1 < LOD_LEVELS; ++ring) {
+        ringEnd *= LOD_RING_FACTOR;
+        const int32_t edge = static_cast<int32_t>(std::ceil(ringEnd));
+        if (edge <= hq || edge > ld) continue; // promoted to full detail / outside the load ring
+
+        for (int32_t d = std::max(hq + 1, edge - moved); d < edge; ++d) {
+            for (int32_t k = -d; k <= d; ++k) {
+                refine(newCenter.X + k, newCenter.Z - d, d);
+                refine(newCenter.X + k, newCenter.Z + d, d);
+            }
+            for (int32_t k = -d + 1; k <= d - 1; ++k) {
+                refine(newCenter.X - d, newCenter.Z + k, d);
+                refine(newCenter.X + d, newCenter.Z + k, d);
+            }
+        }
+    }
+}
+
+float ChunkStreamer::LODMinWavelength(int32_t dist) const noexcept {
+    if (!m_OctaveLOD) return 0.0f;
+
+    // Same rings as frustum_culler_lo.comp; LOD-only chunks alias LOD0 to LOD1.
+    float    ringEnd = static_cast<float>(HQ_RENDER_RANGE);
+    uint32_t lod     = LOD_LEVELS - 1u;
+    for (uint32_t i = 0; i + 1 < LOD_LEVELS; ++i) {
+        ringEnd *= LOD_RING_FACTOR;
+        if (static_cast<float>(dist) < ringEnd) { lod = i; break; }
+    }
+    // Block heights cannot carry a wave shorter than two blocks.
+    const uint32_t block = 1u << std::max(lod, 1u);
+    return 2.0f * static_cast<float>(block) * SPHERE_RADIUS;
+}
+
 bool ChunkStreamer::DrainCompleted() {
     bool changed = false;
     for (auto& ws : m_Workers) {
@@ -184,12 +346,33 @@ bool ChunkStreamer::DrainCompleted() {
         }
 
         for (auto& chunkPtr : batch) {
-            const ChunkCoordinates coords = chunkPtr->GetCoordinates();
-            const uint64_t         key    = ChunkCache::MakeKey(coords);
-            m_Cache.Insert(std::move(chunkPtr)); // unbounded cache - never evicts
-            m_Requested.erase(key);
+            const ChunkCoordinates coords  = chunkPtr->GetCoordinates();
+            const uint64_t         key     = ChunkCache::MakeKey(coords);
+            const bool             lodOnly = chunkPtr->IsLODOnly();
+            const bool             refined = m_Refining.erase(key) > 0;
+            bool                   promote = false;
+
+            if (!lodOnly && m_Promoting.erase(key)) {
+                // Full-detail replacement - dropped if the LOD-only chunk was evicted meanwhile.
+                if (!m_Cache.Contains(coords)) continue;
+            } else if (refined && !m_Cache.Contains(coords)) {
+                continue; // finer re-sample of a chunk evicted meanwhile
+            } else {
+                m_Requested.erase(key);
+                if (lodOnly) {
+                    const Chunk* cached = m_Cache.Find(coords);
+                    if (cached && !cached->IsLODOnly()) continue; // never downgrade
+                    promote = m_TickCenterValid &&
+                              InSquare(m_LastTickCenter, coords, static_cast<int32_t>(m_HQLoadDist));
+                }
+            }
+
+            m_Cache.Insert(std::move(chunkPtr)); // unbounded cache - never evicts; replaces in place
             m_RecentlyArrived.push_back(coords);
             changed = true;
+
+            // Player moved inside the HQ load range while this chunk was in flight.
+            if (promote) Promote(coords);
         }
     }
     return changed;
@@ -269,6 +452,18 @@ bool ChunkStreamer::EvictFarChunks(ChunkCoordinates prevCenter, ChunkCoordinates
     return true;
 }
 
+bool ChunkStreamer::IsPredictedVisible(ChunkCoordinates coords) {
+    for (int32_t level = TerrainBounds::LEVELS - 1; level >= 0; --level) {
+        const BoundBox box = m_Bounds.GetBlockBounds(coords, static_cast<uint32_t>(level));
+        switch (box.TestFrustum(m_Frustum)) {
+            case BoundBox::FrustumTest::Outside:   return false;
+            case BoundBox::FrustumTest::Inside:    return true;
+            case BoundBox::FrustumTest::Intersect: break;
+        }
+    }
+    return true;
+}
+
 bool ChunkStreamer::InSquare(ChunkCoordinates center, ChunkCoordinates c, int32_t dist) noexcept {
     return std::abs(c.X - center.X) <= dist && std::abs(c.Z - center.Z) <= dist;
 }
@@ -327,36 +522,61 @@ void ChunkStreamer::WorkerLoop(uint32_t workerIdx) {
         }
 
         if (hasLoad) {
-            std::unique_ptr<Chunk> chunk;
+            const size_t count = loadTask.chunks.size();
+            std::vector<std::unique_ptr<Chunk>> chunks(count);
+
+            // Whole tile lies in one region: read what is on disk under a single lock.
+            std::shared_ptr<SharedRegion> sr;
             try {
-                const ChunkCoordinates regionCoords =
-                    RegionHandler::ChunkToRegion(loadTask.coords);
-                auto sr = GetOrLoadRegion(loadTask.regionID, regionCoords);
-                {
-                    std::lock_guard<std::mutex> lock(sr->mtx);
-                    if (sr->region.HasChunk(loadTask.coords))
-                        chunk = sr->region.ReadChunk(loadTask.coords);
-                }
+                sr = GetOrLoadRegion(loadTask.regionID, RegionHandler::ChunkToRegion(loadTask.chunks[0]));
             } catch (const std::exception& e) {
-                LOG_ERROR("[ChunkStreamer] Worker %u: exception loading (%d, %d): %s - regenerating",
-                          workerIdx, loadTask.coords.X, loadTask.coords.Z, e.what());
-                chunk.reset();
+                LOG_ERROR("[ChunkStreamer] Worker %u: exception loading region of (%d, %d): %s - regenerating",
+                          workerIdx, loadTask.chunks[0].X, loadTask.chunks[0].Z, e.what());
+            }
+            if (sr) {
+                std::lock_guard<std::mutex> lock(sr->mtx);
+                for (size_t i = 0; i < count; ++i) {
+                    const ChunkCoordinates& coords = loadTask.chunks[i];
+                    try {
+                        if (sr->region.HasChunk(coords))
+                            chunks[i] = sr->region.ReadChunk(coords);
+                    } catch (const std::exception& e) {
+                        LOG_ERROR("[ChunkStreamer] Worker %u: exception loading (%d, %d): %s - regenerating",
+                                  workerIdx, coords.X, coords.Z, e.what());
+                        chunks[i].reset();
+                    }
+                }
             }
 
-            if (!chunk) {
-                // Not on disk (or load failed) - generate procedurally.
-                chunk = std::make_unique<Chunk>(loadTask.coords.X, loadTask.coords.Z);
-                m_Generator.Generate(*chunk);
-                chunk->IsDirty = true;
+            // Not on disk (or load failed) - generate procedurally.
+            std::vector<Chunk*> toGenerate;
+            for (size_t i = 0; i < count; ++i) {
+                if (chunks[i]) continue;
+                chunks[i] = std::make_unique<Chunk>(loadTask.chunks[i].X, loadTask.chunks[i].Z);
+                if (loadTask.lodOnly) {
+                    // Far ring: coarse LODs only. Not dirty - nothing worth saving until promoted.
+                    m_Generator.GenerateLODOnly(*chunks[i], loadTask.minWavelength);
+                } else {
+                    chunks[i]->IsDirty = true;
+                    toGenerate.push_back(chunks[i].get());
+                }
             }
+            m_Generator.GenerateTile(toGenerate.data(), toGenerate.size());
 
-            // Build compact LOD levels off the main thread - the renderer needs
-            // them ready before the chunk reaches the main thread cache.
-            chunk->GenerateLODs();
+            // Build compact LOD levels and the scatter instances off the main thread -
+            // the renderer needs them ready before the chunk reaches the main thread
+            // cache. (LOD-only chunks already have their LODs and carry no scatter.)
+            for (auto& chunk : chunks) {
+                {
+                    GEN_PROFILE_SCOPE(GenProfiler::Stage::LODs, chunk->IsLODOnly() ? 0 : 1);
+                    chunk->GenerateLODs();
+                }
+                if (!chunk->IsLODOnly()) m_Generator.Scatter(*chunk);
+            }
 
             {
                 std::unique_lock<std::mutex> lock(ws.mtx);
-                ws.completed.push_back(std::move(chunk));
+                for (auto& chunk : chunks) ws.completed.push_back(std::move(chunk));
             }
         }
 
@@ -2,7 +2,10 @@
 
 #include "world/chunk_cache.hpp"
 #include "world/chunk_generator.hpp"
+#include "world/gen_profiler.hpp"
 #include "world/region_handler.hpp"
+#include "world/terrain_bounds.hpp"
+#include "physics/frustum.hpp"
 
 #include <atomic>
 #include <condition_variable>
@@ -18,7 +21,18 @@
 
 // Coordinates chunk availability around the player:
 //   - Maintains a load ring (loadDist chunks) and a render ring (renderDist chunks).
-//   - Missing chunks are dispatched to worker threads for generation or disk-load.
+//   - Missing chunks are dispatched to worker threads for generation or disk-load,
+//     nearest first; with a view frustum set, chunks whose predicted bounds
+//     (TerrainBounds) are in view go ahead of the ones that are not.
+//   - Pending chunks of one aligned super-tile (tileSize x tileSize chunks) travel as
+//     a single task, queued at the position of its nearest chunk; the worker reads
+//     them under one region lock and generates them from one height grid.
+//   - Chunks past the HQ load range (HQ_RENDER_RANGE * HQ_LOAD_FACTOR) that are not
+//     on disk are generated LOD-only (ChunkGenerator::GenerateLODOnly); they are
+//     promoted to full detail once they come inside that range.
+//   - With octaveLOD, LOD-only chunks skip the noise octaves shorter than two blocks of
+//     the LOD ring they are drawn in, and are re-sampled when they move into a finer
+//     ring and the octaves they lack become representable.
 //   - Completed chunks are flushed into the ChunkCache on each Tick().
 //   - Dirty chunks evicted from the cache are saved to disk by a worker thread.
 //
@@ -33,6 +47,13 @@ public:
         size_t      cacheCapacity  = 0;      // 0 = auto: (loadDist*2+1)^2
         Seed256     seed           = {};
         std::string worldDir       = "data/world";
+        TerrainSampling sampling   = TerrainSampling::Exact; // Cached = per-region low-frequency lattice
+        TerrainNoise    noise      = TerrainNoise::Float;    // Lattice = deterministic integer noise
+        TerrainErosion  erosion    = TerrainErosion::None;   // Hydraulic = drainage carving in region tiles
+        TerrainDensity  density    = TerrainDensity::None;   // NarrowBand = overhangs and caves near the surface
+        bool        lodFirst       = true;   // LOD-only generation past the HQ load range
+        uint32_t    tileSize       = 4;      // super-tile side in chunks: 1, 2, 4 or 8 (1 = task per chunk)
+        bool        octaveLOD      = true;   // LOD-only chunks skip octaves finer than their LOD ring
     };
 
     explicit ChunkStreamer(const Config& cfg);
@@ -46,6 +67,10 @@ public:
     // Returns true if the cache contents changed (new chunks or evictions occurred).
     bool Tick(ChunkCoordinates centerChunk);
 
+    // Camera frustum used to order the next load requests (visible chunks first).
+    // Chunks out of view are deferred, not skipped: the ring stays complete for when the camera turns.
+    void SetViewFrustum(const Frustum& frustum);
+
     // Flush all dirty chunks to disk (blocking) - call before shutdown.
     void FlushAll();
 
@@ -62,12 +87,26 @@ public:
 
     const std::string& GetRegionsDir() const noexcept { return m_RegionsDir; }
 
+    // Shared chunk-edge sample cache counters (see HaloCache).
+    HaloCache::Stats GetHaloStats() const { return m_Generator.GetHaloStats(); }
+
+    // Per-module / per-stage generation counters summed over the worker threads (and
+    // any other thread that generated). All zero unless built with GEN_PROFILE.
+    GenProfiler::Report GetGenProfile() const { return GenProfiler::Collect(); }
+    void                ResetGenProfile()     { GenProfiler::Reset(); }
+
+    // Thread-safe; used for height queries over chunks that are not loaded.
+    const ChunkGenerator& GetGenerator() const noexcept { return m_Generator; }
+
 private:
     // --- Worker task types ---
 
+    // Chunks of one super-tile (always one region), nearest first.
     struct LoadTask {
-        ChunkCoordinates coords;
-        uint64_t         regionID;
+        std::vector<ChunkCoordinates> chunks;
+        uint64_t                      regionID;
+        bool                          lodOnly = false; // generate coarse LODs only if not on disk
+        float                         minWavelength = 0.0f; // lodOnly: octaves to skip (see GenerateLODOnly)
     };
 
     struct SaveTask {
@@ -84,6 +123,23 @@ private:
     bool EvictFarChunks(ChunkCoordinates prevCenter, ChunkCoordinates newCenter);
     bool DrainCompleted();
 
+    // Queues full-detail generation for LOD-only cached chunks inside the HQ load range.
+    void PromoteHQRing(ChunkCoordinates center);
+    void Promote(ChunkCoordinates coords);
+
+    // Re-samples LOD-only cached chunks that moved across a LOD ring boundary and now
+    // lack octaves their new ring can show. Only the bands the center move swept are scanned.
+    void RefineLODRings(ChunkCoordinates prevCenter, ChunkCoordinates newCenter);
+
+    // Octave floor for a LOD-only chunk at this Chebyshev distance (0 without octaveLOD).
+    float LODMinWavelength(int32_t dist) const noexcept;
+
+    void Dispatch(LoadTask&& task);
+
+    // Frustum test of the predicted bounds, coarsest pyramid level first. Only
+    // chunks on the frustum border reach level 0.
+    bool IsPredictedVisible(ChunkCoordinates coords);
+
     // True if chunkCoords is within squareDist chunks of center (square check, fast).
     static bool InSquare(ChunkCoordinates center, ChunkCoordinates c, int32_t dist) noexcept;
 
@@ -105,6 +161,10 @@ private:
 
     uint32_t    m_RenderDist;
     uint32_t    m_LoadDist;
+    uint32_t    m_HQLoadDist; // ceil(HQ_RENDER_RANGE * HQ_LOAD_FACTOR)
+    uint32_t    m_TileSize;
+    bool        m_LODFirst;
+    bool        m_OctaveLOD;
     std::string m_WorldDir;
     std::string m_RegionsDir;
 
@@ -127,6 +187,10 @@ private:
 
     ChunkCache     m_Cache;
     ChunkGenerator m_Generator;
+    TerrainBounds  m_Bounds; // predicted chunk bounds (main thread only)
+
+    Frustum m_Frustum{};
+    bool    m_HasFrustum = false;
 
     // Per-worker state (stable addresses via unique_ptr).
     std::vector<std::unique_ptr<WorkerState>> m_Workers;
@@ -137,6 +201,12 @@ private:
     // Keys currently in the cache or en-route to it (avoids double-dispatch).
     std::unordered_set<uint64_t> m_Requested;
 
+    // LOD-only cached chunks with a full-detail task in flight.
+    std::unordered_set<uint64_t> m_Promoting;
+
+    // LOD-only cached chunks with a finer LOD-only task in flight.
+    std::unordered_set<uint64_t> m_Refining;
+
     // Chunks added to the cache since the last ConsumeRecentlyArrived() call.
     std::vector<ChunkCoordinates> m_RecentlyArrived;
 
@@ -16,7 +16,7 @@ constexpr float    LOAD_DISTANCE_FACTOR    = 1.1f;  // load ring = renderDist x
 //  0.1  = 10x compact       (mountains ~500 m wide, ~120 m tall)  - good for render dist 200
 //  0.05 = 20x compact       (very dense, rocky landscape)
 //
-// The shader divides heights by this value to keep colour-band thresholds correct at any scale.
+// TerrainMaterial divides heights by this value to keep colour-band thresholds correct at any scale.
 constexpr float FEATURE_SCALE = 1.0f;
 
 // Radius (in chunks) of the full-detail rendering area centered on the player.
@@ -0,0 +1,154 @@
+#include "world/gen_profiler.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if GEN_PROFILE
+    #if defined(__x86_64__) || defined(__i386__)
+        #include <x86intrin.h>
+    #else
+        #include <chrono>
+    #endif
+#endif
+
+namespace {
+    constexpr size_t MODULES = static_cast<size_t>(GenProfiler::Module::Count);
+    constexpr size_t STAGES  = static_cast<size_t>(GenProfiler::Stage::Count);
+
+    // One thread's counters. Only the owning thread writes them (relaxed load + store,
+    // no read-modify-write), Collect() reads them from any thread.
+    struct alignas(64) Block {
+        struct Slot { std::atomic<uint64_t> Calls{0}, Items{0}, Cycles{0}; };
+        std::array<Slot, MODULES> Modules;
+        std::array<Slot, STAGES>  Stages;
+        std::atomic<bool>         InUse{false};
+    };
+
+    std::mutex                          g_Mutex;
+    std::vector<std::unique_ptr<Block>> g_Blocks;   // never shrinks; blocks are reused
+    GenProfiler::Report                 g_Baseline; // totals at the last Reset()
+
+    void Read(const Block::Slot& slot, GenProfiler::Counter& out) {
+        out.Calls  += slot.Calls.load(std::memory_order_relaxed);
+        out.Items  += slot.Items.load(std::memory_order_relaxed);
+        out.Cycles += slot.Cycles.load(std::memory_order_relaxed);
+    }
+
+    void Subtract(GenProfiler::Counter& a, const GenProfiler::Counter& b) {
+        a.Calls  -= b.Calls;
+        a.Items  -= b.Items;
+        a.Cycles -= b.Cycles;
+    }
+
+    // Sum over every block, without the baseline. Caller holds g_Mutex.
+    GenProfiler::Report Sum() {
+        GenProfiler::Report report;
+        for (const auto& block : g_Blocks) {
+            for (size_t i = 0; i < MODULES; ++i) Read(block->Modules[i], report.Modules[i]);
+            for (size_t i = 0; i < STAGES; ++i)  Read(block->Stages[i], report.Stages[i]);
+        }
+        report.Threads = static_cast<uint32_t>(g_Blocks.size());
+        return report;
+    }
+
+#if GEN_PROFILE
+    // Claims a free block for the calling thread on first use and frees it at thread exit.
+    class ThreadBlock {
+    public:
+        ThreadBlock() {
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            for (auto& block : g_Blocks) {
+                if (!block->InUse.load(std::memory_order_relaxed)) { m_Block = block.get(); break; }
+            }
+            if (!m_Block) {
+                g_Blocks.push_back(std::make_unique<Block>());
+                m_Block = g_Blocks.back().get();
+            }
+            m_Block->InUse.store(true, std::memory_order_relaxed);
+        }
+        ~ThreadBlock() { m_Block->InUse.store(false, std::memory_order_relaxed); }
+
+        Block& Get() noexcept { return *m_Block; }
+
+    private:
+        Block* m_Block = nullptr;
+    };
+
+    Block& Local() {
+        thread_local ThreadBlock block;
+        return block.Get();
+    }
+
+    void Add(Block::Slot& slot, uint64_t items, uint64_t cycles) noexcept {
+        slot.Calls.store(slot.Calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        slot.Items.store(slot.Items.load(std::memory_order_relaxed) + items, std::memory_order_relaxed);
+        slot.Cycles.store(slot.Cycles.load(std::memory_order_relaxed) + cycles, std::memory_order_relaxed);
+    }
+#endif
+}
+
+namespace GenProfiler {
+
+const char* Name(Module module) noexcept {
+    switch (module) {
+        case Module::Continental: return "continental";
+        case Module::Erosion:     return "erosion";
+        case Module::Peaks:       return "peaks";
+        case Module::Warp:        return "warp";
+        case Module::Detail:      return "detail";
+        case Module::Biome:       return "biome";
+        case Module::Rock:        return "rock";
+        case Module::Count:       break;
+    }
+    return "unknown";
+}
+
+const char* Name(Stage stage) noexcept {
+    switch (stage) {
+        case Stage::HeightMap: return "heightmap";
+        case Stage::Erosion:   return "erosion";
+        case Stage::Density:   return "density";
+        case Stage::Bounds:    return "bounds";
+        case Stage::Fill:      return "fill";
+        case Stage::LODs:      return "lods";
+        case Stage::Scatter:   return "scatter";
+        case Stage::Count:     break;
+    }
+    return "unknown";
+}
+
+Report Collect() {
+    std::lock_guard<std::mutex> lock(g_Mutex);
+    Report report = Sum();
+    for (size_t i = 0; i < MODULES; ++i) Subtract(report.Modules[i], g_Baseline.Modules[i]);
+    for (size_t i = 0; i < STAGES; ++i)  Subtract(report.Stages[i], g_Baseline.Stages[i]);
+    return report;
+}
+
+void Reset() {
+    std::lock_guard<std::mutex> lock(g_Mutex);
+    g_Baseline = Sum();
+}
+
+#if GEN_PROFILE
+uint64_t Now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void Record(Module module, uint64_t items, uint64_t cycles) noexcept {
+    Add(Local().Modules[static_cast<size_t>(module)], items, cycles);
+}
+
+void Record(Stage stage, uint64_t items, uint64_t cycles) noexcept {
+    Add(Local().Stages[static_cast<size_t>(stage)], items, cycles);
+}
+#endif
+
+}
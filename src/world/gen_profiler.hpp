@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// --- Generation profiler ---
+// Set to 1 (or pass -DGEN_PROFILE=1) to count the calls, items and cycles spent in
+// each terrain noise module and chunk generation stage. With 0 the GEN_PROFILE_SCOPE
+// macro expands to nothing and no instrumentation is compiled in; Collect() then
+// reports zeros.
+#ifndef GEN_PROFILE
+    #define GEN_PROFILE 0
+#endif
+
+// Every thread records into its own block (a single writer per counter, no shared
+// cache lines), and Collect() sums the blocks. A block outlives its thread and is
+// reused by the next thread that starts, so totals survive worker restarts.
+namespace GenProfiler {
+    constexpr bool ENABLED = GEN_PROFILE != 0;
+
+    // Items = samples evaluated (batched height / material path).
+    enum class Module : uint8_t { Continental, Erosion, Peaks, Warp, Detail, Biome, Rock, Count };
+
+    // Items = chunks. HeightMap: noise grid + discretisation, Erosion: the
+    // HydraulicErosion pass (tile simulation included), Density: NarrowBandDensity
+    // mask and bands, Bounds: InitBounds, Fill: FillChunk, LODs: Chunk::GenerateLODs
+    // or a LOD-only chunk's levels, Scatter: ChunkGenerator::Scatter.
+    enum class Stage : uint8_t { HeightMap, Erosion, Density, Bounds, Fill, LODs, Scatter, Count };
+
+    struct Counter {
+        uint64_t Calls  = 0;
+        uint64_t Items  = 0;
+        uint64_t Cycles = 0; // TSC ticks on x86, nanoseconds elsewhere
+    };
+
+    struct Report {
+        std::array<Counter, static_cast<size_t>(Module::Count)> Modules{};
+        std::array<Counter, static_cast<size_t>(Stage::Count)>  Stages{};
+        uint32_t Threads = 0; // per-thread blocks: the most threads that recorded at once
+    };
+
+    const char* Name(Module module) noexcept;
+    const char* Name(Stage stage) noexcept;
+
+    // Totals over all threads since the last Reset(). Thread-safe; counters still being
+    // written are read as they stand.
+    Report Collect();
+    void   Reset();
+
+#if GEN_PROFILE
+    uint64_t Now() noexcept;
+    void     Record(Module module, uint64_t items, uint64_t cycles) noexcept;
+    void     Record(Stage stage, uint64_t items, uint64_t cycles) noexcept;
+
+    // Records the lifetime of the enclosing block against 'id'.
+    template <class Id>
+    class Scope {
+    public:
+        Scope(Id id, uint64_t items) noexcept : m_Id(id), m_Items(items), m_Start(Now()) {}
+        ~Scope() { Record(m_Id, m_Items, Now() - m_Start); }
+
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Id       m_Id;
+        uint64_t m_Items;
+        uint64_t m_Start;
+    };
+#endif
+}
+
+#if GEN_PROFILE
+    #define GEN_PROFILE_CONCAT_(a, b) a##b
+    #define GEN_PROFILE_CONCAT(a, b)  GEN_PROFILE_CONCAT_(a, b)
+    #define GEN_PROFILE_SCOPE(id, items) \
+        const GenProfiler::Scope<decltype(id)> GEN_PROFILE_CONCAT(genProfileScope_, __LINE__)((id), (items))
+#else
+    #define GEN_PROFILE_SCOPE(id, items)
+#endif
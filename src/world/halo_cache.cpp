@@ -0,0 +1,59 @@
+#include "world/halo_cache.hpp"
+
+HaloCache::HaloCache(size_t capacity)
+    : m_ShardCapacity(capacity == 0 ? 0 : (capacity + SHARD_COUNT - 1) / SHARD_COUNT) {}
+
+HaloCache::Shard& HaloCache::ShardFor(uint64_t key) noexcept {
+    // Mix X and Z so a row of chunks spreads over every shard.
+    uint64_t h = key * 0x9E3779B97F4A7C15ull;
+    return m_Shards[(h >> 60) % SHARD_COUNT];
+}
+
+bool HaloCache::Take(ChunkCoordinates owner, Side side, Edge& out) {
+    const uint64_t key = owner.GetKey();
+    Shard& shard = ShardFor(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto& edges = shard.edges[static_cast<uint8_t>(side)];
+        auto it = edges.find(key);
+        if (it != edges.end()) {
+            out = it->second;
+            edges.erase(it); // its order entry goes stale and is skipped on eviction
+            m_Hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    m_Misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void HaloCache::Store(ChunkCoordinates owner, Side side, const Edge& edge) {
+    const uint64_t key = owner.GetKey();
+    Shard& shard = ShardFor(key);
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto [it, inserted] = shard.edges[static_cast<uint8_t>(side)].insert_or_assign(key, edge);
+    if (!inserted) return; // both neighbours raced on the same edge - identical values
+    m_Stores.fetch_add(1, std::memory_order_relaxed);
+
+    shard.order.emplace_back(key, side);
+    while (m_ShardCapacity > 0 && shard.order.size() > m_ShardCapacity) {
+        const auto [oldKey, oldSide] = shard.order.front();
+        shard.order.pop_front();
+        if (shard.edges[static_cast<uint8_t>(oldSide)].erase(oldKey))
+            m_Evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+HaloCache::Stats HaloCache::GetStats() const {
+    Stats stats;
+    stats.Hits      = m_Hits.load(std::memory_order_relaxed);
+    stats.Misses    = m_Misses.load(std::memory_order_relaxed);
+    stats.Stores    = m_Stores.load(std::memory_order_relaxed);
+    stats.Evictions = m_Evictions.load(std::memory_order_relaxed);
+    for (const Shard& shard : m_Shards) {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        stats.Size += shard.edges[0].size() + shard.edges[1].size();
+    }
+    return stats;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "world/chunk.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+// Concurrent, bounded store of the sampled terrain heights (and materials) along chunk edges.
+//
+// A HeightMap spans [-1, CHUNK_SIZE] on both axes, so the two cell lines on either
+// side of a shared chunk edge are computed by both neighbours. The first chunk to
+// generate publishes those two lines under the edge; the neighbour takes them
+// instead of sampling the noise again. An edge is consumed by exactly one
+// neighbour, so Take() removes it and the cache only holds edges whose second
+// chunk has not been generated yet.
+//
+// Edges are named by the chunk on their west / north side:
+//   East  - between (x, z) and (x+1, z): cell lines at local x = CHUNK_SIZE-1 and CHUNK_SIZE
+//   South - between (x, z) and (x, z+1): cell lines at local z = CHUNK_SIZE-1 and CHUNK_SIZE
+// Each line covers local [-1, CHUNK_SIZE] along the edge.
+//
+// Sharded by edge so workers on different chunks rarely touch the same mutex.
+class HaloCache {
+public:
+    static constexpr uint32_t LINE = CHUNK_SIZE + 2;
+
+    enum class Side : uint8_t { East = 0, South = 1 };
+
+    struct Edge {
+        // Lines[0] = inner line of the west/north chunk, Lines[1] = inner line of the east/south chunk.
+        // Raw heights, not discrete levels: the parity step of the discretisation uses
+        // local coordinates, so each chunk discretises shared samples itself.
+        std::array<std::array<float, LINE>, 2> Lines;
+        // TerrainMaterial of the same cells (computed with the heights).
+        std::array<std::array<uint8_t, LINE>, 2> Materials;
+    };
+
+    struct Stats {
+        uint64_t Hits      = 0;
+        uint64_t Misses    = 0;
+        uint64_t Stores    = 0;
+        uint64_t Evictions = 0; // edges dropped for capacity before a neighbour used them
+        size_t   Size      = 0;
+
+        // Every shared edge is sampled once and taken once, so 0.5 is the ceiling
+        // (chunks on the outer rim of the generated area keep their edges pending).
+        double HitRate() const noexcept {
+            const uint64_t total = Hits + Misses;
+            return total ? static_cast<double>(Hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    // capacity = max edges held in total (0 = unbounded).
+    explicit HaloCache(size_t capacity = 64 * 1024);
+
+    HaloCache(const HaloCache&) = delete;
+    HaloCache& operator=(const HaloCache&) = delete;
+
+    // Moves the edge out of the cache into 'out'. Returns false (a miss) if absent.
+    bool Take(ChunkCoordinates owner, Side side, Edge& out);
+
+    // Publishes an edge for the neighbour across it. Evicts the oldest edge of the shard when full.
+    void Store(ChunkCoordinates owner, Side side, const Edge& edge);
+
+    Stats GetStats() const;
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    struct Shard {
+        mutable std::mutex mtx;
+        std::unordered_map<uint64_t, Edge> edges[2]; // indexed by Side
+        std::deque<std::pair<uint64_t, Side>> order; // insertion order, front = oldest
+    };
+
+    Shard& ShardFor(uint64_t key) noexcept;
+
+    size_t                         m_ShardCapacity;
+    std::array<Shard, SHARD_COUNT> m_Shards;
+
+    std::atomic<uint64_t> m_Hits{0};
+    std::atomic<uint64_t> m_Misses{0};
+    std::atomic<uint64_t> m_Stores{0};
+    std::atomic<uint64_t> m_Evictions{0};
+};
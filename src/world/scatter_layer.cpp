@@ -0,0 +1,205 @@
+#include "world/scatter_layer.hpp"
+#include "world/chunk.hpp"
+#include "world/terrain_generator.hpp"
+#include "world/terrain_material.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+    constexpr float FOREST_FREQUENCY = 0.01f;  // ~100 m woods and clearings
+    constexpr float FOREST_LOW       = -0.2f;  // forest noise -> tree odds 0 .. 1
+    constexpr float FOREST_HIGH      = 0.35f;
+    constexpr float TREE_CHANCE      = 0.8f;   // per candidate, deep in a wood
+    constexpr float LUSH_BOOST       = 1.25f;  // on Lush ground
+    constexpr float BOULDER_CHANCE   = 0.05f;  // per candidate, any land
+    constexpr float ROCK_BOULDER     = 0.5f;   // per candidate, on Rock ground
+
+    // Heights in metres, scaled by FEATURE_SCALE like TerrainMaterial's bands.
+    constexpr float TREE_FROM    = 12.0f,  TREE_FULL    = 25.0f;  // above the beach
+    constexpr float CONIFER_FROM = 100.0f, CONIFER_FULL = 220.0f; // broadleaf -> conifer
+    constexpr float TREE_LINE    = 380.0f, TREE_LAST    = 450.0f;
+    constexpr float BOULDER_FROM = 2.0f,   BOULDER_TO   = 800.0f;
+
+    // Largest discrete-height step to a cardinal neighbour (1 step ~ 45 degrees).
+    constexpr int32_t TREE_MAX_STEP    = 2;
+    constexpr int32_t BOULDER_MAX_STEP = 4;
+
+    inline float SmoothStep(float e0, float e1, float v) noexcept {
+        v = std::clamp((v - e0) / (e1 - e0), 0.0f, 1.0f);
+        return v * v * (3.0f - 2.0f * v);
+    }
+
+    inline uint32_t Mix(uint32_t h) noexcept {
+        h ^= h >> 16; h *= 0x85ebca6bu;
+        h ^= h >> 13; h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    inline uint32_t Hash(int32_t seed, int32_t x, int32_t z) noexcept {
+        return Mix(static_cast<uint32_t>(seed) ^ (static_cast<uint32_t>(x) * 0x27d4eb2du)
+                                               ^ (static_cast<uint32_t>(z) * 0x165667b1u));
+    }
+
+    // Next draw of a candidate's random sequence.
+    inline uint32_t Next(uint32_t& h) noexcept { return h = Mix(h + 0x9e3779b9u); }
+
+    inline float Unit(uint32_t h) noexcept { return static_cast<float>(h >> 8) * (1.0f / 16777216.0f); }
+
+    inline uint8_t QuantiseScale(float scale) noexcept {
+        return static_cast<uint8_t>(std::clamp(std::lround(scale / ScatterInstance::SCALE_STEP), 1l, 255l));
+    }
+}
+
+ScatterLayer::ScatterLayer(const TerrainGenerator& terrain)
+    : m_ForestNoise(terrain.DeriveSeed("forest"), FOREST_FREQUENCY),
+      m_Seed(terrain.DeriveSeed("scatter")) {}
+
+void ScatterLayer::Populate(const Chunk& chunk, std::vector<ScatterInstance>& out) const {
+    if (chunk.IsLODOnly() || chunk.GetSize() == 0) return;
+
+    using TerrainMaterial::Variant;
+    constexpr int32_t BLOCKS = CHUNK_SIZE / CELL;
+    const SphereColumns&       spheres = chunk.GetSpheres();
+    const ChunkCoordinates&    coords  = chunk.GetCoordinates();
+
+    for (int32_t bz = 0; bz < BLOCKS; ++bz) {
+        for (int32_t bx = 0; bx < BLOCKS; ++bx) {
+            const int32_t blockX = coords.X * CHUNK_SIZE + bx * CELL;
+            const int32_t blockZ = coords.Z * CHUNK_SIZE + bz * CELL;
+            uint32_t h = Hash(m_Seed, blockX, blockZ);
+
+            int32_t x = bx * CELL + static_cast<int32_t>(h % CELL);
+            int32_t z = bz * CELL + static_cast<int32_t>((h / CELL) % CELL);
+            if ((x + z) & 1) x ^= 1; // even layer: has a sphere even on flat ground
+
+            uint32_t first = 0, last = 0; // the cell's top sphere ends its last run
+            spheres.GetCellRuns(static_cast<uint16_t>(z * CHUNK_SIZE + x), first, last);
+            if (first == last) continue;
+            const int16_t surface = spheres.GetRunTop(last - 1);
+
+            int32_t step = 0;
+            auto neighbour = [&](int32_t nx, int32_t nz) {
+                if (nx < 0 || nz < 0 || nx >= CHUNK_SIZE || nz >= CHUNK_SIZE) return;
+                const int16_t n = chunk.GetSurfaceHeight(static_cast<uint8_t>(nx), static_cast<uint8_t>(nz));
+                if (n != Chunk::NO_SURFACE) step = std::max(step, std::abs(n - surface));
+            };
+            neighbour(x - 1, z); neighbour(x + 1, z);
+            neighbour(x, z - 1); neighbour(x, z + 1);
+
+            const float   wx      = static_cast<float>(coords.X * CHUNK_SIZE + x) * SPHERE_RADIUS;
+            const float   wz      = static_cast<float>(coords.Z * CHUNK_SIZE + z) * SPHERE_RADIUS;
+            const float   wy      = static_cast<float>(surface) * SPHERE_RADIUS;
+            const float   metres  = wy / FEATURE_SCALE;
+            const Variant variant = TerrainMaterial::VariantOf(spheres.GetRunMaterial(last - 1));
+
+            float tree = 0.0f;
+            if (variant != Variant::Rock && variant != Variant::Arid && step <= TREE_MAX_STEP
+                && metres > TREE_FROM && metres < TREE_LAST) {
+                tree = TREE_CHANCE * SmoothStep(FOREST_LOW, FOREST_HIGH, m_ForestNoise.GetNoise(wx, wz))
+                     * SmoothStep(TREE_FROM, TREE_FULL, metres) * (1.0f - SmoothStep(TREE_LINE, TREE_LAST, metres));
+                if (variant == Variant::Lush) tree = std::min(1.0f, tree * LUSH_BOOST);
+            }
+            float boulder = 0.0f;
+            if (step <= BOULDER_MAX_STEP && metres > BOULDER_FROM && metres < BOULDER_TO)
+                boulder = variant == Variant::Rock ? ROCK_BOULDER : BOULDER_CHANCE;
+
+            const float u = Unit(Next(h));
+            ScatterType type;
+            float       scale;
+            if (u < tree) {
+                type  = Unit(Next(h)) < SmoothStep(CONIFER_FROM, CONIFER_FULL, metres) ? ScatterType::Conifer
+                                                                                          : ScatterType::Broadleaf;
+                scale = 0.8f + 0.5f * Unit(Next(h));
+            } else if (u < tree + boulder) {
+                type  = ScatterType::Boulder;
+                scale = 0.5f + 0.9f * Unit(Next(h));
+            } else {
+                continue;
+            }
+
+            const uint8_t yaw  = static_cast<uint8_t>(Next(h) >> 24);
+            const uint8_t tint = static_cast<uint8_t>(Next(h) >> 24);
+            out.push_back(ScatterInstance::Make(wx, wy, wz, type, QuantiseScale(scale), yaw, tint));
+        }
+    }
+}
+
+// --- Prototypes ---
+
+void ScatterLayer::BuildPrototypes(std::vector<ScatterPrototypeSphere>& outSpheres,
+                                   std::array<ScatterPrototype, SCATTER_TYPES>& outPrototypes) {
+    const glm::vec3 BARK(0.36f, 0.25f, 0.15f);
+    const glm::vec3 LEAVES(0.22f, 0.45f, 0.13f);
+    const glm::vec3 NEEDLES(0.10f, 0.30f, 0.15f);
+    const glm::vec3 STONE(0.47f, 0.46f, 0.44f);
+    constexpr float TAU = 6.2831853f;
+
+    outSpheres.clear();
+    auto add = [&](glm::vec3 offset, float radius, glm::vec3 color) {
+        outSpheres.push_back({ glm::vec4(offset, radius), glm::vec4(color, 1.0f) });
+    };
+    auto finish = [&](ScatterType type, uint32_t first) {
+        ScatterPrototype& proto = outPrototypes[static_cast<size_t>(type)];
+        proto.First = first;
+        proto.Count = static_cast<uint32_t>(outSpheres.size()) - first;
+
+        float minY = 1e30f, maxY = -1e30f;
+        for (uint32_t i = first; i < outSpheres.size(); ++i) {
+            minY = std::min(minY, outSpheres[i].OffsetRadius.y - outSpheres[i].OffsetRadius.w);
+            maxY = std::max(maxY, outSpheres[i].OffsetRadius.y + outSpheres[i].OffsetRadius.w);
+        }
+        proto.BoundCenterY = 0.5f * (minY + maxY);
+        proto.BoundRadius  = 0.0f;
+        for (uint32_t i = first; i < outSpheres.size(); ++i) {
+            const glm::vec3 d = glm::vec3(outSpheres[i].OffsetRadius) - glm::vec3(0.0f, proto.BoundCenterY, 0.0f);
+            proto.BoundRadius = std::max(proto.BoundRadius, glm::length(d) + outSpheres[i].OffsetRadius.w);
+        }
+    };
+
+    // Broadleaf: trunk, then a hollow ellipsoid crown (the inside is never seen).
+    uint32_t first = static_cast<uint32_t>(outSpheres.size());
+    for (int32_t i = 0; i < 6; ++i) add({0.0f, 0.4f + 0.4f * i, 0.0f}, 0.25f, BARK);
+    {
+        const glm::vec3 centre(0.0f, 3.6f, 0.0f), radii(1.8f, 1.4f, 1.8f);
+        constexpr float SPACING = 0.6f;
+        for (int32_t iy = -3; iy <= 3; ++iy)
+            for (int32_t iz = -3; iz <= 3; ++iz)
+                for (int32_t ix = -3; ix <= 3; ++ix) {
+                    const glm::vec3 p(ix * SPACING, iy * SPACING, iz * SPACING);
+                    const glm::vec3 q = p / radii;
+                    const float     e = glm::dot(q, q);
+                    if (e > 1.0f || e < 0.45f) continue;
+                    add(centre + p, 0.5f, LEAVES * (0.85f + 0.15f * q.y)); // lighter on top
+                }
+    }
+    finish(ScatterType::Broadleaf, first);
+
+    // Conifer: trunk, then rings narrowing to the tip.
+    first = static_cast<uint32_t>(outSpheres.size());
+    for (int32_t i = 0; i < 4; ++i) add({0.0f, 0.4f + 0.4f * i, 0.0f}, 0.22f, BARK);
+    constexpr int32_t RINGS = 8;
+    for (int32_t t = 0; t < RINGS; ++t) {
+        const float y    = 1.4f + 0.55f * t;
+        const float ring = 1.5f * (1.0f - static_cast<float>(t) / RINGS);
+        add({0.0f, y, 0.0f}, 0.35f, NEEDLES);
+        const int32_t n = static_cast<int32_t>(TAU * ring / 0.6f);
+        for (int32_t j = 0; j < n; ++j) {
+            const float a = TAU * static_cast<float>(j) / n + 0.5f * t; // staggered between rings
+            add({ring * std::cos(a), y, ring * std::sin(a)}, 0.38f, NEEDLES);
+        }
+    }
+    add({0.0f, 1.4f + 0.55f * RINGS, 0.0f}, 0.3f, NEEDLES);
+    finish(ScatterType::Conifer, first);
+
+    // Boulder: a few overlapping spheres, partly sunk into the ground.
+    first = static_cast<uint32_t>(outSpheres.size());
+    add({ 0.0f,  0.20f,  0.0f}, 0.70f, STONE);
+    add({ 0.5f,  0.10f,  0.2f}, 0.50f, STONE * 0.95f);
+    add({-0.4f,  0.15f, -0.3f}, 0.55f, STONE * 1.05f);
+    add({ 0.1f,  0.55f, -0.1f}, 0.45f, STONE);
+    add({-0.2f,  0.05f,  0.5f}, 0.40f, STONE * 0.9f);
+    finish(ScatterType::Boulder, first);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "util/math/static_noise.hpp"
+#include "world/config.hpp"
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+class Chunk;
+class TerrainGenerator;
+
+// Kinds of scattered object; every instance of a kind is drawn from one prototype.
+enum class ScatterType : uint8_t { Broadleaf, Conifer, Boulder, Count };
+constexpr uint32_t SCATTER_TYPES = static_cast<uint32_t>(ScatterType::Count);
+
+// One placed object - matches scatter_culler.comp / scatter.vert std430 layout.
+// (X, Y, Z) is the world position of the prototype origin, at the foot of the object.
+struct ScatterInstance {
+    static constexpr float SCALE_STEP = 1.0f / 64.0f;
+
+    float    X, Y, Z;
+    uint32_t Packed; // bits 0..7 ScatterType, 8..15 scale (SCALE_STEP), 16..23 yaw (1/256 turn), 24..31 tint
+
+    static ScatterInstance Make(float x, float y, float z, ScatterType type,
+                                uint8_t scale, uint8_t yaw, uint8_t tint) noexcept {
+        return { x, y, z, static_cast<uint32_t>(type) | (uint32_t{scale} << 8)
+                        | (uint32_t{yaw} << 16) | (uint32_t{tint} << 24) };
+    }
+
+    ScatterType GetType() const noexcept { return static_cast<ScatterType>(Packed & 0xFFu); }
+    float       GetScale() const noexcept { return static_cast<float>((Packed >> 8) & 0xFFu) * SCALE_STEP; }
+};
+static_assert(sizeof(ScatterInstance) == 16, "ScatterInstance size mismatch with shader");
+static_assert(std::is_trivially_copyable_v<ScatterInstance>);
+
+// Sphere of a prototype, relative to the instance origin at scale 1 - matches scatter.vert.
+struct ScatterPrototypeSphere {
+    glm::vec4 OffsetRadius; // xyz = offset, w = radius
+    glm::vec4 Color;        // rgb, a = 1
+};
+static_assert(sizeof(ScatterPrototypeSphere) == 32, "ScatterPrototypeSphere size mismatch with shader");
+
+// Where a prototype sits in the shared sphere list, and its bounding sphere at scale 1
+// (centre BoundCenterY above the origin).
+struct ScatterPrototype {
+    uint32_t First = 0, Count = 0;
+    float    BoundCenterY = 0.0f, BoundRadius = 0.0f;
+};
+
+// Trees and boulders on the terrain, as instances of a few shared prototypes rather
+// than spheres in the chunk: a chunk carries a short instance list (16 bytes each) and
+// the renderer keeps one copy of each prototype, so neither memory nor draw calls grow
+// with how many spheres make up an object.
+//
+// One candidate per CELL x CELL block of cells, at a hashed cell of the block on the
+// even BCC layer (never skipped on flat ground). The candidate reads the top sphere of
+// its column: the height and material pick the type (broadleaf on the lowlands,
+// conifers higher up, boulders on rock and dry ground), a forest noise and the local
+// slope the odds. Everything is a function of the seed and the chunk's own surface, so
+// generated and loaded chunks agree and no instance crosses a chunk edge.
+// Thread-safe (const after construction).
+class ScatterLayer {
+public:
+    static constexpr int32_t  CELL          = 8; // cells per candidate block side
+    static constexpr uint32_t MAX_PER_CHUNK = (CHUNK_SIZE / CELL) * (CHUNK_SIZE / CELL);
+    static_assert(CHUNK_SIZE % CELL == 0 && CELL % 2 == 0, "candidate blocks must tile a chunk");
+
+    explicit ScatterLayer(const TerrainGenerator& terrain);
+
+    // Appends the instances standing on the chunk (at most MAX_PER_CHUNK). Reads the
+    // spheres only: LOD-only chunks get none.
+    void Populate(const Chunk& chunk, std::vector<ScatterInstance>& out) const;
+
+    // Geometry of every ScatterType (indexed by the type) in one shared sphere list.
+    static void BuildPrototypes(std::vector<ScatterPrototypeSphere>& outSpheres,
+                                std::array<ScatterPrototype, SCATTER_TYPES>& outPrototypes);
+
+private:
+    using ForestNoise = StaticNoise<NoiseKind::OpenSimplex2, NoiseLayer::Fractal::FBm, 2>;
+
+    ForestNoise m_ForestNoise; // woods vs clearings
+    int32_t     m_Seed;        // candidate placement and odds
+};
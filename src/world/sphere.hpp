@@ -48,6 +48,9 @@ struct SpherePosition {
 };
 
 struct Sphere { // CPU representation
+    // Low byte: TerrainMaterial palette index. High byte: type and flags (reserved).
+    static constexpr uint16_t MATERIAL_MASK = 0x00FF;
+
     uint16_t ChunkTypeAndFlags = 0;
     uint16_t AmbientOcclusion = 0;
     std::array<LightVector, 6> Lights;  // 6 direction +- (x,y,z)
@@ -55,11 +58,33 @@ struct Sphere { // CPU representation
 
     Sphere() = default;
     Sphere(uint8_t x, int16_t y, uint8_t z) : Position(x, y ,z){}
+    Sphere(uint8_t x, int16_t y, uint8_t z, uint8_t material) : ChunkTypeAndFlags(material), Position(x, y, z){}
+
+    uint8_t GetMaterial() const { return static_cast<uint8_t>(ChunkTypeAndFlags & MATERIAL_MASK); }
+    void SetMaterial(uint8_t material) {
+        ChunkTypeAndFlags = static_cast<uint16_t>((ChunkTypeAndFlags & ~MATERIAL_MASK) | material);
+    }
     
     void ToString(std::string& outStr) const;
 };
 static_assert(std::is_trivially_copyable_v<Sphere>);
 
+// One change of a Chunk::ApplyEdits batch: add Target as Chunk::AddSphere would, or
+// remove the sphere at Target.Position as Chunk::RemoveSphere would.
+struct SphereEdit {
+    enum class Action : uint8_t { Add, Remove };
+
+    Action Type = Action::Add;
+    Sphere Target;
+
+    static SphereEdit Add(const Sphere& sphere) { return { Action::Add, sphere }; }
+    static SphereEdit Remove(const SpherePosition pos) {
+        SphereEdit edit{ Action::Remove, Sphere() };
+        edit.Target.Position = pos;
+        return edit;
+    }
+};
+
 
 // GPU Layout (std140/std430 compatible if needed)
 struct GPUSphere {
@@ -77,7 +102,7 @@ static_assert(sizeof(GPUSphere) == 40, "GPUSphere size mismatch");
 struct CompactSphere {
     int16_t lx, ly, lz;   // local x/y/z in half-radius units (y is absolute world y)
     uint8_t lodStep;      // block size 1 / 2 / 4 / 8 -> world radius = lodStep * SPHERE_RADIUS
-    uint8_t color;        // palette index reserved for future material use
+    uint8_t color;        // TerrainMaterial palette index
 };
 static_assert(sizeof(CompactSphere) == 8, "CompactSphere size mismatch");
 static_assert(std::is_trivially_copyable_v<CompactSphere>);
\ No newline at end of file
@@ -0,0 +1,410 @@
+#include "world/sphere_columns.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+SphereColumns::SphereColumns(SphereColumns&& other) noexcept
+    : m_Runs(std::move(other.m_Runs)), m_Materials(std::move(other.m_Materials)),
+      m_Extras(other.m_Extras.exchange(nullptr, std::memory_order_acq_rel)), m_Count(other.m_Count),
+      m_Material(other.m_Material) {
+    other.m_Count = 0;
+}
+
+SphereColumns& SphereColumns::operator=(SphereColumns&& other) noexcept {
+    if (this == &other) return *this;
+    m_Runs      = std::move(other.m_Runs);
+    m_Materials = std::move(other.m_Materials);
+    delete m_Extras.exchange(other.m_Extras.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_acq_rel);
+    m_Count       = other.m_Count;
+    m_Material    = other.m_Material;
+    other.m_Count = 0;
+    return *this;
+}
+
+SphereColumns::~SphereColumns() {
+    ResetExtras();
+}
+
+void SphereColumns::Clear() {
+    m_Runs.clear();
+    m_Materials.clear();
+    ResetExtras();
+    m_Count    = 0;
+    m_Material = 0;
+}
+
+void SphereColumns::GetCellRuns(uint16_t cell, uint32_t& outFirst, uint32_t& outLast) const {
+    if (cell >= CHUNK_SIZE * CHUNK_SIZE) {
+        outFirst = outLast = RunCount();
+        return;
+    }
+    // Every run holds a sphere, so the cell's first run is at most its first sphere index.
+    // Without the offset table search them all rather than build it.
+    const Extras*      extras  = LoadExtras();
+    const CellOffsets* offsets = extras ? extras->Offsets.load(std::memory_order_acquire) : nullptr;
+    const uint32_t bound = offsets ? std::min(RunCount(), (*offsets)[cell] + 1) : RunCount();
+    const auto end   = m_Runs.begin() + bound;
+    const auto first = std::lower_bound(m_Runs.begin(), end, cell,
+                                        [](const Run& run, uint16_t c) { return run.Cell < c; });
+    auto last = first;
+    while (last != m_Runs.end() && last->Cell == cell) ++last;
+    outFirst = static_cast<uint32_t>(first - m_Runs.begin());
+    outLast  = static_cast<uint32_t>(last - m_Runs.begin());
+}
+
+// --- Building ---
+
+void SphereColumns::Reserve(uint32_t runs) {
+    m_Runs.reserve(runs);
+}
+
+void SphereColumns::AppendRun(uint16_t cell, int16_t top, uint32_t depth, uint16_t flags) {
+    if (depth == 0) return;
+    DropCellOffsets();
+    m_Count += depth;
+
+    int32_t bottom = top - static_cast<int32_t>(depth) + 1;
+
+    // Continue the last run: same cell and flags, starting right above it.
+    if (!m_Runs.empty()) {
+        Run& last = m_Runs.back();
+        if (last.Cell == cell && last.Top + 1 == bottom && GetRunFlags(RunCount() - 1) == flags) {
+            const uint32_t take = std::min(depth, MAX_DEPTH - last.Depth);
+            last.Depth = static_cast<uint8_t>(last.Depth + take);
+            last.Top   = static_cast<int16_t>(last.Top + take);
+            bottom += static_cast<int32_t>(take);
+            depth  -= take;
+        }
+    }
+    while (depth > 0) {
+        const uint32_t take = std::min(depth, MAX_DEPTH);
+        PushRun(cell, static_cast<int16_t>(bottom + static_cast<int32_t>(take) - 1), take, flags);
+        bottom += static_cast<int32_t>(take);
+        depth  -= take;
+    }
+}
+
+bool SphereColumns::AppendSphere(const SpherePosition pos, uint16_t flags) {
+    if (pos.CellIndex >= CHUNK_SIZE * CHUNK_SIZE) return false;
+    if (!m_Runs.empty() && (pos.CellIndex < m_Runs.back().Cell ||
+                            (pos.CellIndex == m_Runs.back().Cell && pos.DiscreteHeight <= m_Runs.back().Top)))
+        return false;
+
+    AppendRun(pos.CellIndex, pos.DiscreteHeight, 1, flags);
+    return true;
+}
+
+void SphereColumns::ShrinkToFit() {
+    m_Runs.shrink_to_fit();
+    m_Materials.shrink_to_fit();
+    DropCellOffsets();
+    if (!HasTypes() && !HasShading()) ResetExtras(); // held only the offsets
+    if (Extras* extras = LoadExtras()) {
+        extras->Types.shrink_to_fit();
+        extras->Shades.shrink_to_fit();
+    }
+}
+
+void SphereColumns::WriteRecords(uint8_t* dst) const {
+    // Every record is assembled in place from its fields. Locals, as dst may alias any member.
+    const uint32_t runs = RunCount();
+    for (uint32_t run = 0; run < runs; ++run) {
+        const uint16_t flags = GetRunFlags(run);
+        const int32_t  top   = m_Runs[run].Top;
+        SpherePosition pos;
+        pos.CellIndex = m_Runs[run].Cell;
+        for (int32_t y = GetRunBottom(run); y <= top; ++y) {
+            pos.DiscreteHeight = static_cast<int16_t>(y);
+            std::memcpy(dst, &flags, sizeof(flags));
+            std::memcpy(dst + sizeof(flags), &pos, sizeof(pos));
+            dst += RECORD_SIZE;
+        }
+    }
+}
+
+void SphereColumns::WriteShading(uint8_t* dst) const {
+    const std::span<const ShadedSphere> shades = GetShading();
+    if (!shades.empty()) std::memcpy(dst, shades.data(), shades.size_bytes());
+}
+
+// --- Shading ---
+
+const SphereColumns::ShadedSphere* SphereColumns::FindShading(const SpherePosition pos) const {
+    const std::span<const ShadedSphere> shades = GetShading();
+    const auto it = std::lower_bound(shades.begin(), shades.end(), pos,
+                                     [](const ShadedSphere& e, const SpherePosition& p) { return e.Position < p; });
+    return it != shades.end() && it->Position == pos ? &*it : nullptr;
+}
+
+bool SphereColumns::SetShading(const ShadedSphere& entry) {
+    uint32_t index;
+    if (!Find(entry.Position, index)) return false;
+
+    const bool shaded = IsShaded(entry.AmbientOcclusion, entry.Lights);
+    if (!shaded && !HasShading()) return true;
+
+    const auto it = LowerShade(entry.Position);
+    std::vector<ShadedSphere>& shades = LoadExtras()->Shades;
+    const bool has = it != shades.end() && it->Position == entry.Position;
+    if (!shaded) {
+        if (has) shades.erase(it);
+    } else if (has) {
+        *it = entry;
+    } else {
+        shades.insert(it, entry);
+    }
+    return true;
+}
+
+// --- Lookup and edits ---
+
+const SphereColumns::CellOffsets& SphereColumns::PublishCellOffsets() const {
+    Extras* extras = LoadExtras();
+    if (!extras) {
+        // Publish an empty block; a reader that got there first keeps its own.
+        auto fresh = std::make_unique<Extras>();
+        if (m_Extras.compare_exchange_strong(extras, fresh.get(), std::memory_order_acq_rel))
+            extras = fresh.release();
+    }
+
+    // Spheres per cell, shifted one up, then summed into each cell's first index.
+    auto table = std::make_unique<CellOffsets>(); // zeroed
+    CellOffsets& offsets = *table;
+    for (const Run& run : m_Runs) offsets[run.Cell + 1u] += run.Depth;
+    for (size_t c = 1; c < offsets.size(); ++c) offsets[c] += offsets[c - 1];
+
+    // Concurrent builders made the same table: keep whichever was published first.
+    CellOffsets* published = nullptr;
+    if (extras->Offsets.compare_exchange_strong(published, table.get(), std::memory_order_acq_rel))
+        return *table.release();
+    return *published;
+}
+
+bool SphereColumns::Find(const SpherePosition pos, uint32_t& outIndex) const {
+    if (pos.CellIndex >= CHUNK_SIZE * CHUNK_SIZE) {
+        outIndex = m_Count;
+        return false;
+    }
+    uint32_t first, last;
+    GetCellRuns(pos.CellIndex, first, last);
+
+    uint32_t index = GetCellOffset(pos.CellIndex);
+    for (uint32_t run = first; run < last; ++run) {
+        const int16_t bottom = GetRunBottom(run);
+        if (pos.DiscreteHeight < bottom) break;
+        if (pos.DiscreteHeight <= m_Runs[run].Top) {
+            outIndex = index + static_cast<uint32_t>(pos.DiscreteHeight - bottom);
+            return true;
+        }
+        index += m_Runs[run].Depth;
+    }
+    outIndex = index;
+    return false;
+}
+
+bool SphereColumns::Insert(const Sphere& sphere) {
+    const SpherePosition& pos = sphere.Position;
+    if (pos.CellIndex >= CHUNK_SIZE * CHUNK_SIZE) return false;
+
+    uint32_t index;
+    if (Find(pos, index)) return false;
+
+    uint32_t first, last;
+    GetCellRuns(pos.CellIndex, first, last);
+    std::vector<Entry> entries;
+    DecodeCell(first, last, entries);
+    const auto at = std::lower_bound(entries.begin(), entries.end(), pos.DiscreteHeight,
+                                     [](const Entry& e, int16_t h) { return e.Height < h; });
+    entries.insert(at, Entry{ pos.DiscreteHeight, sphere.ChunkTypeAndFlags });
+    ReplaceCell(pos.CellIndex, first, last, entries);
+
+    CellOffsets& offsets = *LoadExtras()->Offsets.load(std::memory_order_relaxed); // built by Find
+    for (size_t c = pos.CellIndex + 1u; c < offsets.size(); ++c) ++offsets[c];
+    ++m_Count;
+
+    if (IsShaded(sphere.AmbientOcclusion, sphere.Lights)) {
+        const auto it = LowerShade(pos);
+        LoadExtras()->Shades.insert(it, { pos, sphere.AmbientOcclusion, sphere.Lights });
+    }
+    return true;
+}
+
+bool SphereColumns::Erase(const SpherePosition pos) {
+    uint32_t index;
+    if (!Find(pos, index)) return false;
+
+    uint32_t first, last;
+    GetCellRuns(pos.CellIndex, first, last);
+    std::vector<Entry> entries;
+    DecodeCell(first, last, entries);
+    entries.erase(std::find_if(entries.begin(), entries.end(),
+                               [&](const Entry& e) { return e.Height == pos.DiscreteHeight; }));
+    ReplaceCell(pos.CellIndex, first, last, entries);
+
+    CellOffsets& offsets = *LoadExtras()->Offsets.load(std::memory_order_relaxed); // built by Find
+    for (size_t c = pos.CellIndex + 1u; c < offsets.size(); ++c) --offsets[c];
+    --m_Count;
+
+    if (HasShading()) {
+        const auto it = LowerShade(pos);
+        std::vector<ShadedSphere>& shades = LoadExtras()->Shades;
+        if (it != shades.end() && it->Position == pos) shades.erase(it);
+    }
+    return true;
+}
+
+void SphereColumns::Merge(std::span<const SphereEdit> sorted, CellMask& outTouched, uint32_t& outAdded,
+                          uint32_t& outRemoved) {
+    constexpr uint16_t CELLS = CHUNK_SIZE * CHUNK_SIZE;
+    const std::span<const ShadedSphere> shades = GetShading();
+    const Extras* extras  = LoadExtras();
+    const bool    indexed = extras && extras->Offsets.load(std::memory_order_relaxed);
+
+    SphereColumns merged;
+    merged.Reserve(RunCount() + static_cast<uint32_t>(sorted.size()));
+    std::vector<Sphere> column;
+    uint32_t run   = 0;
+    size_t   shade = 0;
+    size_t   edit  = 0;
+
+    while (run < RunCount() || edit < sorted.size()) {
+        // Next cell with spheres or edits; edits of invalid cells sort last and are dropped.
+        uint16_t cell = run < RunCount() ? m_Runs[run].Cell : CELLS;
+        if (edit < sorted.size()) cell = std::min(cell, sorted[edit].Target.Position.CellIndex);
+        if (cell >= CELLS) break;
+
+        uint32_t lastRun = run;
+        while (lastRun < RunCount() && m_Runs[lastRun].Cell == cell) ++lastRun;
+        size_t lastEdit = edit;
+        while (lastEdit < sorted.size() && sorted[lastEdit].Target.Position.CellIndex == cell) ++lastEdit;
+
+        if (edit == lastEdit) { // untouched: runs and shading as they are
+            for (; run < lastRun; ++run) merged.AppendRun(cell, m_Runs[run].Top, m_Runs[run].Depth, GetRunFlags(run));
+            for (; shade < shades.size() && shades[shade].Position.CellIndex == cell; ++shade)
+                merged.GetExtras().Shades.push_back(shades[shade]);
+            continue;
+        }
+
+        column.clear();
+        for (; run < lastRun; ++run) {
+            Sphere sphere;
+            LoadRun(run, sphere);
+            for (uint32_t step = 0; step < m_Runs[run].Depth; ++step) {
+                if (shade < shades.size() && shades[shade].Position == sphere.Position) {
+                    sphere.AmbientOcclusion = shades[shade].AmbientOcclusion;
+                    sphere.Lights           = shades[shade].Lights;
+                    ++shade;
+                } else {
+                    sphere.AmbientOcclusion = 0;
+                    sphere.Lights           = {};
+                }
+                column.push_back(sphere);
+                ++sphere.Position.DiscreteHeight;
+            }
+        }
+
+        // Both lists are sorted by height: keep the column's spheres, replay each height's edits.
+        size_t i = 0;
+        while (i < column.size() || edit < lastEdit) {
+            if (edit == lastEdit ||
+                (i < column.size() && column[i].Position.DiscreteHeight < sorted[edit].Target.Position.DiscreteHeight)) {
+                merged.Append(column[i++]);
+                continue;
+            }
+            const int16_t height  = sorted[edit].Target.Position.DiscreteHeight;
+            const Sphere* current = nullptr;
+            if (i < column.size() && column[i].Position.DiscreteHeight == height) current = &column[i++];
+            for (; edit < lastEdit && sorted[edit].Target.Position.DiscreteHeight == height; ++edit) {
+                if (sorted[edit].Type == SphereEdit::Action::Add) {
+                    if (current) continue;
+                    current = &sorted[edit].Target;
+                    ++outAdded;
+                } else {
+                    if (!current) continue;
+                    current = nullptr;
+                    ++outRemoved;
+                }
+                outTouched.set(cell);
+            }
+            if (current) merged.Append(*current);
+        }
+    }
+
+    merged.ShrinkToFit();
+    *this = std::move(merged);
+    // A chunk that is being looked up keeps its table: one pass now rather than in the next lookup.
+    if (indexed) BuildCellOffsets();
+}
+
+size_t SphereColumns::GetMemoryUsage() const {
+    size_t bytes = sizeof(*this) + m_Runs.capacity() * sizeof(Run) + m_Materials.capacity();
+    if (const Extras* extras = LoadExtras())
+        bytes += sizeof(Extras) + extras->Types.capacity() + extras->Shades.capacity() * sizeof(ShadedSphere)
+               + (extras->Offsets.load(std::memory_order_acquire) ? sizeof(CellOffsets) : 0);
+    return bytes;
+}
+
+// --- Internals ---
+
+std::vector<SphereColumns::ShadedSphere>::iterator SphereColumns::LowerShade(const SpherePosition pos) {
+    std::vector<ShadedSphere>& shades = GetExtras().Shades;
+    return std::lower_bound(shades.begin(), shades.end(), pos,
+                            [](const ShadedSphere& e, const SpherePosition& p) { return e.Position < p; });
+}
+
+void SphereColumns::DecodeCell(uint32_t first, uint32_t last, std::vector<Entry>& outEntries) const {
+    for (uint32_t run = first; run < last; ++run)
+        for (int32_t h = GetRunBottom(run); h <= m_Runs[run].Top; ++h)
+            outEntries.push_back({ static_cast<int16_t>(h), GetRunFlags(run) });
+}
+
+void SphereColumns::PushRun(uint16_t cell, int16_t top, uint32_t depth, uint16_t flags) {
+    const uint8_t type = static_cast<uint8_t>(flags >> 8);
+    if (type != 0 || HasTypes()) {
+        std::vector<uint8_t>& types = GetExtras().Types;
+        types.resize(m_Runs.size()); // first non-zero type: zeros for the runs before
+        types.push_back(type);
+    }
+
+    const uint8_t material = static_cast<uint8_t>(flags & Sphere::MATERIAL_MASK);
+    if (m_Materials.empty()) {
+        if (m_Runs.empty()) {
+            m_Material = material;
+        } else if (material != m_Material) { // second material: one per run from here on
+            m_Materials.reserve(m_Runs.capacity());
+            m_Materials.assign(m_Runs.size(), m_Material);
+        }
+    }
+    if (!m_Materials.empty()) m_Materials.push_back(material);
+
+    m_Runs.push_back({ top, static_cast<uint8_t>(cell), static_cast<uint8_t>(depth) });
+}
+
+void SphereColumns::ReplaceCell(uint16_t cell, uint32_t first, uint32_t last, const std::vector<Entry>& entries) {
+    // Re-encode the cell on its own, then splice its runs over the old ones.
+    SphereColumns encoded;
+    for (const Entry& e : entries) encoded.AppendRun(cell, e.Height, 1, e.Flags);
+
+    auto splice = [first, last](auto& dst, const auto& src) {
+        dst.erase(dst.begin() + first, dst.begin() + last);
+        dst.insert(dst.begin() + first, src.begin(), src.end());
+    };
+    if (HasTypes() || encoded.HasTypes()) { // an empty side is all zero
+        std::vector<uint8_t>& types        = GetExtras().Types;
+        std::vector<uint8_t>& encodedTypes = encoded.GetExtras().Types;
+        types.resize(m_Runs.size());
+        encodedTypes.resize(encoded.m_Runs.size());
+        splice(types, encodedTypes);
+    }
+    if (RunCount() == last - first) { // the cell is all there is: take its materials as they are
+        m_Material  = encoded.m_Material;
+        m_Materials = std::move(encoded.m_Materials);
+    } else if (!m_Materials.empty() || !encoded.m_Materials.empty() ||
+               (!encoded.m_Runs.empty() && encoded.m_Material != m_Material)) {
+        if (m_Materials.empty()) m_Materials.assign(m_Runs.size(), m_Material);
+        if (encoded.m_Materials.empty()) encoded.m_Materials.assign(encoded.m_Runs.size(), encoded.m_Material);
+        splice(m_Materials, encoded.m_Materials);
+    }
+    splice(m_Runs, encoded.m_Runs);
+}
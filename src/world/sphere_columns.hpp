@@ -0,0 +1,313 @@
+#pragma once
+
+#include "world/config.hpp"
+#include "world/sphere.hpp"
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// A chunk's spheres stored as vertical runs instead of one 26-byte Sphere each.
+//
+// A run is a stack of spheres at consecutive discrete heights in one cell that share
+// ChunkTypeAndFlags: its cell, top height and depth (sphere count) in 4 bytes. A
+// generated column is a single run, so a chunk costs 4-5 bytes per column rather than
+// 26 per sphere; caves, overhangs, material changes and edits split a column into
+// several runs, and a run deeper than MAX_DEPTH continues in the next one.
+//
+// Runs are sorted by cell, then height. Iterating yields every sphere as a Sphere value
+// in that order - CellIndex, then DiscreteHeight - and sphere indices (GetCellRange,
+// Find) count in it, exactly as in the sorted std::vector<Sphere> this replaces.
+//
+// A prefix-offset table holds the index of the first sphere of every cell, so a cell's
+// sphere range is two reads. It costs ~1 KB, more than the runs of a generated chunk,
+// so it is built lazily: by the first GetCellRange / Find / edit, from the runs in one
+// pass. Insert / Erase / Merge keep it up to date; appends and ShrinkToFit drop it, so
+// chunks that are only generated or loaded, drawn and saved never hold one. Const
+// lookups may build it from several threads at once: the table (and the Extras block
+// holding it) is published with a compare-exchange, and the first one built wins.
+//
+// Attributes live in separate arrays that stay empty while they carry nothing:
+//   materials (low byte of ChunkTypeAndFlags), per run - empty while every run has the same one
+//   types (high byte of ChunkTypeAndFlags), per run  - empty while all are zero
+//   AmbientOcclusion and Lights                      - sparse: only spheres that have any
+// Once filled, the per-run arrays stay filled until Clear. Types, shading and the offset
+// table are rare enough to sit behind one pointer, allocated by the first chunk that
+// needs them.
+//
+// The shading table is keyed by SpherePosition and kept in sphere order, so it survives
+// edits of other spheres untouched and is walked alongside the runs (the iterator,
+// WriteShading, Chunk::GenerateMesh). A sphere without an entry has AO 0 and dark lights.
+class SphereColumns {
+public:
+    static constexpr uint32_t MAX_DEPTH = 255;
+    static_assert(CHUNK_SIZE * CHUNK_SIZE <= 256, "run cells are stored in a byte");
+
+    using CellMask = std::bitset<CHUNK_SIZE * CHUNK_SIZE>; // bit per CellIndex
+
+    // One entry of the shading table; also its on-disk record.
+    struct ShadedSphere {
+        SpherePosition             Position;
+        uint16_t                   AmbientOcclusion = 0;
+        std::array<LightVector, 6> Lights;
+    };
+    static_assert(sizeof(ShadedSphere) == 24 && std::is_trivially_copyable_v<ShadedSphere>);
+
+    // Sphere record without the shading (the save format): ChunkTypeAndFlags, Position.
+    static constexpr size_t RECORD_SIZE = sizeof(uint16_t) + sizeof(SpherePosition);
+
+    // Forward iterator over the spheres, lowest sphere of the first cell first. It
+    // dereferences to a Sphere it assembles itself: valid until the iterator moves on.
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Sphere;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Sphere*;
+        using reference         = const Sphere&;
+
+        Iterator() = default;
+
+        const Sphere& operator*() const { return m_Sphere; }
+        const Sphere* operator->() const { return &m_Sphere; }
+
+        Iterator& operator++() {
+            ++m_Index;
+            if (++m_Step == m_Columns->m_Runs[m_Run].Depth) {
+                m_Step = 0;
+                ++m_Run;
+                m_Columns->LoadRun(m_Run, m_Sphere);
+            } else {
+                ++m_Sphere.Position.DiscreteHeight;
+            }
+            m_Columns->LoadShading(m_Shade, m_Sphere);
+            return *this;
+        }
+        Iterator operator++(int) { Iterator old = *this; ++*this; return old; }
+
+        bool operator==(const Iterator& other) const { return m_Index == other.m_Index; }
+
+        uint32_t GetIndex() const { return m_Index; }
+
+    private:
+        friend class SphereColumns;
+        Iterator(const SphereColumns* columns, uint32_t run, uint32_t index)
+            : m_Columns(columns), m_Run(run), m_Index(index) {
+            m_Columns->LoadRun(m_Run, m_Sphere);
+            if (m_Index < m_Columns->m_Count) m_Columns->LoadShading(m_Shade, m_Sphere);
+        }
+
+        const SphereColumns* m_Columns = nullptr;
+        uint32_t m_Run   = 0;
+        uint32_t m_Step  = 0; // spheres above the bottom of the run
+        uint32_t m_Index = 0; // sphere index
+        uint32_t m_Shade = 0; // next shading table entry
+        Sphere   m_Sphere;
+    };
+
+    SphereColumns() = default;
+    SphereColumns(SphereColumns&& other) noexcept;
+    SphereColumns& operator=(SphereColumns&& other) noexcept;
+    ~SphereColumns();
+
+    Iterator begin() const { return Iterator(this, 0, 0); }
+    Iterator end() const { return Iterator(this, RunCount(), m_Count); }
+
+    uint32_t GetSize() const { return m_Count; }
+    bool     IsEmpty() const { return m_Count == 0; }
+    void     Clear();
+
+    // --- Runs ---
+    uint32_t RunCount() const { return static_cast<uint32_t>(m_Runs.size()); }
+    uint16_t GetRunCell(uint32_t run) const { return m_Runs[run].Cell; }
+    int16_t  GetRunTop(uint32_t run) const { return m_Runs[run].Top; }
+    uint32_t GetRunDepth(uint32_t run) const { return m_Runs[run].Depth; }
+    int16_t  GetRunBottom(uint32_t run) const { return static_cast<int16_t>(m_Runs[run].Top - m_Runs[run].Depth + 1); }
+    uint8_t  GetRunMaterial(uint32_t run) const { return m_Materials.empty() ? m_Material : m_Materials[run]; }
+    uint16_t GetRunFlags(uint32_t run) const {
+        const uint16_t type = HasTypes() ? static_cast<uint16_t>(LoadExtras()->Types[run] << 8) : 0;
+        return static_cast<uint16_t>(type | GetRunMaterial(run));
+    }
+
+    // Runs of a cell: [outFirst, outLast), empty if the cell has no sphere.
+    void GetCellRuns(uint16_t cell, uint32_t& outFirst, uint32_t& outLast) const;
+
+    // Index of the first sphere of cell, for cell in [0, CHUNK_SIZE * CHUNK_SIZE]:
+    // the table is the chunk's CHUNK_SIZE * CHUNK_SIZE + 1 prefix offsets.
+    uint32_t GetCellOffset(uint16_t cell) const { return GetCellOffsets()[cell]; }
+    // Builds the offset table now if it is not built yet.
+    void BuildCellOffsets() const { GetCellOffsets(); }
+
+    // --- Building (generation, loading) ---
+    // Spheres must arrive in sorted order, after everything already stored.
+    // AppendRun adds depth spheres from top - depth + 1 up to top, continuing the last
+    // run where it can. Append returns false (and adds nothing) for an out-of-order sphere;
+    // the (pos, flags) overload adds an unshaded one.
+    void Reserve(uint32_t runs);
+    void AppendRun(uint16_t cell, int16_t top, uint32_t depth, uint16_t flags);
+    bool Append(const SpherePosition pos, uint16_t flags) {
+        // Fast path: the next sphere up the last run.
+        if (!m_Runs.empty()) {
+            Run& last = m_Runs.back();
+            if (pos.CellIndex == last.Cell && pos.DiscreteHeight == last.Top + 1 && last.Depth < MAX_DEPTH &&
+                flags == GetRunFlags(RunCount() - 1)) {
+                ++last.Top;
+                ++last.Depth;
+                ++m_Count;
+                DropCellOffsets();
+                return true;
+            }
+        }
+        return AppendSphere(pos, flags);
+    }
+    bool Append(const Sphere& sphere) {
+        if (!Append(sphere.Position, sphere.ChunkTypeAndFlags)) return false;
+        if (IsShaded(sphere.AmbientOcclusion, sphere.Lights))
+            GetExtras().Shades.push_back({ sphere.Position, sphere.AmbientOcclusion, sphere.Lights });
+        return true;
+    }
+    void ShrinkToFit();
+
+    // Writes every sphere as a RECORD_SIZE record (the save format), in order:
+    // GetSize() * RECORD_SIZE bytes, no alignment needed. The shading table follows
+    // separately, GetShading().size() * sizeof(ShadedSphere) bytes. ReadRecord reads one back.
+    void WriteRecords(uint8_t* dst) const;
+    void WriteShading(uint8_t* dst) const;
+    static void ReadRecord(const uint8_t* src, uint16_t& outFlags, SpherePosition& outPos) {
+        std::memcpy(&outFlags, src, sizeof(outFlags));
+        std::memcpy(&outPos, src + sizeof(outFlags), sizeof(outPos));
+    }
+
+    // --- Shading (AO and lights) ---
+    // Entries sorted by position, one per sphere with non-zero shading.
+    std::span<const ShadedSphere> GetShading() const {
+        const Extras* extras = LoadExtras();
+        if (!extras) return {};
+        return extras->Shades;
+    }
+    // Entry of the sphere at pos; nullptr if it is unshaded (or does not exist).
+    const ShadedSphere* FindShading(const SpherePosition pos) const;
+    // Sets the shading of an existing sphere, zero shading removes its entry.
+    // False if there is no sphere at entry.Position.
+    bool SetShading(const ShadedSphere& entry);
+
+    // --- Lookup and edits ---
+    // Index of the sphere at pos if it exists; otherwise false and the index it would be
+    // inserted at.
+    bool Find(const SpherePosition pos, uint32_t& outIndex) const;
+    // Sphere index range of a cell, from the offset table; false if the cell has no sphere.
+    bool GetCellRange(uint16_t cell, uint32_t& outOffset, uint32_t& outSize) const {
+        if (cell >= CHUNK_SIZE * CHUNK_SIZE) return false;
+        const CellOffsets& offsets = GetCellOffsets();
+        outOffset = offsets[cell];
+        outSize   = offsets[cell + 1u] - outOffset;
+        return outSize != 0;
+    }
+    // Sorted insert / removal. False if the sphere already exists / does not exist.
+    bool Insert(const Sphere& sphere);
+    bool Erase(const SpherePosition pos);
+    // Applies a batch sorted by Target.Position - stably, so edits of one sphere keep
+    // their order - in one pass: untouched cells are copied run by run, touched ones
+    // decoded and replayed edit by edit with Insert / Erase semantics. Counts the edits
+    // that took effect and sets the cells they changed in outTouched.
+    void Merge(std::span<const SphereEdit> sorted, CellMask& outTouched, uint32_t& outAdded, uint32_t& outRemoved);
+
+    // Heap bytes held by the runs and the shading table, plus the object itself.
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Run {
+        int16_t Top;   // DiscreteHeight of the top sphere
+        uint8_t Cell;  // CellIndex
+        uint8_t Depth; // 1..MAX_DEPTH spheres
+    };
+    static_assert(sizeof(Run) == 4);
+
+    struct Entry { int16_t Height; uint16_t Flags; };
+
+    // Iterator helpers: the bottom sphere of a run (nothing past the last run), and the
+    // shading of the sphere out holds, taken from table entry shade if it is that sphere's.
+    void LoadRun(uint32_t run, Sphere& out) const {
+        if (run >= RunCount()) return;
+        out.ChunkTypeAndFlags       = GetRunFlags(run);
+        out.Position.CellIndex      = m_Runs[run].Cell;
+        out.Position.DiscreteHeight = GetRunBottom(run);
+    }
+    void LoadShading(uint32_t& shade, Sphere& out) const {
+        if (!HasShading()) return;
+        const std::vector<ShadedSphere>& shades = LoadExtras()->Shades;
+        if (shade < shades.size() && shades[shade].Position == out.Position) {
+            out.AmbientOcclusion = shades[shade].AmbientOcclusion;
+            out.Lights           = shades[shade].Lights;
+            ++shade;
+        } else {
+            out.AmbientOcclusion = 0;
+            out.Lights           = {};
+        }
+    }
+    // Replaces runs [first, last) of cell with the runs of entries (sorted by height).
+    void     ReplaceCell(uint16_t cell, uint32_t first, uint32_t last, const std::vector<Entry>& entries);
+    void     DecodeCell(uint32_t first, uint32_t last, std::vector<Entry>& outEntries) const;
+    void     PushRun(uint16_t cell, int16_t top, uint32_t depth, uint16_t flags);
+    bool     AppendSphere(const SpherePosition pos, uint16_t flags);
+    void     DropCellOffsets() {
+        if (Extras* extras = LoadExtras()) delete extras->Offsets.exchange(nullptr, std::memory_order_relaxed);
+    }
+
+    using CellOffsets = std::array<uint32_t, CHUNK_SIZE * CHUNK_SIZE + 1>;
+    struct Extras {
+        std::vector<uint8_t> Types;  // per run, or empty when all are zero
+        std::vector<ShadedSphere> Shades; // sorted by position, shaded spheres only
+        std::atomic<CellOffsets*> Offsets = nullptr; // owned; null until built, see GetCellOffsets
+
+        ~Extras() { delete Offsets.load(std::memory_order_relaxed); }
+    };
+    // The offset table, built (and published) by the first call.
+    const CellOffsets& GetCellOffsets() const {
+        if (const Extras* extras = LoadExtras())
+            if (const CellOffsets* offsets = extras->Offsets.load(std::memory_order_acquire)) return *offsets;
+        return PublishCellOffsets();
+    }
+    const CellOffsets& PublishCellOffsets() const;
+    // Acquire: a block published by a const lookup on another thread is complete.
+    Extras* LoadExtras() const { return m_Extras.load(std::memory_order_acquire); }
+    bool    HasTypes() const {
+        const Extras* extras = LoadExtras();
+        return extras && !extras->Types.empty();
+    }
+    bool    HasShading() const {
+        const Extras* extras = LoadExtras();
+        return extras && !extras->Shades.empty();
+    }
+    Extras& GetExtras() {
+        Extras* extras = LoadExtras();
+        if (!extras) {
+            extras = new Extras();
+            m_Extras.store(extras, std::memory_order_release);
+        }
+        return *extras;
+    }
+    void    ResetExtras() { delete m_Extras.exchange(nullptr, std::memory_order_acq_rel); }
+
+    static bool IsShaded(uint16_t ambientOcclusion, const std::array<LightVector, 6>& lights) {
+        static constexpr uint8_t DARK[sizeof(Sphere::Lights)] = {};
+        return ambientOcclusion != 0 || std::memcmp(lights.data(), DARK, sizeof(DARK)) != 0;
+    }
+    // Shading table entry at pos, or where it would go (allocates the table).
+    std::vector<ShadedSphere>::iterator LowerShade(const SpherePosition pos);
+
+private:
+    std::vector<Run>        m_Runs;
+    std::vector<uint8_t>    m_Materials; // per run, or empty when all are m_Material
+    // Owned; null until a run has a type, a sphere is shaded or a lookup needs offsets.
+    mutable std::atomic<Extras*> m_Extras = nullptr;
+    uint32_t m_Count    = 0;
+    uint8_t  m_Material = 0;
+};
@@ -0,0 +1,131 @@
+#include "world/terrain_bounds.hpp"
+#include "world/region_handler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float CHUNK_WORLD = CHUNK_SIZE * SPHERE_RADIUS;
+
+    // Corner-node grid of one region plus one node of context on every side,
+    // so the height steps around edge chunks are known too.
+    constexpr int32_t NODES = REGION_SIZE + 3;
+
+    // Share of the largest neighbouring corner-to-corner step that a peak or pit
+    // between samples can add (measured max 0.573 over ~50k chunks).
+    constexpr float STEP_FACTOR = 0.75f;
+
+    // Discretised surface and fill spheres reach 3 radii below / 2 radii above the
+    // sampled height; one more radius covers Cached sampling error and rounding.
+    constexpr float SLACK_BELOW = 4.0f * SPHERE_RADIUS;
+    constexpr float SLACK_ABOVE = 3.0f * SPHERE_RADIUS;
+
+    inline int32_t FloorDiv(int32_t a, int32_t b) noexcept {
+        return a / b - (a % b != 0 && (a ^ b) < 0 ? 1 : 0);
+    }
+}
+
+TerrainBounds::TerrainBounds(const TerrainGenerator& terrain, size_t capacity, Range postPass)
+    : m_Terrain(terrain), m_PostPass(postPass), m_Capacity(std::max<size_t>(capacity, 1)) {}
+
+TerrainBounds::Range TerrainBounds::GetBlockRange(ChunkCoordinates chunk, uint32_t level) {
+    level = std::min(level, LEVELS - 1);
+    const ChunkCoordinates region = RegionHandler::ChunkToRegion(chunk);
+    const Pyramid& pyramid = GetPyramid(region.X, region.Z);
+
+    const int32_t side = REGION_SIZE >> level;
+    const int32_t bx   = (chunk.X - region.X * REGION_SIZE) >> level;
+    const int32_t bz   = (chunk.Z - region.Z * REGION_SIZE) >> level;
+    return pyramid.Levels[level][bz * side + bx];
+}
+
+BoundBox TerrainBounds::GetBlockBounds(ChunkCoordinates chunk, uint32_t level) {
+    level = std::min(level, LEVELS - 1);
+    const Range   range = GetBlockRange(chunk, level);
+    const int32_t size  = 1 << level;
+    const int32_t baseX = FloorDiv(chunk.X, size) * size * static_cast<int32_t>(CHUNK_SIZE);
+    const int32_t baseZ = FloorDiv(chunk.Z, size) * size * static_cast<int32_t>(CHUNK_SIZE);
+    const int32_t span  = size * static_cast<int32_t>(CHUNK_SIZE);
+
+    // Same XZ extent ChunkGenerator::InitBounds gives a chunk, stretched over the block.
+    return BoundBox(SPHERE_RADIUS * static_cast<float>(baseX - 1), SPHERE_RADIUS * static_cast<float>(baseX + span),
+                    range.Min, range.Max,
+                    SPHERE_RADIUS * static_cast<float>(baseZ - 1), SPHERE_RADIUS * static_cast<float>(baseZ + span));
+}
+
+const TerrainBounds::Pyramid& TerrainBounds::GetPyramid(int32_t regionX, int32_t regionZ) {
+    const uint64_t id = RegionHandler::MakeID(regionX, regionZ);
+    auto it = m_Pyramids.find(id);
+    if (it != m_Pyramids.end()) return *it->second;
+
+    while (m_Pyramids.size() >= m_Capacity && !m_Order.empty()) {
+        m_Pyramids.erase(m_Order.front());
+        m_Order.pop_front();
+    }
+    m_Order.push_back(id);
+    return *m_Pyramids.emplace(id, BuildPyramid(regionX, regionZ)).first->second;
+}
+
+std::unique_ptr<TerrainBounds::Pyramid> TerrainBounds::BuildPyramid(int32_t regionX, int32_t regionZ) const {
+    // --- 1. Coarse height pass: one sample per chunk corner ---
+    std::vector<float> nodes(static_cast<size_t>(NODES) * NODES);
+    m_Terrain.GetHeightGrid((regionX * REGION_SIZE - 1) * CHUNK_WORLD,
+                            (regionZ * REGION_SIZE - 1) * CHUNK_WORLD,
+                            CHUNK_WORLD, NODES, NODES, nodes.data());
+    auto node = [&](int32_t x, int32_t z) { return nodes[static_cast<size_t>(z) * NODES + x]; };
+
+    // Largest step between adjacent nodes, stored per node cell (cell (x, z) = nodes x..x+1, z..z+1).
+    constexpr int32_t CELLS = NODES - 1;
+    std::vector<float> cellStep(static_cast<size_t>(CELLS) * CELLS);
+    for (int32_t z = 0; z < CELLS; ++z) {
+        for (int32_t x = 0; x < CELLS; ++x) {
+            const float a = node(x, z), b = node(x + 1, z), c = node(x, z + 1), d = node(x + 1, z + 1);
+            cellStep[static_cast<size_t>(z) * CELLS + x] =
+                std::max({std::fabs(b - a), std::fabs(c - a), std::fabs(d - b), std::fabs(d - c)});
+        }
+    }
+
+    // --- 2. Level 0: one range per chunk ---
+    // Chunk (cx, cz) spans node cell (cx + 1, cz + 1); its 3x3 cell neighbourhood sets the step.
+    auto pyramid = std::make_unique<Pyramid>();
+    std::vector<Range>& base = pyramid->Levels[0];
+    base.resize(static_cast<size_t>(REGION_SIZE) * REGION_SIZE);
+
+    const float detail = m_Terrain.GetParams().DetailStrength;
+    for (int32_t cz = 0; cz < REGION_SIZE; ++cz) {
+        for (int32_t cx = 0; cx < REGION_SIZE; ++cx) {
+            const int32_t nx = cx + 1, nz = cz + 1;
+            const float lo = std::min({node(nx, nz), node(nx + 1, nz), node(nx, nz + 1), node(nx + 1, nz + 1)});
+            const float hi = std::max({node(nx, nz), node(nx + 1, nz), node(nx, nz + 1), node(nx + 1, nz + 1)});
+
+            float step = 0.0f;
+            for (int32_t z = nz - 1; z <= nz + 1; ++z)
+                for (int32_t x = nx - 1; x <= nx + 1; ++x)
+                    step = std::max(step, cellStep[static_cast<size_t>(z) * CELLS + x]);
+
+            const float margin = STEP_FACTOR * step + detail;
+            base[static_cast<size_t>(cz) * REGION_SIZE + cx] = {lo - margin - SLACK_BELOW + m_PostPass.Min,
+                                                                hi + margin + SLACK_ABOVE + m_PostPass.Max};
+        }
+    }
+
+    // --- 3. Upper levels: merge 2x2 blocks ---
+    for (uint32_t level = 1; level < LEVELS; ++level) {
+        const std::vector<Range>& below = pyramid->Levels[level - 1];
+        std::vector<Range>&       out   = pyramid->Levels[level];
+        const int32_t side  = REGION_SIZE >> level;
+        const int32_t prevSide = side * 2;
+        out.resize(static_cast<size_t>(side) * side);
+        for (int32_t z = 0; z < side; ++z) {
+            for (int32_t x = 0; x < side; ++x) {
+                const Range& a = below[static_cast<size_t>(2 * z)     * prevSide + 2 * x];
+                const Range& b = below[static_cast<size_t>(2 * z)     * prevSide + 2 * x + 1];
+                const Range& c = below[static_cast<size_t>(2 * z + 1) * prevSide + 2 * x];
+                const Range& d = below[static_cast<size_t>(2 * z + 1) * prevSide + 2 * x + 1];
+                out[static_cast<size_t>(z) * side + x] = {std::min({a.Min, b.Min, c.Min, d.Min}),
+                                                          std::max({a.Max, b.Max, c.Max, d.Max})};
+            }
+        }
+    }
+    return pyramid;
+}
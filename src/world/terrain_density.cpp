@@ -0,0 +1,250 @@
+#include "world/terrain_density.hpp"
+#include "world/terrain_generator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+    // --- Mask (2D, per chunk corner) ---
+    constexpr float MASK_FREQUENCY = 0.0025f;  // ~400 m patches
+    constexpr float MASK_LOW       = 0.15f;    // raw mask noise -> weight 0 .. 1 (a little under half the land)
+    constexpr float MASK_HIGH      = 0.45f;
+    constexpr float STEEP_LOW      = 0.4f;     // terrain slope (dH / dxz) where overhangs start
+    constexpr float STEEP_HIGH     = 1.2f;     // and reach full strength
+    constexpr float LAND_FADE      = 8.0f;     // weights fade in over this height above ShoreLevel
+
+    // --- Band (3D, on the lattice) ---
+    constexpr float   OVERHANG_FREQUENCY = 0.05f;  // ~20 m lumps, plus one octave at half that
+    constexpr float   CAVE_FREQUENCY     = 0.03f;  // ~33 m between tunnel bends
+    constexpr float   CAVE_WIDTH         = 0.12f;  // |n1|, |n2| below this * weight carve a tunnel
+    constexpr float   CAVE_FLOOR         = 6.0f;   // tunnels taper shut over this many heights above the band bottom
+    constexpr float   OVERHANG           = NarrowBandDensity::BAND_ABOVE * SPHERE_RADIUS; // n0 amplitude, world units
+
+    inline float SmoothStep(float e0, float e1, float v) noexcept {
+        v = std::clamp((v - e0) / (e1 - e0), 0.0f, 1.0f);
+        return v * v * (3.0f - 2.0f * v);
+    }
+
+    inline int32_t FloorDiv(int32_t a, int32_t b) noexcept {
+        return a / b - (a % b != 0 && (a ^ b) < 0 ? 1 : 0);
+    }
+
+    // 3D gradient (Perlin) noise in about [-1, 1]: quintic fade, the 12 cube-edge
+    // gradients picked by an integer hash of the corner. Only evaluated at the density
+    // lattice nodes, so a plain scalar version is enough.
+    float Gradient3(int32_t seed, float x, float y, float z) noexcept {
+        const float   fx = std::floor(x), fy = std::floor(y), fz = std::floor(z);
+        const int32_t x0 = static_cast<int32_t>(fx), y0 = static_cast<int32_t>(fy), z0 = static_cast<int32_t>(fz);
+        const float   dx = x - fx, dy = y - fy, dz = z - fz;
+
+        auto corner = [seed](int32_t ix, int32_t iy, int32_t iz, float gx, float gy, float gz) {
+            uint32_t h = static_cast<uint32_t>(seed)
+                       ^ static_cast<uint32_t>(ix) * 501125321u   // FastNoiseLite's primes
+                       ^ static_cast<uint32_t>(iy) * 1136930381u
+                       ^ static_cast<uint32_t>(iz) * 1720413743u;
+            h *= 0x27d4eb2du;
+            h ^= h >> 15;
+            switch ((h >> 16) % 12) {
+                case 0:  return  gx + gy;  case 1:  return -gx + gy;
+                case 2:  return  gx - gy;  case 3:  return -gx - gy;
+                case 4:  return  gx + gz;  case 5:  return -gx + gz;
+                case 6:  return  gx - gz;  case 7:  return -gx - gz;
+                case 8:  return  gy + gz;  case 9:  return -gy + gz;
+                case 10: return  gy - gz;  default: return -gy - gz;
+            }
+        };
+        auto fade = [](float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); };
+        auto lerp = [](float a, float b, float t) { return a + (b - a) * t; };
+
+        // Edge along x at corner offset (oy, oz), blended by the x fade.
+        const float u = fade(dx);
+        auto edge = [&](int32_t oy, int32_t oz) {
+            const float gy = dy - static_cast<float>(oy), gz = dz - static_cast<float>(oz);
+            return lerp(corner(x0, y0 + oy, z0 + oz, dx, gy, gz), corner(x0 + 1, y0 + oy, z0 + oz, dx - 1, gy, gz), u);
+        };
+        const float v = fade(dy), w = fade(dz);
+        return lerp(lerp(edge(0, 0), edge(1, 0), v), lerp(edge(0, 1), edge(1, 1), v), w);
+    }
+}
+
+NarrowBandDensity::NarrowBandDensity(const TerrainGenerator& terrain)
+    : m_Terrain(terrain),
+      m_MaskNoise(terrain.DeriveSeed("density_mask"), MASK_FREQUENCY),
+      m_OverhangSeed(terrain.DeriveSeed("density_overhang")),
+      m_CaveSeedA(terrain.DeriveSeed("cave_a")),
+      m_CaveSeedB(terrain.DeriveSeed("cave_b")) {}
+
+bool NarrowBandDensity::CornerMasks(const ChunkCoordinates& coords, float (&outCave)[4][4],
+                                    float (&outOverhang)[4][4]) const {
+    constexpr int32_t CS = CHUNK_SIZE;
+    const float originX = static_cast<float>((coords.X - 1) * CS) * SPHERE_RADIUS;
+    const float originZ = static_cast<float>((coords.Z - 1) * CS) * SPHERE_RADIUS;
+    constexpr float step = CS * SPHERE_RADIUS;
+
+    float xs[16], zs[16], mask[16];
+    for (int32_t k = 0; k < 16; ++k) {
+        xs[k] = originX + static_cast<float>(k % 4) * step;
+        zs[k] = originZ + static_cast<float>(k / 4) * step;
+    }
+    m_MaskNoise.GetNoise(xs, zs, mask, 16);
+
+    bool any = false;
+    for (int32_t k = 0; k < 16; ++k) {
+        outCave[k / 4][k % 4]     = SmoothStep(MASK_LOW, MASK_HIGH, mask[k]);
+        outOverhang[k / 4][k % 4] = 0.0f;
+        any = any || outCave[k / 4][k % 4] > 0.0f;
+    }
+    if (!any) return false;
+
+    // Slope of the noise surface (before erosion): overhangs only pay off on steep ground.
+    // One batched pass over all 16 corners, masked or not.
+    float dx[16], dz[16];
+    m_Terrain.GetHeightAndGradientGrid(originX, originZ, step, 4, 4, nullptr, dx, dz);
+    for (int32_t k = 0; k < 16; ++k) {
+        const float cave = outCave[k / 4][k % 4];
+        if (cave > 0.0f)
+            outOverhang[k / 4][k % 4] = cave * SmoothStep(STEEP_LOW, STEEP_HIGH, std::sqrt(dx[k] * dx[k] + dz[k] * dz[k]));
+    }
+    return true;
+}
+
+bool NarrowBandDensity::GetWeights(const ChunkCoordinates& coords, const int16_t* tops, Weights& out) const {
+    constexpr int32_t CS = CHUNK_SIZE;
+
+    // --- 1. Corners X-1 .. X+2: the window reaches one cell into each neighbour ---
+    float cave[4][4], overhang[4][4];
+    if (!CornerMasks(coords, cave, overhang)) return false;
+
+    // --- 2. Bilinear per column, faded out below the shore ---
+    const float shore = m_Terrain.GetParams().ShoreLevel;
+    auto bilerp = [](const float (&v)[4][4], int32_t cx, int32_t cz, float fx, float fz) {
+        const float a = v[cz][cx]     + (v[cz][cx + 1]     - v[cz][cx])     * fx;
+        const float b = v[cz + 1][cx] + (v[cz + 1][cx + 1] - v[cz + 1][cx]) * fx;
+        return a + (b - a) * fz;
+    };
+
+    bool any = false;
+    for (int32_t z = 0; z < WINDOW; ++z) {
+        const int32_t cz = (z - 1 + CS) / CS;
+        const float   fz = static_cast<float>((z - 1 + CS) % CS) / CS;
+        for (int32_t x = 0; x < WINDOW; ++x) {
+            const int32_t cx = (x - 1 + CS) / CS;
+            const float   fx = static_cast<float>((x - 1 + CS) % CS) / CS;
+            const int32_t i  = z * WINDOW + x;
+
+            const float land = SmoothStep(shore, shore + LAND_FADE, tops[i] * SPHERE_RADIUS);
+            out.Cave[i]     = bilerp(cave, cx, cz, fx, fz) * land;
+            out.Overhang[i] = bilerp(overhang, cx, cz, fx, fz) * land;
+            any = any || out.Cave[i] > 0.0f;
+        }
+    }
+    return any;
+}
+
+void NarrowBandDensity::GetBands(const ChunkCoordinates& coords, const int16_t* tops, const Weights& weights,
+                                 uint64_t* outBands) const {
+    constexpr int32_t BAND = BAND_BELOW + BAND_ABOVE + 1;
+    const int32_t originX = coords.X * static_cast<int32_t>(CHUNK_SIZE) - 1; // global cell of window column 0
+    const int32_t originZ = coords.Z * static_cast<int32_t>(CHUNK_SIZE) - 1;
+
+    // --- 1. Lattice over the bands of the masked columns, filled on first use ---
+    // (the overhang weight is the cave weight times a slope factor, so Cave > 0 covers both)
+    int32_t yMin = std::numeric_limits<int32_t>::max();
+    int32_t yMax = std::numeric_limits<int32_t>::min();
+    for (int32_t i = 0; i < WINDOW * WINDOW; ++i) {
+        if (weights.Cave[i] <= 0.0f) continue;
+        yMin = std::min(yMin, tops[i] - BAND_BELOW);
+        yMax = std::max(yMax, tops[i] + BAND_ABOVE);
+    }
+    if (yMin > yMax) {
+        std::fill(outBands, outBands + WINDOW * WINDOW, PLAIN);
+        return;
+    }
+
+    const int32_t nodeX0 = FloorDiv(originX, LATTICE);
+    const int32_t nodeZ0 = FloorDiv(originZ, LATTICE);
+    const int32_t nodeY0 = FloorDiv(yMin, LATTICE);
+    const int32_t nx = FloorDiv(originX + WINDOW - 1, LATTICE) - nodeX0 + 2;
+    const int32_t nz = FloorDiv(originZ + WINDOW - 1, LATTICE) - nodeZ0 + 2;
+    const int32_t ny = FloorDiv(yMax, LATTICE) - nodeY0 + 2;
+
+    using Node = std::array<float, 3>; // n0 (overhang), n1, n2 (cave)
+    std::vector<Node>    nodes(static_cast<size_t>(nx) * ny * nz);
+    std::vector<uint8_t> known(nodes.size(), 0);
+    auto node = [&](int32_t ix, int32_t iy, int32_t iz) -> const Node& {
+        const size_t i = (static_cast<size_t>(iz) * nx + ix) * ny + iy; // y innermost: a column walks up
+        if (!known[i]) {
+            const float x = static_cast<float>((nodeX0 + ix) * LATTICE) * SPHERE_RADIUS;
+            const float y = static_cast<float>((nodeY0 + iy) * LATTICE) * SPHERE_RADIUS;
+            const float z = static_cast<float>((nodeZ0 + iz) * LATTICE) * SPHERE_RADIUS;
+            const float o = OVERHANG_FREQUENCY, c = CAVE_FREQUENCY;
+            const float n0 = Gradient3(m_OverhangSeed, x * o, y * o, z * o)
+                           + 0.5f * Gradient3(NoiseScalar::WrapAdd(m_OverhangSeed, 1), 2 * x * o, 2 * y * o, 2 * z * o);
+            nodes[i] = { n0 / 1.5f, Gradient3(m_CaveSeedA, x * c, y * c, z * c),
+                         Gradient3(m_CaveSeedB, x * c, y * c, z * c) };
+            known[i] = 1;
+        }
+        return nodes[i];
+    };
+
+    // --- 2. Each masked column: trilinear noise over its band ---
+    // The column's lattice nodes are interpolated in x / z once; the band then only
+    // interpolates between them in y.
+    constexpr int32_t PROFILE = BAND / LATTICE + 3;
+    for (int32_t z = 0; z < WINDOW; ++z) {
+        const int32_t gz = originZ + z;
+        const int32_t iz = FloorDiv(gz, LATTICE) - nodeZ0;
+        const float   fz = static_cast<float>(gz - FloorDiv(gz, LATTICE) * LATTICE) / LATTICE;
+        for (int32_t x = 0; x < WINDOW; ++x) {
+            const int32_t i = z * WINDOW + x;
+            const float   wc = weights.Cave[i];
+            const float   wo = weights.Overhang[i];
+            if (wc <= 0.0f) { outBands[i] = PLAIN; continue; }
+
+            const int32_t gx = originX + x;
+            const int32_t ix = FloorDiv(gx, LATTICE) - nodeX0;
+            const float   fx = static_cast<float>(gx - FloorDiv(gx, LATTICE) * LATTICE) / LATTICE;
+            const int32_t base = tops[i] - BAND_BELOW;
+
+            const int32_t iy0 = FloorDiv(base, LATTICE) - nodeY0;
+            const int32_t iy1 = FloorDiv(base + BAND - 1, LATTICE) - nodeY0 + 1;
+            Node profile[PROFILE];
+            for (int32_t iy = iy0; iy <= iy1; ++iy) {
+                const Node& c00 = node(ix, iy, iz);     const Node& c10 = node(ix + 1, iy, iz);
+                const Node& c01 = node(ix, iy, iz + 1); const Node& c11 = node(ix + 1, iy, iz + 1);
+                for (int32_t c = 0; c < 3; ++c) {
+                    const float a = c00[c] + (c10[c] - c00[c]) * fx;
+                    const float b = c01[c] + (c11[c] - c01[c]) * fx;
+                    profile[iy - iy0][c] = a + (b - a) * fz;
+                }
+            }
+
+            uint64_t band = 0;
+            for (int32_t k = 0; k < BAND; ++k) {
+                const int32_t y  = base + k;
+                const int32_t iy = FloorDiv(y, LATTICE) - nodeY0 - iy0;
+                const float   fy = static_cast<float>(y - FloorDiv(y, LATTICE) * LATTICE) / LATTICE;
+
+                float n[3];
+                for (int32_t c = 0; c < 3; ++c)
+                    n[c] = profile[iy][c] + (profile[iy + 1][c] - profile[iy][c]) * fy;
+
+                const float density = static_cast<float>(tops[i] - y) * SPHERE_RADIUS + wo * OVERHANG * n[0];
+                const float width   = wc * CAVE_WIDTH * SmoothStep(0.0f, CAVE_FLOOR, static_cast<float>(k));
+                const bool  tunnel  = std::abs(n[1]) < width && std::abs(n[2]) < width;
+                if (density >= 0.0f && !tunnel) band |= uint64_t{1} << k;
+            }
+
+            // Run tops onto the BCC parity of the cell, as Discretize places a surface:
+            // (x + z + y) even. Dropping an odd top leaves the sphere below as the top.
+            for (int32_t k = 0; k < BAND; ++k) {
+                const bool top = ((band >> k) & 1u) && !((band >> (k + 1)) & 1u);
+                if (top && ((gx + gz + base + k) & 1)) band &= ~(uint64_t{1} << k);
+            }
+            outBands[i] = band;
+        }
+    }
+}
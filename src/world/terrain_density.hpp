@@ -0,0 +1,90 @@
+#pragma once
+
+#include "util/math/static_noise.hpp"
+#include "world/chunk.hpp"
+#include "world/config.hpp"
+
+#include <cstdint>
+
+class TerrainGenerator;
+
+// Solid shape of a chunk.
+//   None       - every cell is one solid column up to its surface (reference world).
+//   NarrowBand - NarrowBandDensity decides solidity around the surface where its
+//                mask is set, which adds overhangs and caves.
+// Fixed per world, like TerrainErosion: chunks saved in one mode do not line up
+// with chunks generated in the other.
+enum class TerrainDensity : uint8_t { None, NarrowBand };
+
+// Sparse 3D density evaluated only in a narrow band around the 2D surface.
+//
+//   density(x, y, z) = top(x, z) - y + overhang(x, z) * OVERHANG * n0(x, y, z)
+//   solid            = density >= 0, except inside a cave tunnel, where both
+//                      |n1| and |n2| are below cave(x, z) * CAVE_WIDTH
+//
+// top is the discretised surface of the heightfield, so a column whose weights are
+// both zero is exactly the heightfield column. The weights come from a cheap 2D
+// mask: a low-frequency noise sampled at the chunk corners (bilinear in between),
+// faded out below the shore, with the overhang weight further scaled by the
+// terrain slope at the corner. ChunkGenerator asks GetWeights first and keeps the
+// heightfield path for the chunks (most of them) where the mask is zero.
+//
+// Only the band [top - BAND_BELOW, top + BAND_ABOVE] of a masked column is
+// evaluated: below it the column is solid, above it air, so a band fits in one
+// 64-bit word. The three 3D gradient noises are sampled on a world-aligned lattice
+// (LATTICE cells and discrete heights apart) and interpolated trilinearly; everything
+// is a function of the position, so neighbouring chunks agree on their halo columns.
+// Thread-safe (const after construction).
+class NarrowBandDensity {
+public:
+    static constexpr int32_t WINDOW     = CHUNK_SIZE + 2; // columns per side, x / z from -1
+    static constexpr int32_t BAND_BELOW = 32;             // discrete heights evaluated below the top (16 m)
+    static constexpr int32_t BAND_ABOVE = 12;             // and above it (6 m, the overhang amplitude)
+    static constexpr int32_t LATTICE    = 4;              // noise lattice spacing, cells / discrete heights
+    static_assert(BAND_BELOW + BAND_ABOVE < 64, "a column band must fit one word");
+
+    // Column band, bit k = solid at discrete height top - BAND_BELOW + k.
+    static constexpr uint64_t PLAIN = (uint64_t{1} << (BAND_BELOW + 1)) - 1; // solid up to top
+
+    // Lowest / highest world offset from the heightfield surface a sphere can get.
+    static constexpr float REACH_BELOW = BAND_BELOW * SPHERE_RADIUS;
+    static constexpr float REACH_ABOVE = BAND_ABOVE * SPHERE_RADIUS;
+
+    struct Weights {
+        float Cave[WINDOW * WINDOW];     // [0, 1], row-major from (-1, -1)
+        float Overhang[WINDOW * WINDOW];
+    };
+
+    explicit NarrowBandDensity(const TerrainGenerator& terrain);
+
+    // Mask weights of the chunk's window. 'tops' holds the discretised surface of the
+    // window, WINDOW x WINDOW row-major (HeightMap::GetRow(-1)). Returns false, leaving
+    // 'out' unset, when every column is pure heightfield.
+    bool GetWeights(const ChunkCoordinates& coords, const int16_t* tops, Weights& out) const;
+
+    // Band of every window column (PLAIN where both weights are zero). The top of
+    // every solid run sits on its cell's BCC parity, like a heightfield surface.
+    void GetBands(const ChunkCoordinates& coords, const int16_t* tops, const Weights& weights,
+                  uint64_t* outBands) const;
+
+    // Solidity at discrete height y of a column with surface 'top' and band 'band'.
+    static bool IsSolid(uint64_t band, int16_t top, int32_t y) noexcept {
+        const int32_t k = y - (top - BAND_BELOW);
+        if (k < 0)  return true;
+        if (k > 63) return false;
+        return (band >> k) & 1u;
+    }
+
+private:
+    // Raw mask noise mapped to [0, 1] and the overhang factor at the 4 x 4 chunk corners
+    // X-1 .. X+2, Z-1 .. Z+2 ([z][x]). Returns false when every cave weight is zero.
+    bool CornerMasks(const ChunkCoordinates& coords, float (&outCave)[4][4], float (&outOverhang)[4][4]) const;
+
+    using MaskNoise = StaticNoise<NoiseKind::OpenSimplex2, NoiseLayer::Fractal::FBm, 2>;
+
+    const TerrainGenerator& m_Terrain;
+    MaskNoise m_MaskNoise;    // 2D, where caves / overhangs may appear
+    int32_t   m_OverhangSeed; // 3D gradient noise seeds: n0
+    int32_t   m_CaveSeedA;    // n1
+    int32_t   m_CaveSeedB;    // n2
+};
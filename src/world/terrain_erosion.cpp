@@ -0,0 +1,266 @@
+#include "world/terrain_erosion.hpp"
+#include "world/terrain_generator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace {
+    // --- Simulation constants (heights in world units, areas in nodes) ---
+    constexpr int32_t ITERATIONS = 12;
+    constexpr float   INCISION   = 0.10f;  // stream power: cut per iteration = INCISION * sqrt(area past CHANNEL) * slope
+    constexpr float   CHANNEL    = 8.0f;   // drainage area (nodes) where a channel starts; hillslopes above stay
+    constexpr float   CAPACITY   = 1.0f;   // sediment the flow holds per sqrt(area) * slope
+    constexpr float   DEPOSIT    = 0.5f;   // share of the excess sediment dropped at a node
+    constexpr float   MAX_CUT    = 0.5f;   // share of the drop to the lowest neighbour one iteration may cut
+    constexpr float   FLAT       = 1e-3f;  // slope given to filled depressions so they still drain
+    constexpr float   SHORE_FADE = 8.0f;   // carving fades in over this height above ShoreLevel - SHORE_FADE
+
+    constexpr int32_t N = ErosionTile::NODES;
+    constexpr float   L = ErosionTile::STEP;
+
+    // 8-neighbourhood and the horizontal distance to each neighbour.
+    constexpr int32_t DX[8]   = { -1, 1,  0, 0, -1,  1, -1, 1 };
+    constexpr int32_t DZ[8]   = {  0, 0, -1, 1, -1, -1,  1, 1 };
+    constexpr float   DIST[8] = { L, L, L, L, L * 1.41421356f, L * 1.41421356f, L * 1.41421356f, L * 1.41421356f };
+
+    inline size_t At(int32_t x, int32_t z) noexcept {
+        return static_cast<size_t>(z) * N + static_cast<size_t>(x);
+    }
+
+    // Bilinear read of a NODES x NODES field, clamped to its rim.
+    inline float Sample(const std::vector<float>& field, float x, float z) noexcept {
+        x = std::clamp(x, 0.0f, static_cast<float>(N - 1));
+        z = std::clamp(z, 0.0f, static_cast<float>(N - 1));
+        const int32_t x0 = std::min(static_cast<int32_t>(x), N - 2);
+        const int32_t z0 = std::min(static_cast<int32_t>(z), N - 2);
+        const float   tx = x - static_cast<float>(x0);
+        const float   tz = z - static_cast<float>(z0);
+        const float   a  = field[At(x0, z0)]     + (field[At(x0 + 1, z0)]     - field[At(x0, z0)])     * tx;
+        const float   b  = field[At(x0, z0 + 1)] + (field[At(x0 + 1, z0 + 1)] - field[At(x0, z0 + 1)]) * tx;
+        return a + (b - a) * tz;
+    }
+
+    // Weight of the tile a coordinate lies in against its neighbour across the nearer
+    // core edge (-1 west/north, +1 east/south, 0 = no neighbour involved).
+    inline float EdgeWeight(float u, int32_t& side) noexcept {
+        constexpr float BLEND = static_cast<float>(HydraulicErosion::BLEND);
+        constexpr float CORE  = static_cast<float>(ErosionTile::CORE);
+        side = 0;
+        if (u < BLEND)        { side = -1; return 0.5f + 0.5f * u / BLEND; }
+        if (u > CORE - BLEND) { side =  1; return 0.5f + 0.5f * (CORE - u) / BLEND; }
+        return 1.0f;
+    }
+
+    // Priority-flood: raises every depression to its spill level (plus FLAT per node so
+    // it keeps draining) with the tile rim and the sea as outlets. 'order' receives the
+    // nodes lowest-first, so every node comes after all the nodes it drains into.
+    void FloodFill(const std::vector<float>& ground, float sea, std::vector<float>& filled,
+                   std::vector<uint32_t>& order) {
+        using Entry = std::pair<float, uint32_t>; // (level, node); ties broken by node index
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        std::vector<uint8_t> seen(ground.size(), 0);
+
+        filled = ground;
+        order.clear();
+        for (int32_t z = 0; z < N; ++z) {
+            for (int32_t x = 0; x < N; ++x) {
+                const size_t i = At(x, z);
+                if (x == 0 || z == 0 || x == N - 1 || z == N - 1 || ground[i] < sea) {
+                    open.push({ground[i], static_cast<uint32_t>(i)});
+                    seen[i] = 1;
+                }
+            }
+        }
+        while (!open.empty()) {
+            const auto [level, i] = open.top();
+            open.pop();
+            order.push_back(i);
+            const int32_t x = static_cast<int32_t>(i % N), z = static_cast<int32_t>(i / N);
+            for (int32_t k = 0; k < 8; ++k) {
+                const int32_t nx = x + DX[k], nz = z + DZ[k];
+                if (nx < 0 || nz < 0 || nx >= N || nz >= N) continue;
+                const size_t j = At(nx, nz);
+                if (seen[j]) continue;
+                seen[j]   = 1;
+                filled[j] = std::max(ground[j], level + FLAT * DIST[k]);
+                open.push({filled[j], static_cast<uint32_t>(j)});
+            }
+        }
+    }
+}
+
+// --- ErosionTileCache ---
+
+std::shared_ptr<const ErosionTile> ErosionTileCache::Find(int32_t tileX, int32_t tileZ) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Tiles.find(MakeKey(tileX, tileZ));
+    return it != m_Tiles.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<const ErosionTile> ErosionTileCache::Insert(std::shared_ptr<const ErosionTile> tile) {
+    const uint64_t key = MakeKey(tile->TileX, tile->TileZ);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto [it, inserted] = m_Tiles.emplace(key, std::move(tile));
+    if (!inserted) return it->second; // another thread won the race
+
+    m_Built++;
+    m_Order.push_back(key);
+    if (m_Capacity > 0 && m_Order.size() > m_Capacity) {
+        m_Tiles.erase(m_Order.front());
+        m_Order.pop_front();
+    }
+    return it->second;
+}
+
+uint32_t ErosionTileCache::GetBuiltCount() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Built;
+}
+
+// --- HydraulicErosion ---
+
+struct HydraulicErosion::TileSet {
+    struct Entry {
+        int32_t X, Z;
+        std::shared_ptr<const ErosionTile> Tile;
+    };
+    std::array<Entry, 9> Entries;
+    size_t               Count = 0;
+
+    const ErosionTile& Get(const HydraulicErosion& erosion, int32_t tileX, int32_t tileZ) {
+        for (size_t i = 0; i < Count; ++i)
+            if (Entries[i].X == tileX && Entries[i].Z == tileZ) return *Entries[i].Tile;
+        // A call spans a few chunks, so more than 9 tiles never occur; recycle the last slot if it did.
+        const size_t slot = Count < Entries.size() ? Count++ : Entries.size() - 1;
+        Entries[slot] = {tileX, tileZ, erosion.GetTile(tileX, tileZ)};
+        return *Entries[slot].Tile;
+    }
+};
+
+HydraulicErosion::HydraulicErosion(const TerrainGenerator& terrain, size_t capacity)
+    : m_Terrain(terrain), m_Tiles(capacity) {}
+
+void HydraulicErosion::ApplyGrid(float originX, float originZ, float step, uint32_t width, uint32_t height,
+                                 float* heights, size_t stride) const {
+    TileSet tiles;
+    for (uint32_t row = 0; row < height; ++row) {
+        const float z = originZ + static_cast<float>(row) * step;
+        for (uint32_t col = 0; col < width; ++col)
+            heights[row * stride + col] += Delta(originX + static_cast<float>(col) * step, z, tiles);
+    }
+}
+
+void HydraulicErosion::ApplyPoints(const float* xs, const float* zs, float* heights, size_t count) const {
+    TileSet tiles;
+    for (size_t i = 0; i < count; ++i) heights[i] += Delta(xs[i], zs[i], tiles);
+}
+
+float HydraulicErosion::Delta(float x, float z, TileSet& tiles) const {
+    const float   fx = x / ErosionTile::STEP;
+    const float   fz = z / ErosionTile::STEP;
+    const int32_t tx = ErosionTile::TileOf(static_cast<int32_t>(std::floor(fx)));
+    const int32_t tz = ErosionTile::TileOf(static_cast<int32_t>(std::floor(fz)));
+
+    int32_t sideX, sideZ;
+    const float wx = EdgeWeight(fx - static_cast<float>(tx * ErosionTile::CORE), sideX);
+    const float wz = EdgeWeight(fz - static_cast<float>(tz * ErosionTile::CORE), sideZ);
+
+    auto read = [&](int32_t tileX, int32_t tileZ) {
+        const ErosionTile& tile = tiles.Get(*this, tileX, tileZ);
+        return Sample(tile.Delta, fx - static_cast<float>(tile.OriginNodeX), fz - static_cast<float>(tile.OriginNodeZ));
+    };
+
+    // Tiles are summed in a fixed order so the result does not depend on the caller.
+    float delta = wx * wz * read(tx, tz);
+    if (sideX != 0)               delta += (1.0f - wx) * wz * read(tx + sideX, tz);
+    if (sideZ != 0)               delta += wx * (1.0f - wz) * read(tx, tz + sideZ);
+    if (sideX != 0 && sideZ != 0) delta += (1.0f - wx) * (1.0f - wz) * read(tx + sideX, tz + sideZ);
+    return delta;
+}
+
+std::shared_ptr<const ErosionTile> HydraulicErosion::GetTile(int32_t tileX, int32_t tileZ) const {
+    if (auto tile = m_Tiles.Find(tileX, tileZ)) return tile;
+
+    // Built outside the cache lock; a tile two workers build at once is dropped once.
+    return m_Tiles.Insert(BuildTile(tileX, tileZ));
+}
+
+std::shared_ptr<const ErosionTile> HydraulicErosion::BuildTile(int32_t tileX, int32_t tileZ) const {
+    auto tile = std::make_shared<ErosionTile>(tileX, tileZ);
+
+    // --- 1. Noise heights at the nodes ---
+    constexpr size_t COUNT = static_cast<size_t>(N) * N;
+    std::vector<float> ground(COUNT);
+    m_Terrain.GetHeightGrid(static_cast<float>(tile->OriginNodeX) * L, static_cast<float>(tile->OriginNodeZ) * L,
+                            L, N, N, ground.data());
+    const std::vector<float> initial = ground;
+    const float sea = m_Terrain.GetParams().ShoreLevel;
+
+    std::vector<float>    filled, area(COUNT), load(COUNT), change(COUNT);
+    std::vector<uint32_t> order;
+    order.reserve(COUNT);
+
+    for (int32_t it = 0; it < ITERATIONS; ++it) {
+        FloodFill(ground, sea, filled, order);
+        std::fill(area.begin(), area.end(), 1.0f);
+        std::fill(load.begin(), load.end(), 0.0f);
+        std::fill(change.begin(), change.end(), 0.0f);
+
+        // --- 2. Highest node first: cut, drop sediment, pass water and load downhill ---
+        for (auto o = order.rbegin(); o != order.rend(); ++o) {
+            const size_t  i = *o;
+            const int32_t x = static_cast<int32_t>(i % N), z = static_cast<int32_t>(i / N);
+
+            // Downhill neighbours on the filled surface, weighted by slope^4 (multiple flow directions).
+            float   weight[8], total = 0.0f, steepest = 0.0f, lowestDrop = 0.0f;
+            for (int32_t k = 0; k < 8; ++k) {
+                weight[k] = 0.0f;
+                const int32_t nx = x + DX[k], nz = z + DZ[k];
+                if (nx < 0 || nz < 0 || nx >= N || nz >= N) continue;
+                const float drop = filled[i] - filled[At(nx, nz)];
+                if (drop <= 0.0f) continue;
+                const float slope = drop / DIST[k];
+                weight[k] = slope * slope * slope * slope;
+                total += weight[k];
+                if (slope > steepest) { steepest = slope; lowestDrop = ground[i] - ground[At(nx, nz)]; }
+            }
+            if (total == 0.0f) continue; // outlet: the rim or the sea takes everything
+
+            // Stream power incision on real ground (depressions are flat: slope ~ FLAT).
+            const float root     = std::sqrt(area[i]);
+            const float capacity = CAPACITY * root * steepest;
+            const float power    = std::max(root - std::sqrt(CHANNEL), 0.0f) * steepest;
+            float cut = std::min(INCISION * power, MAX_CUT * std::max(lowestDrop, 0.0f));
+            float carried = load[i] + cut;
+            if (carried > capacity) {
+                const float drop = DEPOSIT * (carried - capacity);
+                carried -= drop;
+                cut     -= drop;
+            }
+            change[i] -= cut;
+
+            for (int32_t k = 0; k < 8; ++k) {
+                if (weight[k] == 0.0f) continue;
+                const size_t j = At(x + DX[k], z + DZ[k]);
+                const float  w = weight[k] / total;
+                area[j] += area[i] * w;
+                load[j] += carried * w;
+            }
+        }
+
+        for (size_t i = 0; i < COUNT; ++i) ground[i] += change[i];
+    }
+
+    // --- 3. Delta, bounded and faded out towards the sea ---
+    const float shore = sea - SHORE_FADE;
+    for (size_t i = 0; i < COUNT; ++i) {
+        const float fade = std::clamp((initial[i] - shore) / SHORE_FADE, 0.0f, 1.0f);
+        tile->Delta[i]   = std::clamp(ground[i] - initial[i], -MAX_CARVE, MAX_FILL) * fade;
+    }
+    return tile;
+}
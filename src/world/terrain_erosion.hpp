@@ -0,0 +1,126 @@
+#pragma once
+
+#include "world/config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class TerrainGenerator;
+
+// Post-pass applied to the noise heights before they are discretised.
+//   None      - heights are the noise terrain (reference world).
+//   Hydraulic - drainage carving by HydraulicErosion.
+// Fixed per world, like TerrainSampling / TerrainNoise: chunks saved without the
+// pass do not line up with chunks generated with it.
+enum class TerrainErosion : uint8_t { None, Hydraulic };
+
+// Height change of the erosion simulation over one region, plus a halo.
+// Nodes sit on a world-aligned grid one chunk apart (the LatticeTile grid); the
+// core covers the region, and the halo carries the simulation far enough past the
+// region edge that the neighbouring tile can blend into it.
+struct ErosionTile {
+    static constexpr float   STEP  = CHUNK_SIZE * SPHERE_RADIUS; // world units between nodes
+    static constexpr int32_t CORE  = REGION_SIZE;                // node intervals per region side
+    static constexpr int32_t HALO  = 12;                         // nodes simulated past each core edge
+    static constexpr int32_t NODES = CORE + 2 * HALO + 1;
+
+    ErosionTile(int32_t tileX, int32_t tileZ)
+        : TileX(tileX), TileZ(tileZ),
+          OriginNodeX(tileX * CORE - HALO), OriginNodeZ(tileZ * CORE - HALO),
+          Delta(static_cast<size_t>(NODES) * NODES, 0.0f) {}
+
+    // Tile whose core contains global node coordinate 'node' (floor division).
+    static int32_t TileOf(int32_t node) noexcept {
+        return node >= 0 ? node / CORE : (node + 1) / CORE - 1;
+    }
+
+    int32_t TileX, TileZ;
+    int32_t OriginNodeX, OriginNodeZ; // global node index of local node (0, 0)
+    std::vector<float> Delta;         // [z][x] eroded - noise height, NODES x NODES
+};
+
+// Bounded, thread-safe store of ErosionTiles shared by every generator thread.
+// Same policy as TerrainLatticeCache: immutable tiles, oldest dropped when full.
+class ErosionTileCache {
+public:
+    explicit ErosionTileCache(size_t capacity = 256) : m_Capacity(capacity) {}
+
+    std::shared_ptr<const ErosionTile> Find(int32_t tileX, int32_t tileZ) const;
+
+    // Inserts a freshly built tile; if another thread inserted the same tile first,
+    // that one is kept and returned instead.
+    std::shared_ptr<const ErosionTile> Insert(std::shared_ptr<const ErosionTile> tile);
+
+    uint32_t GetBuiltCount() const;
+
+private:
+    static uint64_t MakeKey(int32_t tileX, int32_t tileZ) noexcept {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(tileX)) << 32)
+             |  static_cast<uint64_t>(static_cast<uint32_t>(tileZ));
+    }
+
+    size_t m_Capacity;
+
+    mutable std::mutex m_Mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<const ErosionTile>> m_Tiles;
+    std::deque<uint64_t> m_Order; // insertion order, front = oldest
+    uint32_t             m_Built = 0;
+};
+
+// Hydraulic erosion in region tiles. Each iteration routes the rain over the
+// tile: depressions are flood-filled to their spill level, water and sediment
+// flow to the lower neighbours weighted by slope (multiple flow directions), and
+// every node past a minimum drainage area is cut by stream power
+// (sqrt(area) x slope). Sediment beyond what the flow can carry is dropped, which
+// fills lake beds and valley floors.
+//
+// A tile is simulated from the noise heights of its own nodes only, in a fixed
+// order, so its result depends on nothing but the seed and its coordinates -
+// never on which chunks or tiles were generated first. Tiles overlap: within
+// BLEND nodes of a core edge, a height is the weighted mean of the tiles on
+// both sides (their halos), going 50/50 at the edge, so there is no seam.
+// Heights are offset by the bilinear interpolation of the node deltas.
+//
+// The carving is limited to [-MAX_CARVE, +MAX_FILL] and fades out below the
+// shoreline. Thread-safe: tiles are built by whichever worker needs them first.
+class HydraulicErosion {
+public:
+    static constexpr int32_t BLEND     = 6;                      // nodes on each side of a core edge
+    static constexpr float   MAX_CARVE = 24.0f * FEATURE_SCALE;  // deepest cut, world units
+    static constexpr float   MAX_FILL  =  8.0f * FEATURE_SCALE;  // highest deposit
+    static_assert(BLEND + 4 <= ErosionTile::HALO, "blend band must stay clear of the halo rim");
+
+    // capacity = tiles kept; 512 holds the default load ring (~13x13 regions) twice over.
+    explicit HydraulicErosion(const TerrainGenerator& terrain, size_t capacity = 512);
+
+    HydraulicErosion(const HydraulicErosion&) = delete;
+    HydraulicErosion& operator=(const HydraulicErosion&) = delete;
+
+    // Adds the erosion delta to heights[row * stride + col], sampled at
+    // (originX + col * step, originZ + row * step).
+    void ApplyGrid(float originX, float originZ, float step, uint32_t width, uint32_t height,
+                   float* heights, size_t stride) const;
+
+    // Adds the delta to heights[i], sampled at (xs[i], zs[i]).
+    void ApplyPoints(const float* xs, const float* zs, float* heights, size_t count) const;
+
+    uint32_t GetBuiltTiles() const { return m_Tiles.GetBuiltCount(); }
+
+    // Returns the tile, simulating it on first use.
+    std::shared_ptr<const ErosionTile> GetTile(int32_t tileX, int32_t tileZ) const;
+    std::shared_ptr<const ErosionTile> BuildTile(int32_t tileX, int32_t tileZ) const;
+
+private:
+    // Tiles a call has already looked up (a grid touches at most a handful).
+    struct TileSet;
+
+    float Delta(float x, float z, TileSet& tiles) const;
+
+    const TerrainGenerator&  m_Terrain;
+    mutable ErosionTileCache m_Tiles;
+};
@@ -1,8 +1,14 @@
 #include "world/terrain_generator.hpp"
+#include "world/terrain_material.hpp"
+#include "world/gen_profiler.hpp"
 #include <algorithm>
 #include <bit>
+#include <climits>
+#include <cmath>
+#include <vector>
 
-TerrainGenerator::TerrainGenerator(const Seed256& seed) : m_MasterSeed(seed) {
+TerrainGenerator::TerrainGenerator(const Seed256& seed, TerrainSampling sampling, TerrainNoise noise)
+    : m_MasterSeed(seed), m_Sampling(sampling), m_Noise(noise) {
     InitNoise();
 }
 
@@ -33,109 +39,585 @@ int TerrainGenerator::DeriveSeed(std::string_view featureID) const {
 void TerrainGenerator::InitNoise() {
     // Frequencies are divided by FEATURE_SCALE so features widen proportionally with height.
     // Continental - 20 km scale geography (ocean vs plains vs mountain regions)
-    m_BaseNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    m_BaseNoise.SetSeed(DeriveSeed("continental"));
-    m_BaseNoise.SetFrequency(0.00005f / FEATURE_SCALE);
-    m_BaseNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    m_BaseNoise.SetFractalOctaves(3);
-    m_BaseNoise.SetFractalLacunarity(2.0f);
-    m_BaseNoise.SetFractalGain(0.5f);
+    m_BaseNoise = ContinentalNoise(DeriveSeed("continental"), 0.00005f / FEATURE_SCALE);
 
     // Peaks & Valleys - 5 km scale ridged FBm; 5 octaves add sub-ridge detail down to ~300 m
-    m_MountainNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    m_MountainNoise.SetSeed(DeriveSeed("peaks_valleys"));
-    m_MountainNoise.SetFrequency(0.0002f / FEATURE_SCALE);
-    m_MountainNoise.SetFractalType(FastNoiseLite::FractalType_Ridged);
-    m_MountainNoise.SetFractalOctaves(5);
-    m_MountainNoise.SetFractalLacunarity(2.0f);
-    m_MountainNoise.SetFractalGain(0.5f);
+    m_MountainNoise = PeaksNoise(DeriveSeed("peaks_valleys"), 0.0002f / FEATURE_SCALE);
 
     // Erosion - 7 km scale; controls how smooth vs jagged each region is
-    m_TerrainMask.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    m_TerrainMask.SetSeed(DeriveSeed("erosion"));
-    m_TerrainMask.SetFrequency(0.00015f / FEATURE_SCALE);
-    m_TerrainMask.SetFractalType(FastNoiseLite::FractalType_FBm);
-    m_TerrainMask.SetFractalOctaves(3);
-    m_TerrainMask.SetFractalLacunarity(2.0f);
-    m_TerrainMask.SetFractalGain(0.5f);
+    m_TerrainMask = ErosionNoise(DeriveSeed("erosion"), 0.00015f / FEATURE_SCALE);
 
     // Domain warp - 4 km scale distortion; makes ridge lines wind naturally
-    m_TreeDensityNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    m_TreeDensityNoise.SetSeed(DeriveSeed("domain_warp"));
-    m_TreeDensityNoise.SetFrequency(0.00025f / FEATURE_SCALE);
+    m_TreeDensityNoise = WarpNoise(DeriveSeed("domain_warp"), 0.00025f / FEATURE_SCALE);
 
     // Detail - 67 m scale surface roughness (boulders / rocky ground texture)
-    m_DetailNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    m_DetailNoise.SetSeed(DeriveSeed("terrain_detail"));
-    m_DetailNoise.SetFrequency(0.015f / FEATURE_SCALE);
-    m_DetailNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    m_DetailNoise.SetFractalOctaves(3);
-    m_DetailNoise.SetFractalLacunarity(2.0f);
-    m_DetailNoise.SetFractalGain(0.5f);
+    m_DetailNoise = DetailNoise(DeriveSeed("terrain_detail"), 0.015f / FEATURE_SCALE);
 
-    // Biome / Rock (reserved for future ecology, not used in height calculation)
-    m_BiomeNoise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-    m_BiomeNoise.SetSeed(DeriveSeed("biome"));
-    m_BiomeNoise.SetFrequency(0.001f);
+    // Lattice backend: same seeds and scales, octave counts as above.
+    using Fractal = NoiseLayer::Fractal;
+    m_LatticeBase     = LatticeNoise(DeriveSeed("continental"),    0.00005f / FEATURE_SCALE, Fractal::FBm,    3);
+    m_LatticeMountain = LatticeNoise(DeriveSeed("peaks_valleys"),  0.0002f  / FEATURE_SCALE, Fractal::Ridged, 5);
+    m_LatticeMask     = LatticeNoise(DeriveSeed("erosion"),        0.00015f / FEATURE_SCALE, Fractal::FBm,    3);
+    m_LatticeWarp     = LatticeNoise(DeriveSeed("domain_warp"),    0.00025f / FEATURE_SCALE);
+    m_LatticeDetail   = LatticeNoise(DeriveSeed("terrain_detail"), 0.015f   / FEATURE_SCALE, Fractal::FBm,    3);
 
-    m_RockNoise.SetNoiseType(FastNoiseLite::NoiseType_Cellular);
-    m_RockNoise.SetSeed(DeriveSeed("rocks"));
-    m_RockNoise.SetFrequency(0.1f);
+    // Surface materials only, never the height (GetMaterialBatch):
+    // Biome - 1 km scale dry / wet regions; Rock - 10 m cells, outcrops near the cell centres
+    m_BiomeNoise = BiomeNoise(DeriveSeed("biome"), 0.001f / FEATURE_SCALE);
+    m_RockNoise  = RockNoise(DeriveSeed("rocks"), 0.1f);
+
+    BuildHeightGraph();
 }
 
-float TerrainGenerator::GetHeight(float x, float z) const {
+namespace {
     // Linear remap from [a,b] to [c,d]
-    auto remap = [](float v, float a, float b, float c, float d) noexcept {
+    inline float Remap(float v, float a, float b, float c, float d) noexcept {
         return c + (v - a) / (b - a) * (d - c);
-    };
-    auto smoothStep = [](float e0, float e1, float v) noexcept {
+    }
+    inline float SmoothStep(float e0, float e1, float v) noexcept {
         v = std::clamp((v - e0) / (e1 - e0), 0.0f, 1.0f);
         return v * v * (3.0f - 2.0f * v);
+    }
+    // d SmoothStep / dv
+    inline float SmoothStepSlope(float e0, float e1, float v) noexcept {
+        const float t = (v - e0) / (e1 - e0);
+        if (t <= 0.0f || t >= 1.0f) return 0.0f;
+        return 6.0f * t * (1.0f - t) / (e1 - e0);
+    }
+
+    // Offset of the second warp sample; two independent displacements from one noise.
+    constexpr float WARP_OFFSET = 31743.0f;
+}
+
+void TerrainGenerator::BuildHeightGraph() {
+    static_assert(HEIGHT_BATCH == TerrainGraph::BATCH, "height batches must fit the graph");
+    using Segment = TerrainGraph::Segment;
+    using Module  = GenProfiler::Module;
+    TerrainGraph& g = m_HeightGraph;
+
+    // Backend picked once here; the graph never branches on it.
+    // id only feeds GEN_PROFILE_SCOPE.
+    auto noise = [this](Module id, const auto& module, const LatticeNoise& lattice) -> TerrainGraph::NoiseModule {
+        if (m_Noise == TerrainNoise::Lattice)
+            return {
+                [&lattice, id](const float* xs, const float* zs, float* out, size_t count, float minWavelength) {
+                    GEN_PROFILE_SCOPE(id, count);
+                    if (minWavelength > 0.0f) lattice.GetNoise(xs, zs, out, count, lattice.OctavesAbove(minWavelength));
+                    else                      lattice.GetNoise(xs, zs, out, count);
+                },
+                [&lattice, id](const float* xs, const float* zs, float* out, float* outDx, float* outDz, size_t count) {
+                    GEN_PROFILE_SCOPE(id, count);
+                    lattice.GetNoiseDeriv(xs, zs, out, outDx, outDz, count);
+                }};
+        return {
+            [&module, id](const float* xs, const float* zs, float* out, size_t count, float minWavelength) {
+                GEN_PROFILE_SCOPE(id, count);
+                if (minWavelength > 0.0f) module.GetNoise(xs, zs, out, count, module.OctavesAbove(minWavelength));
+                else                      module.GetNoise(xs, zs, out, count);
+            },
+            [&module, id](const float* xs, const float* zs, float* out, float* outDx, float* outDz, size_t count) {
+                GEN_PROFILE_SCOPE(id, count);
+                module.GetNoiseDeriv(xs, zs, out, outDx, outDz, count);
+            }};
     };
 
+    // Same operations, in the same order, as GetHeight + ComposeHeight.
+    const auto warpNoiseX = g.AddNoise("warp_x", noise(Module::Warp, m_TreeDensityNoise, m_LatticeWarp));
+    const auto warpNoiseZ = g.AddNoise("warp_z", noise(Module::Warp, m_TreeDensityNoise, m_LatticeWarp),
+                                       TerrainGraph::NONE, TerrainGraph::NONE, 1.0f, WARP_OFFSET);
+    const auto warpX = g.AddMultiply("warp_x_scaled", warpNoiseX, TerrainGraph::NONE, m_Params.WarpStrength);
+    const auto warpZ = g.AddMultiply("warp_z_scaled", warpNoiseZ, TerrainGraph::NONE, m_Params.WarpStrength);
+
+    const auto continental  = g.AddNoise("continental", noise(Module::Continental, m_BaseNoise, m_LatticeBase),
+                                         warpX, warpZ, 0.25f);
+    const auto erosionNoise = g.AddNoise("erosion", noise(Module::Erosion, m_TerrainMask, m_LatticeMask));
+    const auto pv           = g.AddNoise("peaks", noise(Module::Peaks, m_MountainNoise, m_LatticeMountain),
+                                         warpX, warpZ, 1.0f);
+    const auto detailNoise  = g.AddNoise("detail", noise(Module::Detail, m_DetailNoise, m_LatticeDetail));
+
+    const auto erosion   = g.AddSmoothStep("erosion_smooth", erosionNoise, -0.4f, 0.5f);
+    const auto roughness = g.AddRemap("roughness", erosion, 0.0f, 1.0f, 1.0f, 0.0f); // 1 - erosion
+
+    const float shore = m_Params.ShoreLevel - 8.0f;
+    const auto baseH = g.AddRemap("base_height", continental, {
+        Segment{-0.45f, -1.0f,  -0.45f, m_Params.OceanFloor,    shore},
+        Segment{ 0.0f,  -0.45f,  0.0f,  shore,                  m_Params.ShoreLevel},
+        Segment{ 0.35f,  0.0f,   0.35f, m_Params.ShoreLevel,    m_Params.PlainLevel},
+        Segment{ 0.65f,  0.35f,  0.65f, m_Params.PlainLevel,    m_Params.HighlandLevel},
+        Segment{ 0.0f,   0.65f,  1.0f,  m_Params.HighlandLevel, m_Params.HighlandLevel * 1.5f},
+    });
+
+    // Peaks are gated by their weight: exactly zero over oceans, plains and eroded land.
+    const auto highland  = g.AddSmoothStep("highland", continental, 0.25f, 0.65f);
+    const auto influence = g.AddMultiply("mountain_influence", highland, roughness);
+    const auto peak      = g.AddMultiply("peak", pv, influence, m_Params.PeakHeight, true);
+
+    const auto detailWeight = g.AddRemap("detail_weight", roughness, 0.0f, 1.0f, 0.2f, 1.0f); // 0.2 + 0.8 * roughness
+    const auto detail       = g.AddMultiply("surface_detail", detailNoise, detailWeight, m_Params.DetailStrength);
+
+    const auto land = g.AddAdd("base_peak", baseH, peak);
+    g.Finalize(g.AddAdd("height", land, detail));
+
+    m_ExactPlan  = g.MakePlan();
+    m_CachedPlan = g.MakePlan({warpX, warpZ, continental, erosionNoise}); // LowFrequency channel order
+}
+
+float TerrainGenerator::GetHeight(float x, float z) const {
     // --- 1. Domain warp ---
     // Two independent displacements from one noise via large prime offset.
     // Warping breaks the uniform grid look and creates winding ridges and valleys.
-    const float warpX = m_TreeDensityNoise.GetNoise(x,             z)             * m_Params.WarpStrength;
-    const float warpZ = m_TreeDensityNoise.GetNoise(x + 31743.0f,  z + 31743.0f)  * m_Params.WarpStrength;
+    const float warpX = SampleLayer(m_TreeDensityNoise, m_LatticeWarp, x,               z)               * m_Params.WarpStrength;
+    const float warpZ = SampleLayer(m_TreeDensityNoise, m_LatticeWarp, x + WARP_OFFSET, z + WARP_OFFSET) * m_Params.WarpStrength;
 
     // Soft warp for continents (gently curved coastlines).
     // Full warp for peaks (strongly winding ridge lines).
     const float cxSoft = x + warpX * 0.25f,  czSoft = z + warpZ * 0.25f;
     const float cxFull = x + warpX,           czFull = z + warpZ;
 
-    // --- 2. Continentalness [-1, 1] --- 
+    // --- 2. Continentalness [-1, 1] ---
     // Large scale: determines whether a region is ocean, plains, or highland.
-    const float continental = m_BaseNoise.GetNoise(cxSoft, czSoft);
+    const float continental = SampleLayer(m_BaseNoise, m_LatticeBase, cxSoft, czSoft);
 
-    // --- 3. Erosion [0, 1] --- 
-    // 0 = rough / uneroded sharp ridges.
-    // 1 = smooth / heavily eroded flat plains.
-    const float erosion = smoothStep(-0.4f, 0.5f, m_TerrainMask.GetNoise(x, z));
+    // --- 3. Erosion (raw, smoothed in ComposeHeight) ---
+    const float erosionNoise = SampleLayer(m_TerrainMask, m_LatticeMask, x, z);
 
     // --- 4. Peaks & Valleys [0, 1] ---
     // Ridged FBm: 1 = mountain ridge crest,  0 = valley floor.
-    const float pv = m_MountainNoise.GetNoise(cxFull, czFull);
+    const float pv = SampleLayer(m_MountainNoise, m_LatticeMountain, cxFull, czFull);
+
+    return ComposeHeight(continental, erosionNoise, pv, SampleLayer(m_DetailNoise, m_LatticeDetail, x, z));
+}
+
+float TerrainGenerator::ComposeHeight(float continental, float erosionNoise, float pv, float detailNoise) const {
+    // --- 3. Erosion [0, 1] ---
+    // 0 = rough / uneroded sharp ridges.
+    // 1 = smooth / heavily eroded flat plains.
+    const float erosion = SmoothStep(-0.4f, 0.5f, erosionNoise);
 
     // --- 5. Continentalness -> base elevation (piecewise spline) ---
     // Each segment maps a continental range to a distinct terrain zone.
     float baseH;
     const float c = continental;
-    if      (c < -0.45f) baseH = remap(c, -1.0f, -0.45f, m_Params.OceanFloor,          m_Params.ShoreLevel - 8.0f);
-    else if (c <  0.0f ) baseH = remap(c, -0.45f,  0.0f,  m_Params.ShoreLevel - 8.0f,  m_Params.ShoreLevel);
-    else if (c <  0.35f) baseH = remap(c,  0.0f,   0.35f, m_Params.ShoreLevel,          m_Params.PlainLevel);
-    else if (c <  0.65f) baseH = remap(c,  0.35f,  0.65f, m_Params.PlainLevel,          m_Params.HighlandLevel);
-    else                 baseH = remap(c,  0.65f,  1.0f,  m_Params.HighlandLevel,       m_Params.HighlandLevel * 1.5f);
+    if      (c < -0.45f) baseH = Remap(c, -1.0f, -0.45f, m_Params.OceanFloor,          m_Params.ShoreLevel - 8.0f);
+    else if (c <  0.0f ) baseH = Remap(c, -0.45f,  0.0f,  m_Params.ShoreLevel - 8.0f,  m_Params.ShoreLevel);
+    else if (c <  0.35f) baseH = Remap(c,  0.0f,   0.35f, m_Params.ShoreLevel,          m_Params.PlainLevel);
+    else if (c <  0.65f) baseH = Remap(c,  0.35f,  0.65f, m_Params.PlainLevel,          m_Params.HighlandLevel);
+    else                 baseH = Remap(c,  0.65f,  1.0f,  m_Params.HighlandLevel,       m_Params.HighlandLevel * 1.5f);
 
-    // --- 6. Mountain peaks --- 
+    // --- 6. Mountain peaks ---
     // Peaks only rise in highland continental regions AND where erosion is low.
-    const float mountainInfluence = smoothStep(0.25f, 0.65f, c) * (1.0f - erosion);
+    const float mountainInfluence = SmoothStep(0.25f, 0.65f, c) * (1.0f - erosion);
     const float peak              = pv * m_Params.PeakHeight * mountainInfluence;
 
-    // --- 7. Surface detail --- 
+    // --- 7. Surface detail ---
     // Suppressed in smooth eroded zones, stronger on rough highland terrain.
-    const float detail = m_DetailNoise.GetNoise(x, z)
-                       * m_Params.DetailStrength * (0.2f + 0.8f * (1.0f - erosion));
+    const float detail = detailNoise * m_Params.DetailStrength * (0.2f + 0.8f * (1.0f - erosion));
 
     return baseH + peak + detail;
-}
\ No newline at end of file
+}
+
+void TerrainGenerator::ComposeGradient(float continental, const float dContinental[2],
+                                       float erosionNoise, const float dErosion[2],
+                                       float pv, const float dPv[2],
+                                       float detailNoise, const float dDetail[2],
+                                       float& outDx, float& outDz) const {
+    // Differentiates ComposeHeight term by term; keep the two in sync.
+    const float erosion      = SmoothStep(-0.4f, 0.5f, erosionNoise);
+    const float erosionSlope = SmoothStepSlope(-0.4f, 0.5f, erosionNoise);
+
+    // Slope of the active spline segment
+    float baseSlope;
+    const float c = continental;
+    if      (c < -0.45f) baseSlope = (m_Params.ShoreLevel - 8.0f - m_Params.OceanFloor) / 0.55f;
+    else if (c <  0.0f ) baseSlope = 8.0f / 0.45f;
+    else if (c <  0.35f) baseSlope = (m_Params.PlainLevel - m_Params.ShoreLevel) / 0.35f;
+    else if (c <  0.65f) baseSlope = (m_Params.HighlandLevel - m_Params.PlainLevel) / 0.30f;
+    else                 baseSlope = (m_Params.HighlandLevel * 0.5f) / 0.35f;
+
+    const float highland      = SmoothStep(0.25f, 0.65f, c);
+    const float highlandSlope = SmoothStepSlope(0.25f, 0.65f, c);
+    const float influence     = highland * (1.0f - erosion);
+    const float detailWeight  = m_Params.DetailStrength * (0.2f + 0.8f * (1.0f - erosion));
+
+    float grad[2];
+    for (int32_t a = 0; a < 2; ++a) {
+        const float dE         = erosionSlope * dErosion[a];
+        const float dInfluence = highlandSlope * dContinental[a] * (1.0f - erosion) - highland * dE;
+        const float dPeak      = m_Params.PeakHeight * (dPv[a] * influence + pv * dInfluence);
+        const float dDetailH   = dDetail[a] * detailWeight
+                               - detailNoise * m_Params.DetailStrength * 0.8f * dE;
+        grad[a] = baseSlope * dContinental[a] + dPeak + dDetailH;
+    }
+    outDx = grad[0];
+    outDz = grad[1];
+}
+
+float TerrainGenerator::GetHeightAndGradient(float x, float z, float& outDx, float& outDz) const {
+    // Same steps as GetHeight; every module also returns its gradient, and the warped
+    // lookups chain through the Jacobian of the warp.
+    float wxd[2], wzd[2];
+    const float warpX = SampleLayerDeriv(m_TreeDensityNoise, m_LatticeWarp, x,               z,
+                                         wxd[0], wxd[1]) * m_Params.WarpStrength;
+    const float warpZ = SampleLayerDeriv(m_TreeDensityNoise, m_LatticeWarp, x + WARP_OFFSET, z + WARP_OFFSET,
+                                         wzd[0], wzd[1]) * m_Params.WarpStrength;
+    for (int32_t a = 0; a < 2; ++a) {
+        wxd[a] *= m_Params.WarpStrength;
+        wzd[a] *= m_Params.WarpStrength;
+    }
+
+    // d(module at (x + k*warpX, z + k*warpZ)) / d(x, z) from the module's own gradient (u, v)
+    auto chain = [&](float k, float du, float dv, float out[2]) {
+        out[0] = du * (1.0f + k * wxd[0]) + dv * (k * wzd[0]);
+        out[1] = du * (k * wxd[1])        + dv * (1.0f + k * wzd[1]);
+    };
+
+    float du, dv;
+    float dContinental[2], dPv[2], dErosion[2], dDetail[2];
+
+    const float continental = SampleLayerDeriv(m_BaseNoise, m_LatticeBase, x + warpX * 0.25f, z + warpZ * 0.25f, du, dv);
+    chain(0.25f, du, dv, dContinental);
+
+    const float erosionNoise = SampleLayerDeriv(m_TerrainMask, m_LatticeMask, x, z, dErosion[0], dErosion[1]);
+
+    const float pv = SampleLayerDeriv(m_MountainNoise, m_LatticeMountain, x + warpX, z + warpZ, du, dv);
+    chain(1.0f, du, dv, dPv);
+
+    const float detailNoise = SampleLayerDeriv(m_DetailNoise, m_LatticeDetail, x, z, dDetail[0], dDetail[1]);
+
+    ComposeGradient(continental, dContinental, erosionNoise, dErosion, pv, dPv,
+                    detailNoise, dDetail, outDx, outDz);
+    return ComposeHeight(continental, erosionNoise, pv, detailNoise);
+}
+
+void TerrainGenerator::GetHeightBatch(const float* xs, const float* zs, float* out, size_t count,
+                                      float minWavelength) const {
+    // Same steps as GetHeight, one graph node at a time over the whole batch.
+    if (m_Sampling == TerrainSampling::Cached) {
+        LowFrequency lf;
+        std::shared_ptr<const LatticeTile> tile;
+        InterpolateLowFrequency(xs, zs, count, lf, tile);
+        FinishHeightBatch(xs, zs, count, lf, out, minWavelength);
+    } else {
+        m_HeightGraph.Evaluate(m_ExactPlan, xs, zs, count, out, nullptr, minWavelength);
+    }
+}
+
+void TerrainGenerator::SampleLowFrequency(const float* xs, const float* zs, size_t count, LowFrequency& lf) const {
+    float bx[HEIGHT_BATCH], bz[HEIGHT_BATCH];
+
+    // --- 1. Domain warp ---
+    for (size_t i = 0; i < count; ++i) {
+        bx[i] = xs[i] + WARP_OFFSET;
+        bz[i] = zs[i] + WARP_OFFSET;
+    }
+    SampleLayer(m_TreeDensityNoise, m_LatticeWarp, xs, zs, lf.WarpX, count);
+    SampleLayer(m_TreeDensityNoise, m_LatticeWarp, bx, bz, lf.WarpZ, count);
+    for (size_t i = 0; i < count; ++i) {
+        lf.WarpX[i] *= m_Params.WarpStrength;
+        lf.WarpZ[i] *= m_Params.WarpStrength;
+    }
+
+    // --- 2. Continentalness (soft warp) ---
+    for (size_t i = 0; i < count; ++i) {
+        bx[i] = xs[i] + lf.WarpX[i] * 0.25f;
+        bz[i] = zs[i] + lf.WarpZ[i] * 0.25f;
+    }
+    SampleLayer(m_BaseNoise, m_LatticeBase, bx, bz, lf.Continental, count);
+
+    // --- 3. Erosion (unwarped) ---
+    SampleLayer(m_TerrainMask, m_LatticeMask, xs, zs, lf.Erosion, count);
+}
+
+void TerrainGenerator::FinishHeightBatch(const float* xs, const float* zs, size_t count,
+                                         const LowFrequency& lf, float* out, float minWavelength) const {
+    const float* presets[] = { lf.WarpX, lf.WarpZ, lf.Continental, lf.Erosion };
+    m_HeightGraph.Evaluate(m_CachedPlan, xs, zs, count, out, presets, minWavelength);
+}
+
+// --- Coarse lattice (Cached sampling) ---
+
+namespace {
+    // Catmull-Rom weights: passes through the node values, C1 continuous across cells.
+    inline void CubicWeights(float t, float w[4]) noexcept {
+        const float t2 = t * t, t3 = t2 * t;
+        w[0] = 0.5f * (-t3 + 2.0f * t2 - t);
+        w[1] = 0.5f * ( 3.0f * t3 - 5.0f * t2 + 2.0f);
+        w[2] = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+        w[3] = 0.5f * ( t3 - t2);
+    }
+
+    // Vertical pass of the bicubic: weighted sum of 4 nodes down one lattice column.
+    // Both lookup paths do vertical first so they produce identical values.
+    inline float ColumnSum(const float* node, const float wz[4]) noexcept {
+        constexpr int32_t N = LatticeTile::NODES;
+        return wz[0] * node[0] + wz[1] * node[N] + wz[2] * node[2 * N] + wz[3] * node[3 * N];
+    }
+}
+
+void TerrainGenerator::InterpolateLowFrequency(const float* xs, const float* zs, size_t count, LowFrequency& lf,
+                                               std::shared_ptr<const LatticeTile>& tile) const {
+    constexpr float INV_STEP = 1.0f / LatticeTile::STEP;
+    float* channels[LatticeTile::CHANNEL_COUNT] = { lf.WarpX, lf.WarpZ, lf.Continental, lf.Erosion };
+
+    for (size_t i = 0; i < count; ++i) {
+        const float   fx = xs[i] * INV_STEP, fz = zs[i] * INV_STEP;
+        const int32_t nx = static_cast<int32_t>(std::floor(fx));
+        const int32_t nz = static_cast<int32_t>(std::floor(fz));
+
+        // Neighbouring samples almost always share a tile; look up only on a change.
+        if (!tile || !tile->Covers(nx, nz))
+            tile = GetLatticeTile(LatticeTile::TileOf(nx), LatticeTile::TileOf(nz));
+
+        float wx[4], wz[4];
+        CubicWeights(fx - static_cast<float>(nx), wx);
+        CubicWeights(fz - static_cast<float>(nz), wz);
+
+        const int32_t lx = nx - 1 - tile->OriginNodeX;
+        const int32_t lz = nz - 1 - tile->OriginNodeZ;
+        for (uint8_t c = 0; c < LatticeTile::CHANNEL_COUNT; ++c) {
+            const float* node = tile->Channel(c) + lz * LatticeTile::NODES + lx;
+            float col[4];
+            for (int32_t k = 0; k < 4; ++k)
+                col[k] = ColumnSum(node + k, wz);
+            channels[c][i] = wx[0] * col[0] + wx[1] * col[1] + wx[2] * col[2] + wx[3] * col[3];
+        }
+    }
+}
+
+std::shared_ptr<const LatticeTile> TerrainGenerator::GetLatticeTile(int32_t tileX, int32_t tileZ) const {
+    if (auto tile = m_Lattice.Find(tileX, tileZ)) return tile;
+
+    // Build outside the cache lock so other workers keep reading other tiles.
+    // Two workers may build the same tile concurrently; the duplicate is dropped.
+    return m_Lattice.Insert(BuildLatticeTile(tileX, tileZ));
+}
+
+std::shared_ptr<const LatticeTile> TerrainGenerator::BuildLatticeTile(int32_t tileX, int32_t tileZ) const {
+    auto tile = std::make_shared<LatticeTile>(tileX, tileZ);
+
+    // --- Node values: exact low-frequency layers at world-aligned node positions ---
+    constexpr size_t NODE_COUNT = static_cast<size_t>(LatticeTile::NODES) * LatticeTile::NODES;
+    float xs[HEIGHT_BATCH], zs[HEIGHT_BATCH];
+    LowFrequency lf;
+
+    for (size_t begin = 0; begin < NODE_COUNT; begin += HEIGHT_BATCH) {
+        const size_t count = std::min(HEIGHT_BATCH, NODE_COUNT - begin);
+        for (size_t i = 0; i < count; ++i) {
+            const size_t idx = begin + i;
+            xs[i] = static_cast<float>(tile->OriginNodeX + static_cast<int32_t>(idx % LatticeTile::NODES)) * LatticeTile::STEP;
+            zs[i] = static_cast<float>(tile->OriginNodeZ + static_cast<int32_t>(idx / LatticeTile::NODES)) * LatticeTile::STEP;
+        }
+        SampleLowFrequency(xs, zs, count, lf);
+
+        const float* src[LatticeTile::CHANNEL_COUNT] = { lf.WarpX, lf.WarpZ, lf.Continental, lf.Erosion };
+        for (uint8_t c = 0; c < LatticeTile::CHANNEL_COUNT; ++c)
+            std::copy_n(src[c], count, tile->Channel(c) + begin);
+    }
+
+    // --- Error probes ---
+    // Cell centres are the farthest points from any node, i.e. where interpolation
+    // error peaks. PROBES x PROBES of them, spread over the tile, are compared with
+    // the exact pipeline and folded into the cache's error report.
+    constexpr int32_t PROBES = 8;
+    constexpr size_t  PROBE_COUNT = static_cast<size_t>(PROBES) * PROBES;
+    static_assert(PROBE_COUNT <= HEIGHT_BATCH);
+
+    for (size_t i = 0; i < PROBE_COUNT; ++i) {
+        const int32_t cx = static_cast<int32_t>(i % PROBES) * (LatticeTile::CELLS / PROBES) + static_cast<int32_t>(i / PROBES) % 3;
+        const int32_t cz = static_cast<int32_t>(i / PROBES) * (LatticeTile::CELLS / PROBES) + static_cast<int32_t>(i % PROBES) % 3;
+        xs[i] = (static_cast<float>(tileX * LatticeTile::CELLS + cx) + 0.5f) * LatticeTile::STEP;
+        zs[i] = (static_cast<float>(tileZ * LatticeTile::CELLS + cz) + 0.5f) * LatticeTile::STEP;
+    }
+
+    float exact[HEIGHT_BATCH], cached[HEIGHT_BATCH];
+    SampleLowFrequency(xs, zs, PROBE_COUNT, lf);
+    FinishHeightBatch(xs, zs, PROBE_COUNT, lf, exact);
+
+    std::shared_ptr<const LatticeTile> self = tile;
+    InterpolateLowFrequency(xs, zs, PROBE_COUNT, lf, self);
+    FinishHeightBatch(xs, zs, PROBE_COUNT, lf, cached);
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < PROBE_COUNT; ++i)
+        maxError = std::max(maxError, std::abs(cached[i] - exact[i]));
+    m_Lattice.RecordProbes(maxError, static_cast<uint32_t>(PROBE_COUNT));
+
+    return tile;
+}
+
+void TerrainGenerator::GetMaterialBatch(const float* xs, const float* zs, const float* heights, size_t count,
+                                        uint8_t* out) const {
+    float    px[HEIGHT_BATCH], pz[HEIGHT_BATCH], biome[HEIGHT_BATCH], rock[HEIGHT_BATCH];
+    uint16_t index[HEIGHT_BATCH];
+    size_t   n = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!TerrainMaterial::HasVariants(heights[i])) {
+            out[i] = TerrainMaterial::FromHeight(heights[i]);
+            continue;
+        }
+        px[n] = xs[i];
+        pz[n] = zs[i];
+        index[n++] = static_cast<uint16_t>(i);
+    }
+    if (n == 0) return;
+
+    {
+        GEN_PROFILE_SCOPE(GenProfiler::Module::Biome, n);
+        m_BiomeNoise.GetNoise(px, pz, biome, n);
+    }
+    {
+        GEN_PROFILE_SCOPE(GenProfiler::Module::Rock, n);
+        m_RockNoise.GetNoise(px, pz, rock, n);
+    }
+    for (size_t k = 0; k < n; ++k)
+        out[index[k]] = TerrainMaterial::Classify(heights[index[k]], biome[k], rock[k]);
+}
+
+void TerrainGenerator::GetHeightGrid(float originX, float originZ, float step,
+                                     uint32_t width, uint32_t height, float* out, uint8_t* outMaterial,
+                                     float minWavelength) const {
+    // A grid finer than the lattice gets separable interpolation; anything
+    // coarser (or a single row/column) goes through the per-sample lookup.
+    if (m_Sampling == TerrainSampling::Cached && step > 0.0f && step <= LatticeTile::STEP) {
+        GetHeightGridCached(originX, originZ, step, width, height, out, outMaterial, minWavelength);
+        return;
+    }
+
+    float xs[HEIGHT_BATCH], zs[HEIGHT_BATCH];
+
+    const size_t total = static_cast<size_t>(width) * height;
+    for (size_t begin = 0; begin < total; begin += HEIGHT_BATCH) {
+        const size_t count = std::min(HEIGHT_BATCH, total - begin);
+        for (size_t i = 0; i < count; ++i) {
+            const size_t idx = begin + i;
+            xs[i] = originX + static_cast<float>(idx % width) * step;
+            zs[i] = originZ + static_cast<float>(idx / width) * step;
+        }
+        GetHeightBatch(xs, zs, out + begin, count, minWavelength);
+        if (outMaterial) GetMaterialBatch(xs, zs, out + begin, count, outMaterial + begin);
+    }
+}
+
+float TerrainGenerator::GetOmittedWavelength(float minWavelength) const {
+    if (minWavelength <= 0.0f) return 0.0f;
+
+    // Layers that can lose octaves: the graph's noise nodes, on the active backend.
+    float omitted = 0.0f;
+    auto check = [&](const auto& layer) {
+        const int32_t kept = layer.OctavesAbove(minWavelength);
+        if (kept < layer.GetOctaves()) omitted = std::max(omitted, layer.GetWavelength(kept));
+    };
+    if (m_Noise == TerrainNoise::Lattice) {
+        check(m_LatticeWarp);
+        check(m_LatticeBase);
+        check(m_LatticeMask);
+        check(m_LatticeMountain);
+        check(m_LatticeDetail);
+    } else {
+        check(m_TreeDensityNoise);
+        check(m_BaseNoise);
+        check(m_TerrainMask);
+        check(m_MountainNoise);
+        check(m_DetailNoise);
+    }
+    return omitted;
+}
+
+void TerrainGenerator::GetHeightAndGradientGrid(float originX, float originZ, float step,
+                                                uint32_t width, uint32_t height,
+                                                float* outHeight, float* outDx, float* outDz) const {
+    float xs[HEIGHT_BATCH], zs[HEIGHT_BATCH];
+    float h[HEIGHT_BATCH], dx[HEIGHT_BATCH], dz[HEIGHT_BATCH]; // for the outputs left out
+
+    const size_t total = static_cast<size_t>(width) * height;
+    for (size_t begin = 0; begin < total; begin += HEIGHT_BATCH) {
+        const size_t count = std::min(HEIGHT_BATCH, total - begin);
+        for (size_t i = 0; i < count; ++i) {
+            const size_t idx = begin + i;
+            xs[i] = originX + static_cast<float>(idx % width) * step;
+            zs[i] = originZ + static_cast<float>(idx / width) * step;
+        }
+        m_HeightGraph.EvaluateGradient(m_ExactPlan, xs, zs, count,
+                                       outHeight ? outHeight + begin : h,
+                                       outDx     ? outDx + begin     : dx,
+                                       outDz     ? outDz + begin     : dz);
+    }
+}
+
+void TerrainGenerator::GetHeights(const float* xs, const float* zs, float* out, size_t count,
+                                  uint8_t* outMaterial) const {
+    for (size_t begin = 0; begin < count; begin += HEIGHT_BATCH) {
+        const size_t n = std::min(HEIGHT_BATCH, count - begin);
+        GetHeightBatch(xs + begin, zs + begin, out + begin, n);
+        if (outMaterial) GetMaterialBatch(xs + begin, zs + begin, out + begin, n, outMaterial + begin);
+    }
+}
+
+void TerrainGenerator::GetHeightGridCached(float originX, float originZ, float step,
+                                           uint32_t width, uint32_t height, float* out,
+                                           uint8_t* outMaterial, float minWavelength) const {
+    constexpr float INV_STEP = 1.0f / LatticeTile::STEP;
+    constexpr uint8_t CH = LatticeTile::CHANNEL_COUNT;
+
+    // Horizontal weights depend only on the grid column, shared by every row.
+    struct Column { int32_t node; float w[4]; };
+    std::vector<Column> columns(width);
+    for (uint32_t c = 0; c < width; ++c) {
+        const float fx = (originX + static_cast<float>(c) * step) * INV_STEP;
+        columns[c].node = static_cast<int32_t>(std::floor(fx));
+        CubicWeights(fx - static_cast<float>(columns[c].node), columns[c].w);
+    }
+    const int32_t firstNode = columns.front().node - 1;
+    const int32_t spanNodes = columns.back().node + 3 - firstNode;
+
+    // Per row: the vertical pass for every lattice column the row touches.
+    std::vector<float> rowSums(static_cast<size_t>(spanNodes) * CH);
+    int32_t rowNode = INT32_MIN;
+    float   rowFz   = 0.0f;
+
+    std::shared_ptr<const LatticeTile> tile;
+    float xs[HEIGHT_BATCH], zs[HEIGHT_BATCH];
+    LowFrequency lf;
+    float* channels[CH] = { lf.WarpX, lf.WarpZ, lf.Continental, lf.Erosion };
+
+    const size_t total = static_cast<size_t>(width) * height;
+    for (size_t begin = 0; begin < total; begin += HEIGHT_BATCH) {
+        const size_t count = std::min(HEIGHT_BATCH, total - begin);
+        for (size_t i = 0; i < count; ++i) {
+            const size_t   idx = begin + i;
+            const uint32_t col = static_cast<uint32_t>(idx % width);
+            const uint32_t row = static_cast<uint32_t>(idx / width);
+            xs[i] = originX + static_cast<float>(col) * step;
+            zs[i] = originZ + static_cast<float>(row) * step;
+
+            if (col == 0 || i == 0) {
+                const float fz = zs[i] * INV_STEP;
+                const int32_t nz = static_cast<int32_t>(std::floor(fz));
+                if (nz != rowNode || fz != rowFz) {
+                    float wz[4];
+                    CubicWeights(fz - static_cast<float>(nz), wz);
+                    for (int32_t k = 0; k < spanNodes; ++k) {
+                        const int32_t nx = firstNode + k;
+                        if (!tile || !tile->CoversColumn(nx, nz))
+                            tile = GetLatticeTile(LatticeTile::TileOf(nx), LatticeTile::TileOf(nz));
+                        const int32_t lx = nx - tile->OriginNodeX;
+                        const int32_t lz = nz - 1 - tile->OriginNodeZ;
+                        for (uint8_t c = 0; c < CH; ++c)
+                            rowSums[static_cast<size_t>(k) * CH + c] =
+                                ColumnSum(tile->Channel(c) + lz * LatticeTile::NODES + lx, wz);
+                    }
+                    rowNode = nz;
+                    rowFz   = fz;
+                }
+            }
+
+            const Column& column = columns[col];
+            const float*  sums   = rowSums.data() + static_cast<size_t>(column.node - 1 - firstNode) * CH;
+            for (uint8_t c = 0; c < CH; ++c)
+                channels[c][i] = column.w[0] * sums[c]          + column.w[1] * sums[CH + c]
+                               + column.w[2] * sums[2 * CH + c] + column.w[3] * sums[3 * CH + c];
+        }
+        FinishHeightBatch(xs, zs, count, lf, out + begin, minWavelength);
+        if (outMaterial) GetMaterialBatch(xs, zs, out + begin, count, outMaterial + begin);
+    }
+}
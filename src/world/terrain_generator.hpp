@@ -1,10 +1,15 @@
 #pragma once
 
-#include "util/math/FastNoiseLite.hpp"
+#include "util/math/lattice_noise.hpp"
+#include "util/math/static_noise.hpp"
 #include "world/config.hpp"
+#include "world/terrain_graph.hpp"
+#include "world/terrain_lattice.hpp"
 #include <cstdint>
 #include <array>
+#include <memory>
 #include <string_view>
+#include <vector>
 
 struct TerrainParams {
     // Elevation key-points in world units; 1 world unit = 1 m (sphere diameter)
@@ -31,35 +36,191 @@ struct Seed256 {
     // static Seed256 Random(); 
 };
 
+// How GetHeightGrid evaluates the low-frequency layers (warp, continentalness, erosion).
+//   Exact  - every sample evaluates every noise module (reference result).
+//   Cached - those layers are read from a per-region coarse lattice with bicubic
+//            interpolation; only the ridged peaks and the surface detail stay per-sample.
+// Worlds must not switch modes once chunks are saved: heights differ slightly.
+enum class TerrainSampling : uint8_t { Exact, Cached };
+
+// Noise backend of the height layers.
+//   Float   - OpenSimplex2 modules (StaticNoise / NoiseBatch); the reference world.
+//   Lattice - LatticeNoise: integer / fixed-point gradient noise on power-of-two
+//             cells. Same layers, seeds and scales, different pattern. Heights are
+//             bit-identical across kernels, CPUs and x86-64 builds (the composition
+//             is plain IEEE float math, built with FP contraction off).
+// Also fixed per world: the two backends produce different terrain.
+enum class TerrainNoise : uint8_t { Float, Lattice };
+
 class TerrainGenerator {
 public:
+    static constexpr size_t HEIGHT_BATCH = 256; // samples per batched pass
+
     // Accepts the full 256-bit seed
-    TerrainGenerator(const Seed256& seed);
+    TerrainGenerator(const Seed256& seed, TerrainSampling sampling = TerrainSampling::Exact,
+                     TerrainNoise noise = TerrainNoise::Float);
 
     // Returns the terrain height at global world coordinates (x, z)
     float GetHeight(float x, float z) const;
 
+    // Fills out[row * width + col] with GetHeight(originX + col*step, originZ + row*step).
+    // Evaluates the height graph in batches (SIMD noise where available); the ridged
+    // peaks are only sampled where the mountain weight is non-zero. In Exact mode
+    // results are bit-identical to calling GetHeight per sample; in Cached mode they
+    // are within GetCachedErrorReport().MaxError of it (measured, not a hard bound).
+    // Thread-safe: lattice tiles are shared between all callers.
+    // outMaterial (optional, same layout) receives the TerrainMaterial of each sample,
+    // classified in the same batches from the height, biome and rock noise.
+    // minWavelength > 0 leaves out the height-layer octaves whose wavelength is shorter
+    // (far, coarse samples); the result is then no longer GetHeight's.
+    void GetHeightGrid(float originX, float originZ, float step,
+                       uint32_t width, uint32_t height, float* out, uint8_t* outMaterial = nullptr,
+                       float minWavelength = 0.0f) const;
+
+    // Longest wavelength among the octaves GetHeightGrid leaves out for minWavelength;
+    // 0 when it keeps them all.
+    float GetOmittedWavelength(float minWavelength) const;
+
+    // out[i] = height at (xs[i], zs[i]) for i < count, batched like GetHeightGrid.
+    void GetHeights(const float* xs, const float* zs, float* out, size_t count,
+                    uint8_t* outMaterial = nullptr) const;
+
+    // GetHeight(x, z) (same bits) plus the analytic terrain slope dH/dx, dH/dz, carried
+    // through the domain warp, the spline / smoothstep stages and every noise octave.
+    // Always exact, whatever the sampling mode. Roughly 2x the cost of GetHeight.
+    float GetHeightAndGradient(float x, float z, float& outDx, float& outDz) const;
+
+    // GetHeightAndGradient over a grid laid out like GetHeightGrid, batched through the
+    // height graph and the SIMD noise kernels. Heights are GetHeight's bits; the slopes
+    // differ from GetHeightAndGradient's by float rounding only. Always exact, whatever
+    // the sampling mode. Any output may be null.
+    void GetHeightAndGradientGrid(float originX, float originZ, float step,
+                                  uint32_t width, uint32_t height,
+                                  float* outHeight, float* outDx, float* outDz) const;
+
+    // Per-node sample counters of the batched height graph (evaluated / pruned).
+    std::vector<TerrainGraph::NodeStats> GetGraphStats() const { return m_HeightGraph.GetStats(); }
+
+    // Hashes the 256-bit master seed + a string identifier to produce a unique 32-bit seed.
+    // Public so the generation passes built on the terrain seed their own noise from it.
+    int DeriveSeed(std::string_view featureID) const;
+
+    TerrainSampling GetSampling() const noexcept { return m_Sampling; }
+    TerrainNoise    GetNoise() const noexcept { return m_Noise; }
+    const TerrainParams& GetParams() const noexcept { return m_Params; }
+
+    // Height error of Cached mode, measured against Exact at probe points of every
+    // lattice tile built so far. All zero in Exact mode.
+    TerrainLatticeCache::ErrorReport GetCachedErrorReport() const { return m_Lattice.GetErrorReport(); }
+
     // Future: GetBiome(x, z), GetTreeDensity(x, z), etc.
 
 private:
     void InitNoise();
-    
-    // Hashes the 256-bit master seed + a string identifier to produce a unique 32-bit seed
-    int DeriveSeed(std::string_view featureID) const;
+
+    // Expresses ComposeHeight and its inputs as m_HeightGraph; keep the two in sync.
+    void BuildHeightGraph();
+
+    // Tail of GetHeight / GetHeightAndGradient: raw module outputs -> final height.
+    float ComposeHeight(float continental, float erosionNoise, float pv, float detailNoise) const;
+
+    // Gradient of ComposeHeight given the value and gradient (x, z) of each input.
+    void ComposeGradient(float continental, const float dContinental[2],
+                         float erosionNoise, const float dErosion[2],
+                         float pv, const float dPv[2],
+                         float detailNoise, const float dDetail[2],
+                         float& outDx, float& outDz) const;
+
+    // Runs the whole pipeline for 'count' samples (count <= HEIGHT_BATCH).
+    void GetHeightBatch(const float* xs, const float* zs, float* out, size_t count,
+                        float minWavelength = 0.0f) const;
+
+    // TerrainMaterial of a batch whose heights are known. The biome and rock noise
+    // are only evaluated for the samples whose height band takes variants.
+    void GetMaterialBatch(const float* xs, const float* zs, const float* heights, size_t count,
+                          uint8_t* out) const;
+
+    // Low-frequency layers per sample: warp displacement (already scaled),
+    // continentalness and raw erosion noise. Exact evaluation / lattice lookup.
+    struct LowFrequency {
+        float WarpX[HEIGHT_BATCH], WarpZ[HEIGHT_BATCH];
+        float Continental[HEIGHT_BATCH], Erosion[HEIGHT_BATCH];
+    };
+    void SampleLowFrequency(const float* xs, const float* zs, size_t count, LowFrequency& lf) const;
+    void InterpolateLowFrequency(const float* xs, const float* zs, size_t count, LowFrequency& lf,
+                                 std::shared_ptr<const LatticeTile>& tile) const;
+
+    // Height graph with the low-frequency layers taken from 'lf'.
+    void FinishHeightBatch(const float* xs, const float* zs, size_t count,
+                           const LowFrequency& lf, float* out, float minWavelength = 0.0f) const;
+
+    // Cached-mode grid: separable bicubic (per-row vertical pass, per-column weights).
+    void GetHeightGridCached(float originX, float originZ, float step,
+                             uint32_t width, uint32_t height, float* out, uint8_t* outMaterial,
+                             float minWavelength) const;
+
+    // Returns the lattice tile, building (and probing) it on first use.
+    std::shared_ptr<const LatticeTile> GetLatticeTile(int32_t tileX, int32_t tileZ) const;
+    std::shared_ptr<const LatticeTile> BuildLatticeTile(int32_t tileX, int32_t tileZ) const;
+
+    // One height layer on the selected noise backend.
+    template <typename FloatNoise>
+    float SampleLayer(const FloatNoise& module, const LatticeNoise& lattice, float x, float z) const {
+        return m_Noise == TerrainNoise::Lattice ? lattice.GetNoise(x, z) : module.GetNoise(x, z);
+    }
+    template <typename FloatNoise>
+    void SampleLayer(const FloatNoise& module, const LatticeNoise& lattice,
+                     const float* xs, const float* zs, float* out, size_t count) const {
+        if (m_Noise == TerrainNoise::Lattice) lattice.GetNoise(xs, zs, out, count);
+        else                                  module.GetNoise(xs, zs, out, count);
+    }
+    template <typename FloatNoise>
+    float SampleLayerDeriv(const FloatNoise& module, const LatticeNoise& lattice, float x, float z,
+                           float& outDx, float& outDz) const {
+        return m_Noise == TerrainNoise::Lattice ? lattice.GetNoiseDeriv(x, z, outDx, outDz)
+                                                : module.GetNoiseDeriv(x, z, outDx, outDz);
+    }
 
 private:
     Seed256 m_MasterSeed;
     TerrainParams m_Params;
+    TerrainSampling m_Sampling;
+    TerrainNoise    m_Noise;
+
+    // Coarse low-frequency lattice (Cached mode only).
+    mutable TerrainLatticeCache m_Lattice;
 
     // --- Noise Modules ---
+    // Noise type, fractal type and octave count are fixed here at compile time;
+    // seeds and frequencies are set in InitNoise.
+    using ContinentalNoise = StaticNoise<NoiseKind::OpenSimplex2, NoiseLayer::Fractal::FBm,    3>;
+    using PeaksNoise       = StaticNoise<NoiseKind::OpenSimplex2, NoiseLayer::Fractal::Ridged, 5>;
+    using ErosionNoise     = StaticNoise<NoiseKind::OpenSimplex2, NoiseLayer::Fractal::FBm,    3>;
+    using WarpNoise        = StaticNoise<NoiseKind::OpenSimplex2, NoiseLayer::Fractal::None,   1>;
+    using DetailNoise      = StaticNoise<NoiseKind::OpenSimplex2, NoiseLayer::Fractal::FBm,    3>;
+    using BiomeNoise       = StaticNoise<NoiseKind::Perlin,       NoiseLayer::Fractal::None,   1>;
+    using RockNoise        = StaticNoise<NoiseKind::Cellular,     NoiseLayer::Fractal::None,   1>;
+
     // Terrain Shape
-    FastNoiseLite m_BaseNoise;
-    FastNoiseLite m_DetailNoise;
-    FastNoiseLite m_MountainNoise;
-    FastNoiseLite m_TerrainMask;
-
-    // Ecology (New additions based on your request)
-    FastNoiseLite m_TreeDensityNoise;
-    FastNoiseLite m_BiomeNoise;
-    FastNoiseLite m_RockNoise;
+    ContinentalNoise m_BaseNoise;
+    DetailNoise      m_DetailNoise;
+    PeaksNoise       m_MountainNoise;
+    ErosionNoise     m_TerrainMask;
+
+    // Lattice backend of the same layers (TerrainNoise::Lattice)
+    LatticeNoise     m_LatticeBase;
+    LatticeNoise     m_LatticeDetail;
+    LatticeNoise     m_LatticeMountain;
+    LatticeNoise     m_LatticeMask;
+    LatticeNoise     m_LatticeWarp;
+
+    // Batched height pipeline over the modules above (see BuildHeightGraph).
+    TerrainGraph       m_HeightGraph;
+    TerrainGraph::Plan m_ExactPlan;   // every node
+    TerrainGraph::Plan m_CachedPlan;  // warp, continentalness and erosion supplied by the lattice
+
+    // Domain warp source, and the surface material layers (both backends use these)
+    WarpNoise        m_TreeDensityNoise;
+    BiomeNoise       m_BiomeNoise;
+    RockNoise        m_RockNoise;
 };
\ No newline at end of file
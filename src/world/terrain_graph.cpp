@@ -0,0 +1,447 @@
+#include "world/terrain_graph.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+// --- Building ---
+
+TerrainGraph::Node& TerrainGraph::Push(const char* name, Op kind, NodeId& outId) {
+    if (m_Count >= MAX_NODES)
+        throw std::runtime_error("TerrainGraph node limit reached!");
+    outId = static_cast<NodeId>(m_Count);
+    Node& node = m_Nodes[m_Count++];
+    node.Name = name;
+    node.Kind = kind;
+    return node;
+}
+
+TerrainGraph::NodeId TerrainGraph::AddNoise(const char* name, NoiseModule noise, NodeId warpX, NodeId warpZ,
+                                            float warpScale, float offset) {
+    NodeId id;
+    Node& node  = Push(name, Op::Noise, id);
+    node.Noise      = std::move(noise.Value);
+    node.NoiseDeriv = std::move(noise.Deriv);
+    node.In[0]  = warpX;
+    node.In[1]  = warpZ;
+    node.Scale  = warpScale;
+    node.Offset = offset;
+    return id;
+}
+
+TerrainGraph::NodeId TerrainGraph::AddRemap(const char* name, NodeId in, std::initializer_list<Segment> segments) {
+    NodeId id;
+    Node& node    = Push(name, Op::Remap, id);
+    node.In[0]    = in;
+    node.Segments = segments;
+    return id;
+}
+
+TerrainGraph::NodeId TerrainGraph::AddRemap(const char* name, NodeId in, float from0, float from1, float to0, float to1) {
+    return AddRemap(name, in, {Segment{0.0f, from0, from1, to0, to1}});
+}
+
+TerrainGraph::NodeId TerrainGraph::AddSmoothStep(const char* name, NodeId in, float edge0, float edge1) {
+    NodeId id;
+    Node& node = Push(name, Op::SmoothStep, id);
+    node.In[0] = in;
+    node.Edge0 = edge0;
+    node.Edge1 = edge1;
+    return id;
+}
+
+TerrainGraph::NodeId TerrainGraph::AddMultiply(const char* name, NodeId a, NodeId b, float scale, bool gated) {
+    NodeId id;
+    Node& node  = Push(name, Op::Multiply, id);
+    node.In[0]  = a;
+    node.In[1]  = b;
+    node.Scale  = scale;
+    node.Gated  = gated && b != NONE;
+    return id;
+}
+
+TerrainGraph::NodeId TerrainGraph::AddAdd(const char* name, NodeId a, NodeId b) {
+    NodeId id;
+    Node& node = Push(name, Op::Add, id);
+    node.In[0] = a;
+    node.In[1] = b;
+    return id;
+}
+
+void TerrainGraph::Finalize(NodeId output) {
+    m_Output = output;
+
+    // Consumers of every node.
+    std::vector<std::vector<NodeId>> consumers(m_Count);
+    for (uint32_t i = 0; i < m_Count; ++i)
+        for (NodeId in : m_Nodes[i].In)
+            if (in != NONE) consumers[in].push_back(static_cast<NodeId>(i));
+
+    // Gated subtree = the gate's first input plus every node whose consumers all lie
+    // inside it. Outer gates first, so nested gates end up with the innermost weight.
+    for (int32_t g = static_cast<int32_t>(m_Count) - 1; g >= 0; --g) {
+        const Node& gate = m_Nodes[g];
+        if (!gate.Gated) continue;
+
+        std::vector<bool> inside(m_Count, false);
+        const NodeId value = gate.In[0];
+        if (consumers[value].size() != 1) continue; // shared value: nothing to prune
+        inside[value] = true;
+
+        for (bool grown = true; grown;) {
+            grown = false;
+            for (uint32_t n = 0; n < m_Count; ++n) {
+                if (inside[n] || consumers[n].empty()) continue;
+                const bool exclusive = std::all_of(consumers[n].begin(), consumers[n].end(),
+                                                   [&](NodeId c) { return inside[c]; });
+                if (exclusive) { inside[n] = true; grown = true; }
+            }
+        }
+        for (uint32_t n = 0; n < m_Count; ++n)
+            if (inside[n]) m_Nodes[n].Gate = gate.In[1];
+    }
+}
+
+TerrainGraph::Plan TerrainGraph::MakePlan(std::initializer_list<NodeId> presets) const {
+    Plan plan;
+    plan.Presets = presets;
+
+    std::vector<bool> preset(m_Count, false), seen(m_Count, false);
+    for (NodeId p : presets) preset[p] = true;
+    Visit(m_Output, preset, seen, plan.Order);
+    return plan;
+}
+
+void TerrainGraph::Visit(NodeId id, const std::vector<bool>& preset, std::vector<bool>& seen,
+                         std::vector<NodeId>& order) const {
+    if (id == NONE || seen[id]) return;
+    seen[id] = true;
+    if (preset[id]) return;
+
+    // Post-order; a gate's weight goes first so it is known before the gated subtree runs.
+    const Node& node = m_Nodes[id];
+    if (node.Gated) {
+        Visit(node.In[1], preset, seen, order);
+        Visit(node.In[0], preset, seen, order);
+    } else {
+        Visit(node.In[0], preset, seen, order);
+        Visit(node.In[1], preset, seen, order);
+    }
+    order.push_back(id);
+}
+
+// --- Evaluation ---
+
+namespace {
+    // fn(i) for every listed sample, or for 0..count-1 when active is null.
+    template <typename Fn>
+    inline void ForEachSample(size_t count, const uint16_t* active, size_t activeCount, Fn&& fn) {
+        if (!active) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+        } else {
+            for (size_t k = 0; k < activeCount; ++k) fn(active[k]);
+        }
+    }
+
+    // Non-zero samples per gate weight, filled the first time a gated node needs them.
+    // Two slots cover a gate and one nested gate; deeper nesting just recomputes.
+    struct GateSlots {
+        std::array<uint16_t, TerrainGraph::BATCH> Active[2];
+        TerrainGraph::NodeId                      Gate[2]  = {TerrainGraph::NONE, TerrainGraph::NONE};
+        size_t                                    Count[2] = {0, 0};
+
+        // Samples where the weight (the batch values of node 'gate') is non-zero.
+        const uint16_t* Find(TerrainGraph::NodeId gate, const float* weight, size_t count, size_t& outCount) {
+            size_t slot = (Gate[0] == gate) ? 0 : (Gate[1] == gate) ? 1 : 2;
+            if (slot == 2) {
+                slot = (Gate[0] == TerrainGraph::NONE) ? 0 : 1;
+                size_t n = 0;
+                for (size_t i = 0; i < count; ++i)
+                    if (weight[i] != 0.0f) Active[slot][n++] = static_cast<uint16_t>(i);
+                Gate[slot]  = gate;
+                Count[slot] = n;
+            }
+            outCount = Count[slot];
+            return Active[slot].data();
+        }
+    };
+}
+
+size_t TerrainGraph::Gather(const Node& node, const float* xs, const float* zs, size_t count,
+                            const uint16_t* active, size_t activeCount, const float* const* in,
+                            float* px, float* pz) {
+    const float* a = node.In[0] != NONE ? in[node.In[0]] : nullptr;
+    const float* b = node.In[1] != NONE ? in[node.In[1]] : nullptr;
+    const bool warped = a && b;
+    size_t n = 0;
+    ForEachSample(count, active, activeCount, [&](size_t i) {
+        if (warped) {
+            px[n] = xs[i] + a[i] * node.Scale;
+            pz[n] = zs[i] + b[i] * node.Scale;
+        } else if (node.Offset != 0.0f) {
+            px[n] = xs[i] + node.Offset;
+            pz[n] = zs[i] + node.Offset;
+        } else {
+            px[n] = xs[i];
+            pz[n] = zs[i];
+        }
+        ++n;
+    });
+    return n;
+}
+
+void TerrainGraph::Run(const Node& node, const float* xs, const float* zs, size_t count,
+                       const uint16_t* active, size_t activeCount,
+                       const float* const* in, float* out, float minWavelength) {
+    const float* a = node.In[0] != NONE ? in[node.In[0]] : nullptr;
+    const float* b = node.In[1] != NONE ? in[node.In[1]] : nullptr;
+
+    switch (node.Kind) {
+        case Op::Noise: {
+            const bool warped = a && b;
+            if (!active && !warped && node.Offset == 0.0f) {
+                node.Noise(xs, zs, out, count, minWavelength);
+                return;
+            }
+            float px[BATCH], pz[BATCH], result[BATCH];
+            const size_t n = Gather(node, xs, zs, count, active, activeCount, in, px, pz);
+            node.Noise(px, pz, active ? result : out, n, minWavelength);
+            if (active)
+                for (size_t k = 0; k < n; ++k) out[active[k]] = result[k];
+            return;
+        }
+        case Op::Remap: {
+            // Spans are the same float subtractions the per-sample formula does; hoisted
+            // into locals so the single-piece loop vectorises.
+            if (node.Segments.size() == 1) {
+                const Segment seg  = node.Segments[0];
+                const float   span = seg.From1 - seg.From0, range = seg.To1 - seg.To0;
+                if (span == 1.0f) { // x / 1 == x exactly: skip the division
+                    ForEachSample(count, active, activeCount, [&](size_t i) {
+                        out[i] = seg.To0 + (a[i] - seg.From0) * range;
+                    });
+                } else {
+                    ForEachSample(count, active, activeCount, [&](size_t i) {
+                        out[i] = seg.To0 + (a[i] - seg.From0) / span * range;
+                    });
+                }
+                return;
+            }
+            const Segment* segments = node.Segments.data();
+            const size_t   last     = node.Segments.size() - 1;
+            ForEachSample(count, active, activeCount, [&](size_t i) {
+                const float v = a[i];
+                size_t s = 0;
+                while (s < last && !(v < segments[s].Below)) ++s;
+                const Segment& seg = segments[s];
+                out[i] = seg.To0 + (v - seg.From0) / (seg.From1 - seg.From0) * (seg.To1 - seg.To0);
+            });
+            return;
+        }
+        case Op::SmoothStep: {
+            const float e0 = node.Edge0, span = node.Edge1 - node.Edge0;
+            ForEachSample(count, active, activeCount, [&](size_t i) {
+                const float t = std::clamp((a[i] - e0) / span, 0.0f, 1.0f);
+                out[i] = t * t * (3.0f - 2.0f * t);
+            });
+            return;
+        }
+        case Op::Multiply: {
+            const float scale = node.Scale;
+            if (b) ForEachSample(count, active, activeCount, [&](size_t i) { out[i] = a[i] * scale * b[i]; });
+            else   ForEachSample(count, active, activeCount, [&](size_t i) { out[i] = a[i] * scale; });
+            return;
+        }
+        case Op::Add: {
+            ForEachSample(count, active, activeCount, [&](size_t i) { out[i] = a[i] + b[i]; });
+            return;
+        }
+    }
+}
+
+void TerrainGraph::Evaluate(const Plan& plan, const float* xs, const float* zs, size_t count, float* out,
+                            const float* const* presetValues, float minWavelength) const {
+    std::array<std::array<float, BATCH>, MAX_NODES> values;
+    std::array<const float*, MAX_NODES>             in{};
+    for (size_t k = 0; k < plan.Presets.size(); ++k)
+        in[plan.Presets[k]] = presetValues[k];
+
+    GateSlots gates;
+    for (NodeId id : plan.Order) {
+        const Node& node = m_Nodes[id];
+        float*      dst  = (id == m_Output) ? out : values[id].data();
+        in[id] = dst;
+
+        if (node.Gate == NONE) {
+            Run(node, xs, zs, count, nullptr, 0, in.data(), dst, minWavelength);
+            node.Evaluated.fetch_add(count, std::memory_order_relaxed);
+            continue;
+        }
+
+        size_t n;
+        const uint16_t* active = gates.Find(node.Gate, in[node.Gate], count, n);
+        if (n == count) {
+            Run(node, xs, zs, count, nullptr, 0, in.data(), dst, minWavelength);
+        } else {
+            std::fill_n(dst, count, 0.0f);
+            if (n > 0) Run(node, xs, zs, count, active, n, in.data(), dst, minWavelength);
+            node.Skipped.fetch_add(count - n, std::memory_order_relaxed);
+        }
+        node.Evaluated.fetch_add(n, std::memory_order_relaxed);
+    }
+}
+
+// --- Gradient ---
+
+void TerrainGraph::RunGradient(const Node& node, const float* xs, const float* zs, size_t count,
+                               const uint16_t* active, size_t activeCount,
+                               const float* const* in, const float* const* inDx, const float* const* inDz,
+                               float* out, float* outDx, float* outDz) {
+    const NodeId ia = node.In[0], ib = node.In[1];
+
+    if (node.Kind == Op::Noise) {
+        const bool warped = ia != NONE && ib != NONE;
+        if (!active && !warped && node.Offset == 0.0f) {
+            node.NoiseDeriv(xs, zs, out, outDx, outDz, count);
+            return;
+        }
+        float px[BATCH], pz[BATCH], value[BATCH], du[BATCH], dv[BATCH];
+        const size_t n = Gather(node, xs, zs, count, active, activeCount, in, px, pz);
+        node.NoiseDeriv(px, pz, value, du, dv, n);
+
+        // d noise(x + s * warpX, z + s * warpZ) / d(x, z) from the module's own (du, dv).
+        const float s      = node.Scale;
+        size_t k = 0;
+        ForEachSample(count, active, activeCount, [&](size_t i) {
+            out[i] = value[k];
+            if (warped) {
+                outDx[i] = du[k] * (1.0f + s * inDx[ia][i]) + dv[k] * (s * inDx[ib][i]);
+                outDz[i] = du[k] * (s * inDz[ia][i])        + dv[k] * (1.0f + s * inDz[ib][i]);
+            } else {
+                outDx[i] = du[k];
+                outDz[i] = dv[k];
+            }
+            ++k;
+        });
+        return;
+    }
+
+    // Values exactly as Evaluate computes them, then the derivative of the same expression.
+    Run(node, xs, zs, count, active, activeCount, in, out, 0.0f);
+
+    const float* a   = in[ia];
+    const float* dax = inDx[ia];
+    const float* daz = inDz[ia];
+    switch (node.Kind) {
+        case Op::Noise:
+            return;
+        case Op::Remap: {
+            const Segment* segments = node.Segments.data();
+            const size_t   last     = node.Segments.size() - 1;
+            ForEachSample(count, active, activeCount, [&](size_t i) {
+                size_t s = 0;
+                while (s < last && !(a[i] < segments[s].Below)) ++s;
+                const Segment& seg   = segments[s];
+                const float    slope = (seg.To1 - seg.To0) / (seg.From1 - seg.From0);
+                outDx[i] = dax[i] * slope;
+                outDz[i] = daz[i] * slope;
+            });
+            return;
+        }
+        case Op::SmoothStep: {
+            const float e0 = node.Edge0, span = node.Edge1 - node.Edge0;
+            ForEachSample(count, active, activeCount, [&](size_t i) {
+                const float t     = (a[i] - e0) / span;
+                const float slope = (t <= 0.0f || t >= 1.0f) ? 0.0f : 6.0f * t * (1.0f - t) / span;
+                outDx[i] = dax[i] * slope;
+                outDz[i] = daz[i] * slope;
+            });
+            return;
+        }
+        case Op::Multiply: {
+            const float scale = node.Scale;
+            if (ib == NONE) {
+                ForEachSample(count, active, activeCount, [&](size_t i) {
+                    outDx[i] = dax[i] * scale;
+                    outDz[i] = daz[i] * scale;
+                });
+                return;
+            }
+            const float* b   = in[ib];
+            const float* dbx = inDx[ib];
+            const float* dbz = inDz[ib];
+            ForEachSample(count, active, activeCount, [&](size_t i) {
+                outDx[i] = dax[i] * scale * b[i] + a[i] * scale * dbx[i];
+                outDz[i] = daz[i] * scale * b[i] + a[i] * scale * dbz[i];
+            });
+            return;
+        }
+        case Op::Add: {
+            const float* dbx = inDx[ib];
+            const float* dbz = inDz[ib];
+            ForEachSample(count, active, activeCount, [&](size_t i) {
+                outDx[i] = dax[i] + dbx[i];
+                outDz[i] = daz[i] + dbz[i];
+            });
+            return;
+        }
+    }
+}
+
+void TerrainGraph::EvaluateGradient(const Plan& plan, const float* xs, const float* zs, size_t count,
+                                    float* out, float* outDx, float* outDz) const {
+    std::array<std::array<float, BATCH>, MAX_NODES> values, gradX, gradZ;
+    std::array<const float*, MAX_NODES>             in{}, inDx{}, inDz{};
+
+    GateSlots gates;
+    for (NodeId id : plan.Order) {
+        const Node& node = m_Nodes[id];
+        const bool  last = id == m_Output;
+        float* dst   = last ? out   : values[id].data();
+        float* dstDx = last ? outDx : gradX[id].data();
+        float* dstDz = last ? outDz : gradZ[id].data();
+        in[id]   = dst;
+        inDx[id] = dstDx;
+        inDz[id] = dstDz;
+
+        if (node.Gate == NONE) {
+            RunGradient(node, xs, zs, count, nullptr, 0, in.data(), inDx.data(), inDz.data(), dst, dstDx, dstDz);
+            node.Evaluated.fetch_add(count, std::memory_order_relaxed);
+            continue;
+        }
+
+        size_t n;
+        const uint16_t* active = gates.Find(node.Gate, in[node.Gate], count, n);
+        if (n == count) {
+            RunGradient(node, xs, zs, count, nullptr, 0, in.data(), inDx.data(), inDz.data(), dst, dstDx, dstDz);
+        } else {
+            std::fill_n(dst, count, 0.0f);
+            std::fill_n(dstDx, count, 0.0f);
+            std::fill_n(dstDz, count, 0.0f);
+            if (n > 0)
+                RunGradient(node, xs, zs, count, active, n, in.data(), inDx.data(), inDz.data(), dst, dstDx, dstDz);
+            node.Skipped.fetch_add(count - n, std::memory_order_relaxed);
+        }
+        node.Evaluated.fetch_add(n, std::memory_order_relaxed);
+    }
+}
+
+// --- Counters ---
+
+std::vector<TerrainGraph::NodeStats> TerrainGraph::GetStats() const {
+    std::vector<NodeStats> stats;
+    stats.reserve(m_Count);
+    for (uint32_t i = 0; i < m_Count; ++i) {
+        const Node& node = m_Nodes[i];
+        stats.push_back({node.Name, node.Kind,
+                         node.Evaluated.load(std::memory_order_relaxed),
+                         node.Skipped.load(std::memory_order_relaxed)});
+    }
+    return stats;
+}
+
+void TerrainGraph::ResetStats() {
+    for (uint32_t i = 0; i < m_Count; ++i) {
+        m_Nodes[i].Evaluated.store(0, std::memory_order_relaxed);
+        m_Nodes[i].Skipped.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+// Small batched evaluation graph for 2D terrain functions.
+//
+// Nodes are noise lookups (optionally domain-warped by two other nodes), piecewise
+// linear remaps, smoothsteps, multiplies and adds. Every node's result is kept for
+// the whole batch, so a node shared by several consumers is evaluated once.
+//
+// Pruning: a Multiply created with 'gated' set treats its second input as a weight.
+// Nodes that only feed the gated multiply's first input are evaluated just for the
+// samples whose weight is non-zero - and not at all when the weight is zero over the
+// whole batch. Skipped samples read 0, which the gate multiplies by a zero weight,
+// so the result is the same value the ungated graph produces (a zero's sign may differ).
+//
+// Each node counts the samples it evaluated and skipped (GetStats).
+//
+// EvaluateGradient carries d/dx, d/dz through the same nodes by the chain rule, when
+// every noise node in the plan was given a NoiseDerivFn.
+//
+// Build with the Add* calls, then Finalize() once. Evaluate() and EvaluateGradient() are
+// thread-safe after that; the counters are relaxed atomics updated once per node per batch.
+class TerrainGraph {
+public:
+    static constexpr size_t   BATCH     = 256; // max samples per Evaluate call
+    static constexpr uint32_t MAX_NODES = 24;
+
+    using NodeId = int32_t;
+    static constexpr NodeId NONE = -1;
+
+    // Batched noise module: out[i] = noise(xs[i], zs[i]) for i < count. Octaves with a
+    // wavelength below minWavelength may be left out (0 = every octave).
+    using NoiseFn = std::function<void(const float* xs, const float* zs, float* out, size_t count,
+                                       float minWavelength)>;
+
+    // Same module with its analytic gradient: out[i] as NoiseFn with every octave,
+    // outDx[i] / outDz[i] = d/dx, d/dz at (xs[i], zs[i]).
+    using NoiseDerivFn = std::function<void(const float* xs, const float* zs, float* out,
+                                            float* outDx, float* outDz, size_t count)>;
+
+    // A noise node's module. Deriv is optional; only EvaluateGradient calls it.
+    struct NoiseModule {
+        NoiseFn      Value;
+        NoiseDerivFn Deriv;
+    };
+
+    enum class Op : uint8_t { Noise, Remap, SmoothStep, Multiply, Add };
+
+    // One piece of a Remap: v in [From0, From1] maps linearly to [To0, To1].
+    // A piece applies while v < Below (the last piece takes everything left).
+    struct Segment {
+        float Below;
+        float From0, From1;
+        float To0,   To1;
+    };
+
+    struct NodeStats {
+        const char* Name;
+        Op          Kind;
+        uint64_t    Evaluated; // samples computed
+        uint64_t    Skipped;   // samples pruned by a zero gate weight
+    };
+
+    TerrainGraph() = default;
+    TerrainGraph(const TerrainGraph&) = delete;
+    TerrainGraph& operator=(const TerrainGraph&) = delete;
+
+    // noise(x + warpX * warpScale, z + warpZ * warpScale), or noise(x + offset, z + offset) unwarped.
+    NodeId AddNoise(const char* name, NoiseModule noise, NodeId warpX = NONE, NodeId warpZ = NONE,
+                    float warpScale = 1.0f, float offset = 0.0f);
+    NodeId AddRemap(const char* name, NodeId in, std::initializer_list<Segment> segments);
+    NodeId AddRemap(const char* name, NodeId in, float from0, float from1, float to0, float to1);
+    NodeId AddSmoothStep(const char* name, NodeId in, float edge0, float edge1);
+    // (a * scale) * b, or a * scale when b is NONE.
+    NodeId AddMultiply(const char* name, NodeId a, NodeId b = NONE, float scale = 1.0f, bool gated = false);
+    NodeId AddAdd(const char* name, NodeId a, NodeId b);
+
+    // Fixes the output node and assigns gate weights to the gated subtrees.
+    void Finalize(NodeId output);
+
+    // Evaluation order for one set of preset nodes (values supplied by the caller).
+    // Nodes needed only by presets are left out.
+    struct Plan {
+        std::vector<NodeId> Order;
+        std::vector<NodeId> Presets;
+    };
+    Plan MakePlan(std::initializer_list<NodeId> presets = {}) const;
+
+    // out[i] = output at (xs[i], zs[i]) for i < count (count <= BATCH).
+    // presetValues[k] holds the values of plan.Presets[k] for the batch.
+    // minWavelength is handed to every noise node (see NoiseFn).
+    void Evaluate(const Plan& plan, const float* xs, const float* zs, size_t count, float* out,
+                  const float* const* presetValues = nullptr, float minWavelength = 0.0f) const;
+
+    // Evaluate (same output bits, every octave) plus the output's gradient d/dx, d/dz.
+    // Warped noise chains through the Jacobian of its warp; smoothsteps are flat where
+    // they clamp. Pruned samples read 0 with a zero gradient. The plan must have no
+    // presets (their gradient is unknown).
+    void EvaluateGradient(const Plan& plan, const float* xs, const float* zs, size_t count,
+                          float* out, float* outDx, float* outDz) const;
+
+    std::vector<NodeStats> GetStats() const;
+    void ResetStats();
+
+private:
+    struct Node {
+        const char* Name   = "";
+        Op          Kind   = Op::Add;
+        NodeId      In[2]  = {NONE, NONE};  // Noise: warp x / z; Multiply, Add: a / b; others: In[0]
+        float       Scale  = 1.0f;          // Noise: warp scale; Multiply: factor on a
+        float       Offset = 0.0f;          // Noise: unwarped coordinate offset
+        float       Edge0  = 0.0f, Edge1 = 1.0f;
+        std::vector<Segment> Segments;
+        NoiseFn     Noise;
+        NoiseDerivFn NoiseDeriv;
+        bool        Gated  = false;
+        NodeId      Gate   = NONE;          // evaluate only where this node is non-zero
+
+        mutable std::atomic<uint64_t> Evaluated{0};
+        mutable std::atomic<uint64_t> Skipped{0};
+    };
+
+    // Appends a node of the given kind and returns it for the caller to fill in.
+    Node& Push(const char* name, Op kind, NodeId& outId);
+    void  Visit(NodeId id, const std::vector<bool>& preset, std::vector<bool>& seen, std::vector<NodeId>& order) const;
+
+    // Evaluates one node into 'out' for the listed samples (every sample if active is null).
+    // 'in' holds the batch values of every node evaluated so far.
+    static void Run(const Node& node, const float* xs, const float* zs, size_t count,
+                    const uint16_t* active, size_t activeCount,
+                    const float* const* in, float* out, float minWavelength);
+
+    // Run (at minWavelength 0) plus the node's gradient; inDx / inDz hold the
+    // gradients of every node evaluated so far.
+    static void RunGradient(const Node& node, const float* xs, const float* zs, size_t count,
+                            const uint16_t* active, size_t activeCount,
+                            const float* const* in, const float* const* inDx, const float* const* inDz,
+                            float* out, float* outDx, float* outDz);
+
+    // Sample coordinates of a noise node (warped / offset) for the listed samples; returns their number.
+    static size_t Gather(const Node& node, const float* xs, const float* zs, size_t count,
+                         const uint16_t* active, size_t activeCount, const float* const* in,
+                         float* px, float* pz);
+
+    std::array<Node, MAX_NODES> m_Nodes;
+    uint32_t                    m_Count  = 0;
+    NodeId                      m_Output = NONE;
+};
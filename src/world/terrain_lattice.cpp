@@ -0,0 +1,36 @@
+#include "world/terrain_lattice.hpp"
+
+#include <algorithm>
+
+std::shared_ptr<const LatticeTile> TerrainLatticeCache::Find(int32_t tileX, int32_t tileZ) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Tiles.find(MakeKey(tileX, tileZ));
+    return it != m_Tiles.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<const LatticeTile> TerrainLatticeCache::Insert(std::shared_ptr<const LatticeTile> tile) {
+    const uint64_t key = MakeKey(tile->TileX, tile->TileZ);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto [it, inserted] = m_Tiles.emplace(key, std::move(tile));
+    if (!inserted) return it->second; // another thread won the race
+
+    m_Error.Tiles++;
+    m_Order.push_back(key);
+    if (m_Capacity > 0 && m_Order.size() > m_Capacity) {
+        m_Tiles.erase(m_Order.front());
+        m_Order.pop_front();
+    }
+    return it->second;
+}
+
+void TerrainLatticeCache::RecordProbes(float maxError, uint32_t count) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Error.MaxError = std::max(m_Error.MaxError, maxError);
+    m_Error.Probes  += count;
+}
+
+TerrainLatticeCache::ErrorReport TerrainLatticeCache::GetErrorReport() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Error;
+}
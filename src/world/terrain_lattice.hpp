@@ -0,0 +1,91 @@
+#pragma once
+
+#include "world/config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Coarse lattice of the low-frequency terrain layers (domain warp, continentalness,
+// erosion) over one region. Nodes sit on a world-aligned grid one chunk apart, so
+// the same world position always interpolates the same node values regardless of
+// which tile it is read from - chunks on either side of a region border agree.
+struct LatticeTile {
+    static constexpr float   STEP  = CHUNK_SIZE * SPHERE_RADIUS; // world units between nodes
+    static constexpr int32_t CELLS = REGION_SIZE;                // lattice intervals per tile side
+    static constexpr int32_t NODES = CELLS + 3;                  // +1 before / +2 after for bicubic support
+
+    enum Channel : uint8_t { WarpX = 0, WarpZ, Continental, Erosion, CHANNEL_COUNT };
+
+    LatticeTile(int32_t tileX, int32_t tileZ)
+        : TileX(tileX), TileZ(tileZ),
+          OriginNodeX(tileX * CELLS - 1), OriginNodeZ(tileZ * CELLS - 1),
+          Data(static_cast<size_t>(CHANNEL_COUNT) * NODES * NODES) {}
+
+    // True if the 4x4 bicubic footprint starting at global node (nodeX-1, nodeZ-1) is inside this tile.
+    bool Covers(int32_t nodeX, int32_t nodeZ) const noexcept {
+        const int32_t lx = nodeX - 1 - OriginNodeX;
+        const int32_t lz = nodeZ - 1 - OriginNodeZ;
+        return lx >= 0 && lz >= 0 && lx + 3 < NODES && lz + 3 < NODES;
+    }
+
+    // True if the 4 nodes (nodeX, nodeZ-1 .. nodeZ+2) of one lattice column are inside this tile.
+    bool CoversColumn(int32_t nodeX, int32_t nodeZ) const noexcept {
+        const int32_t lx = nodeX - OriginNodeX;
+        const int32_t lz = nodeZ - 1 - OriginNodeZ;
+        return lx >= 0 && lz >= 0 && lx < NODES && lz + 3 < NODES;
+    }
+
+    float*       Channel(uint8_t c)       noexcept { return Data.data() + static_cast<size_t>(c) * NODES * NODES; }
+    const float* Channel(uint8_t c) const noexcept { return Data.data() + static_cast<size_t>(c) * NODES * NODES; }
+
+    // Tile that owns the lattice interval containing global node index 'node' (floor division).
+    static int32_t TileOf(int32_t node) noexcept {
+        return node >= 0 ? node / CELLS : (node + 1) / CELLS - 1;
+    }
+
+    int32_t TileX, TileZ;
+    int32_t OriginNodeX, OriginNodeZ; // global node index of local node (0, 0)
+    std::vector<float> Data;          // [channel][z][x], NODES x NODES per channel
+};
+
+// Bounded, thread-safe store of LatticeTiles shared by every generator thread.
+// Tiles are immutable once inserted; the oldest tile is dropped when full
+// (readers holding a shared_ptr keep it alive until they finish).
+// Also accumulates the height error measured at probe points in cached mode.
+class TerrainLatticeCache {
+public:
+    struct ErrorReport {
+        float    MaxError = 0.0f; // max |cached - exact| height over all probes, world units
+        uint32_t Probes   = 0;
+        uint32_t Tiles    = 0;    // tiles built so far
+    };
+
+    explicit TerrainLatticeCache(size_t capacity = 256) : m_Capacity(capacity) {}
+
+    std::shared_ptr<const LatticeTile> Find(int32_t tileX, int32_t tileZ) const;
+
+    // Inserts a freshly built tile. If another thread inserted the same tile first,
+    // that one is kept and returned instead.
+    std::shared_ptr<const LatticeTile> Insert(std::shared_ptr<const LatticeTile> tile);
+
+    void        RecordProbes(float maxError, uint32_t count);
+    ErrorReport GetErrorReport() const;
+
+private:
+    static uint64_t MakeKey(int32_t tileX, int32_t tileZ) noexcept {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(tileX)) << 32)
+             |  static_cast<uint64_t>(static_cast<uint32_t>(tileZ));
+    }
+
+    size_t m_Capacity;
+
+    mutable std::mutex m_Mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<const LatticeTile>> m_Tiles;
+    std::deque<uint64_t> m_Order; // insertion order, front = oldest
+    ErrorReport          m_Error;
+};
@@ -0,0 +1,135 @@
+#include "world/terrain_material.hpp"
+#include "world/config.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Colour band key heights in metres (scaled by FEATURE_SCALE) and their colours;
+    // the gradient between two keys is a smoothstep.
+    constexpr int32_t KEYS = 8;
+    constexpr float   KEY_HEIGHT[KEYS] = { -20.0f, -3.0f, 5.0f, 50.0f, 180.0f, 400.0f, 800.0f, 1400.0f };
+    const glm::vec3   KEY_COLOR[KEYS] = {
+        {0.10f, 0.28f, 0.55f}, // deep ocean
+        {0.22f, 0.55f, 0.82f}, // shallow ocean
+        {0.76f, 0.71f, 0.50f}, // beach
+        {0.24f, 0.50f, 0.11f}, // lowland
+        {0.17f, 0.36f, 0.08f}, // highland
+        {0.44f, 0.37f, 0.28f}, // mountain
+        {0.58f, 0.56f, 0.54f}, // high mountain
+        {0.91f, 0.93f, 0.95f}, // snow
+    };
+
+    // Steps: 1 below the first key, BAND_STEPS per band, one above the last key.
+    constexpr int32_t BAND_STEPS = 8;
+    constexpr int32_t FIRST_BAND = 2;
+    constexpr int32_t LAST_STEP  = FIRST_BAND + (KEYS - 1) * BAND_STEPS;
+    constexpr uint8_t STEP_MASK  = 0x3F;
+    static_assert(LAST_STEP <= STEP_MASK, "height steps must fit six bits");
+
+    // Bands (index of their lower key) that take variants.
+    constexpr int32_t BIOME_BANDS_BEGIN = 2, BIOME_BANDS_END = 5; // beach..mountain
+    constexpr int32_t ROCK_BANDS_BEGIN  = 2, ROCK_BANDS_END  = 6; // beach..high mountain
+
+    // Biome: Perlin, roughly +-0.4 at the 10th / 90th percentile.
+    constexpr float ARID_BELOW = -0.3f;
+    constexpr float LUSH_ABOVE =  0.3f;
+    // Rock: Cellular distance, -1 at a cell centre. Outcrops around the centres,
+    // wider on the upper slopes.
+    constexpr float ROCK_LOW_BELOW  = -0.97f; // bands below 180 m
+    constexpr float ROCK_HIGH_BELOW = -0.90f;
+
+    // Band index of a height in metres: -1 below the first key, KEYS - 1 above the last.
+    inline int32_t BandOf(float metres, float& t) noexcept {
+        t = 0.0f;
+        if (metres < KEY_HEIGHT[0]) return -1;
+        for (int32_t b = 0; b < KEYS - 1; ++b) {
+            if (metres < KEY_HEIGHT[b + 1]) {
+                t = (metres - KEY_HEIGHT[b]) / (KEY_HEIGHT[b + 1] - KEY_HEIGHT[b]);
+                return b;
+            }
+        }
+        return KEYS - 1;
+    }
+
+    inline uint8_t StepOf(int32_t band, float t) noexcept {
+        if (band < 0)         return 1;
+        if (band >= KEYS - 1) return static_cast<uint8_t>(LAST_STEP);
+        const int32_t j = std::clamp(static_cast<int32_t>(t * BAND_STEPS), 0, BAND_STEPS - 1);
+        return static_cast<uint8_t>(FIRST_BAND + band * BAND_STEPS + j);
+    }
+
+    inline uint8_t Make(uint8_t step, TerrainMaterial::Variant variant) noexcept {
+        return static_cast<uint8_t>(step | (static_cast<uint8_t>(variant) << 6));
+    }
+}
+
+namespace TerrainMaterial {
+
+uint8_t Classify(float height, float biome, float rock) noexcept {
+    float t;
+    const int32_t band = BandOf(height / FEATURE_SCALE, t);
+    const uint8_t step = StepOf(band, t);
+
+    if (band >= ROCK_BANDS_BEGIN && band < ROCK_BANDS_END &&
+        rock < (band < 4 ? ROCK_LOW_BELOW : ROCK_HIGH_BELOW))
+        return Make(step, Variant::Rock);
+    if (band >= BIOME_BANDS_BEGIN && band < BIOME_BANDS_END) {
+        if (biome < ARID_BELOW) return Make(step, Variant::Arid);
+        if (biome > LUSH_ABOVE) return Make(step, Variant::Lush);
+    }
+    return Make(step, Variant::Temperate);
+}
+
+uint8_t FromHeight(float height) noexcept {
+    float t;
+    const int32_t band = BandOf(height / FEATURE_SCALE, t);
+    return Make(StepOf(band, t), Variant::Temperate);
+}
+
+uint8_t RockFace(float height) noexcept {
+    float t;
+    const int32_t band = BandOf(height / FEATURE_SCALE, t);
+    return Make(StepOf(band, t), Variant::Rock);
+}
+
+bool HasVariants(float height) noexcept {
+    const float metres = height / FEATURE_SCALE;
+    return metres >= KEY_HEIGHT[ROCK_BANDS_BEGIN] && metres < KEY_HEIGHT[ROCK_BANDS_END];
+}
+
+Variant VariantOf(uint8_t material) noexcept {
+    return static_cast<Variant>(material >> 6);
+}
+
+std::array<glm::vec4, PALETTE_SIZE> BuildPalette() {
+    const glm::vec3 ARID_TINT(0.62f, 0.52f, 0.30f);
+    const glm::vec3 LUSH_TINT(0.10f, 0.38f, 0.10f);
+    const glm::vec3 ROCK_TINT(0.45f, 0.43f, 0.40f);
+
+    std::array<glm::vec4, PALETTE_SIZE> palette;
+    palette.fill(glm::vec4(0.5f, 0.5f, 0.5f, 1.0f));
+
+    for (int32_t step = 1; step <= LAST_STEP; ++step) {
+        // Colour at the middle of the step, as the old per-fragment bands computed it.
+        glm::vec3 base;
+        if (step == 1) {
+            base = KEY_COLOR[0];
+        } else if (step == LAST_STEP) {
+            base = KEY_COLOR[KEYS - 1];
+        } else {
+            const int32_t band = (step - FIRST_BAND) / BAND_STEPS;
+            const float   t    = (static_cast<float>((step - FIRST_BAND) % BAND_STEPS) + 0.5f) / BAND_STEPS;
+            base = glm::mix(KEY_COLOR[band], KEY_COLOR[band + 1], t * t * (3.0f - 2.0f * t));
+        }
+
+        const uint8_t s = static_cast<uint8_t>(step);
+        palette[Make(s, Variant::Temperate)] = glm::vec4(base, 1.0f);
+        palette[Make(s, Variant::Arid)]      = glm::vec4(glm::mix(base, ARID_TINT, 0.45f), 1.0f);
+        palette[Make(s, Variant::Lush)]      = glm::vec4(glm::mix(base, LUSH_TINT, 0.40f), 1.0f);
+        palette[Make(s, Variant::Rock)]      = glm::vec4(glm::mix(base, ROCK_TINT, 0.65f), 1.0f);
+    }
+    return palette;
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+
+// Per-cell surface material: one byte, an index into the palette the renderer
+// uploads (BuildPalette). Computed once at generation from the terrain height,
+// the biome noise and the rock noise, and stored in the low byte of
+// Sphere::ChunkTypeAndFlags and in CompactSphere::color.
+//
+// Byte layout: bits 0..5 = step along the height colour bands, bits 6..7 = Variant.
+// The steps quantise the band gradient (8 steps per band), so the palette
+// reproduces the old per-fragment height colouring to within one step.
+// Variants only apply on land below the snow line; water and beaches stay Temperate.
+namespace TerrainMaterial {
+    enum class Variant : uint8_t { Temperate, Arid, Lush, Rock };
+
+    // Not assigned: spheres saved before materials existed, or added without one.
+    // Chunk::Deserialize and Chunk::AddSphere replace it with FromHeight.
+    constexpr uint8_t  NONE         = 0;
+    constexpr uint32_t PALETTE_SIZE = 256;
+
+    // Material of a surface at world height 'height'. biome and rock are the raw
+    // biome (Perlin) and rock (Cellular distance) noise values at the cell.
+    uint8_t Classify(float height, float biome, float rock) noexcept;
+
+    // Height bands only (Temperate).
+    uint8_t FromHeight(float height) noexcept;
+
+    // Bare rock at 'height' (cave walls, overhang undersides): the height step with
+    // the Rock variant, on every band.
+    uint8_t RockFace(float height) noexcept;
+
+    // True when biome / rock can change Classify's result at this height; the
+    // generator skips both noises everywhere else.
+    bool HasVariants(float height) noexcept;
+
+    // Variant of a material byte (NONE reads as Temperate).
+    Variant VariantOf(uint8_t material) noexcept;
+
+    // RGB (a = 1) per material byte; NONE and unused steps are neutral grey.
+    std::array<glm::vec4, PALETTE_SIZE> BuildPalette();
+}
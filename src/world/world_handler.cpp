@@ -4,6 +4,7 @@
 
 #include <cmath>
 #include <cstring>
+#include <limits>
 
 // --- Construction ---
 
@@ -55,6 +56,54 @@ const Chunk* WorldHandler::GetChunk(ChunkCoordinates coords) const {
     return m_Streamer.GetChunk(coords);
 }
 
+float WorldHandler::SampleHeight(float x, float z, HeightSource* outSource) const {
+    float        height;
+    HeightSource source;
+    SampleHeights(&x, &z, &height, 1, &source);
+    if (outSource) *outSource = source;
+    return height;
+}
+
+void WorldHandler::SampleHeights(const float* xs, const float* zs, float* out, size_t count,
+                                 HeightSource* outSources) const {
+    constexpr int32_t CS = CHUNK_SIZE;
+    auto floorDiv = [](int32_t a, int32_t b) { return (a >= 0 ? a : a - b + 1) / b; };
+
+    // Misses are gathered and sent to the generator in one batch.
+    std::vector<int32_t> missX, missZ;
+    std::vector<size_t>  missIndex;
+
+    for (size_t i = 0; i < count; ++i) {
+        // Cell centres sit on integer multiples of SPHERE_RADIUS.
+        const int32_t cellX = static_cast<int32_t>(std::floor(xs[i] / SPHERE_RADIUS + 0.5f));
+        const int32_t cellZ = static_cast<int32_t>(std::floor(zs[i] / SPHERE_RADIUS + 0.5f));
+        const ChunkCoordinates coords(floorDiv(cellX, CS), floorDiv(cellZ, CS));
+
+        const Chunk* chunk = m_Streamer.GetChunk(coords);
+        if (!chunk) {
+            missX.push_back(cellX);
+            missZ.push_back(cellZ);
+            missIndex.push_back(i);
+            continue;
+        }
+
+        const int16_t h = chunk->GetSurfaceHeight(static_cast<uint8_t>(cellX - coords.X * CS),
+                                                  static_cast<uint8_t>(cellZ - coords.Z * CS));
+        out[i] = (h == Chunk::NO_SURFACE) ? -std::numeric_limits<float>::infinity()
+                                          : static_cast<float>(h) * SPHERE_RADIUS;
+        if (outSources) outSources[i] = chunk->IsLODOnly() ? HeightSource::LOD : HeightSource::Resident;
+    }
+
+    if (missIndex.empty()) return;
+
+    std::vector<int16_t> generated(missIndex.size());
+    m_Streamer.GetGenerator().GetSurfaceHeights(missX.data(), missZ.data(), generated.data(), missIndex.size());
+    for (size_t k = 0; k < missIndex.size(); ++k) {
+        out[missIndex[k]] = static_cast<float>(generated[k]) * SPHERE_RADIUS;
+        if (outSources) outSources[missIndex[k]] = HeightSource::Generated;
+    }
+}
+
 void WorldHandler::Shutdown() {
     m_Streamer.FlushAll();
     SaveWorldHeader();
@@ -7,6 +7,13 @@
 #include <string>
 #include <vector>
 
+// Where WorldHandler::SampleHeight found its answer.
+enum class HeightSource : uint8_t {
+    Resident,   // full-detail chunk in the cache: exact surface, edits included
+    LOD,        // LOD-only chunk in the cache: one height per 2x2 cell block
+    Generated   // chunk not loaded: terrain generator, as Generate() would build it
+};
+
 // Top-level orchestrator for the infinite world.
 //
 // Responsibilities:
@@ -16,6 +23,8 @@
 //     CHUNK_UPDATE_DISTANCE chunks in the XZ plane from the last trigger point,
 //     preventing rapid load/unload when the player oscillates near a chunk boundary.
 //   - Provides renderer-facing Chunk* access via GetChunk().
+//   - Answers terrain height queries (SampleHeight) from resident chunks, falling
+//     back to the generator for the rest.
 class WorldHandler {
 public:
     static constexpr int32_t CHUNK_COUNT = REGION_SIZE * REGION_SIZE;
@@ -30,10 +39,25 @@ public:
     // Returns true if the chunk cache changed (new chunks or evictions) - use to gate SyncChunks.
     bool Update(const glm::vec3& playerPos);
 
+    // Pass-through to ChunkStreamer; set before Update so new chunks in view load first.
+    void SetViewFrustum(const Frustum& frustum) { m_Streamer.SetViewFrustum(frustum); }
+
     // Read-only chunk access for the renderer (nullptr if not yet loaded).
     Chunk*       GetChunk(ChunkCoordinates coords);
     const Chunk* GetChunk(ChunkCoordinates coords) const;
 
+    // World-space height of the surface (centre of the top sphere) of the cell column
+    // nearest to (x, z). Read from the chunk's runs (Chunk::GetSurfaceHeight) when the
+    // chunk is cached; otherwise sampled from the terrain generator, which is the height the
+    // chunk will get when it is generated (edits on disk are not seen). Returns
+    // -infinity for a column with no sphere left around it.
+    float SampleHeight(float x, float z, HeightSource* outSource = nullptr) const;
+
+    // out[i] = SampleHeight(xs[i], zs[i]) for i < count; the generator fallbacks are
+    // evaluated as one batch. outSources (optional) receives each query's path.
+    void SampleHeights(const float* xs, const float* zs, float* out, size_t count,
+                       HeightSource* outSources = nullptr) const;
+
     // Pass-through to ChunkStreamer; renderer uses this delta to avoid full ring scans.
     std::vector<ChunkCoordinates> ConsumeRecentlyArrived() { return m_Streamer.ConsumeRecentlyArrived(); }
 
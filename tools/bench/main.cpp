@@ -0,0 +1,543 @@
+// bench_world - terrain and chunk micro-benchmarks.
+//
+// Runs the world pipeline over fixed seeds and fixed chunk blocks so numbers are
+// comparable across commits:
+//   ocean     - flat deep-ocean floor
+//   plains    - lowland plains just above the shore
+//   mountains - ridged peaks above the highland level
+//
+// For each scenario it times TerrainGenerator (per-sample, with gradient, grid, gradient grid),
+// the share of grid samples that reached the ridged peaks noise (height graph pruning),
+// ChunkGenerator (full chunk generation, which includes FillChunk, and the far-ring
+// LOD-only mode), Chunk::GenerateLODs, ChunkGenerator::Scatter (tree / boulder instances),
+// Chunk::GenerateMesh (full detail and adaptive), Chunk::Serialize/Deserialize, the RAM
+// held by the spheres of a generated chunk, and random lookups into it: cell ranges
+// (Chunk::GetCell's SphereColumns::GetCellRange) and points (Chunk::BinarySearch).
+// Every stage runs --repeat times and reports the fastest pass. Built with
+// -DGEN_PROFILE=1 it also prints the per-module / per-stage generation profile.
+//
+// usage: bench_world [--repeat N] [--json out.json] [--label text] [--sampling exact|cached]
+//                    [--noise float|lattice] [--erosion none|hydraulic] [--density none|narrowband]
+//                    [--verify]
+// Scenario locations were picked on the float world; with --noise lattice they
+// time the same coordinates, which hold different terrain. --erosion and --density
+// default to none so the numbers stay comparable with runs from before those passes.
+//
+// --verify times nothing: it hashes every scenario block's Generate + GenerateLODs output
+// (spheres, bounds, LODs) once per FillChunk column kernel (SSE2 and scalar) and fails
+// unless each hash matches the one recorded from the scalar FillChunk before the SSE2
+// column pass. Golden hashes exist for the default modes only; with any other option the
+// kernels just have to agree.
+
+#include "world/chunk_generator.hpp"
+#include "world/gen_profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Scenario {
+        const char*      name;
+        Seed256          seed;
+        ChunkCoordinates origin; // north-west chunk of the block
+        uint64_t         golden; // --verify hash with the default modes
+    };
+
+    // Blocks located with the game seed (GameLayer::kWorldSeed); keep them fixed.
+    const Seed256 kGameSeed{941456789ULL, 423654321ULL, 111222333ULL, 444555666ULL};
+    const Scenario kScenarios[] = {
+        {"ocean",     kGameSeed, ChunkCoordinates( 2600, -4000), 0xdddf86967ab58cb1ULL}, // height ~ -190, flat
+        {"plains",    kGameSeed, ChunkCoordinates(-3320, -4000), 0x70dfc29a1e5324baULL}, // height ~ 1..5
+        {"mountains", kGameSeed, ChunkCoordinates(-3320, -3040), 0x1d39f52f81c8ab0bULL}, // height ~ 840..1200
+    };
+
+    constexpr int32_t BLOCK = 8; // BLOCK x BLOCK chunks per scenario
+
+    struct Result {
+        std::string name;
+        double heightNs     = 0; // ns per TerrainGenerator::GetHeight sample
+        double gridNs       = 0; // ns per sample through GetHeightGrid
+        double gradientNs   = 0; // ns per TerrainGenerator::GetHeightAndGradient sample
+        double gradGridNs   = 0; // ns per sample through GetHeightAndGradientGrid
+        double peaksShare   = 0; // evaluated / (evaluated + skipped) of the graph's "peaks" node
+        double generateNs   = 0; // ns per ChunkGenerator::Generate
+        double lodNs        = 0; // ns per Chunk::GenerateLODs
+        double lodOnlyNs    = 0; // ns per ChunkGenerator::GenerateLODOnly
+        double scatterNs    = 0; // ns per ChunkGenerator::Scatter
+        double meshNs       = 0; // ns per full-detail Chunk::GenerateMesh
+        double meshLodNs    = 0; // ns per adaptive Chunk::GenerateMesh
+        double serializeNs  = 0;
+        double deserializeNs = 0;
+        double cellNs       = 0; // ns per random cell range lookup
+        double findNs       = 0; // ns per random Chunk::BinarySearch of an existing sphere
+        double spheresPerChunk = 0;
+        double bytesPerChunk   = 0; // serialized
+        double ramPerChunk     = 0; // Chunk::GetSphereMemory
+        double lodSpheresPerChunk = 0;
+        double instancesPerChunk  = 0; // scatter instances
+    };
+
+    double NsSince(Clock::time_point start) {
+        return static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    // Runs fn 'repeat' times and returns the fastest pass in ns.
+    template <typename Fn>
+    double Best(uint32_t repeat, Fn&& fn) {
+        double best = 1e300;
+        for (uint32_t r = 0; r < repeat; ++r) {
+            const auto start = Clock::now();
+            fn();
+            best = std::min(best, NsSince(start));
+        }
+        return best;
+    }
+
+    // Keeps results observable so the optimiser cannot drop the timed work.
+    volatile float g_Sink = 0.0f;
+
+    Result RunScenario(const Scenario& sc, uint32_t repeat, TerrainSampling sampling, TerrainNoise noise,
+                       TerrainErosion erosion, TerrainDensity density) {
+        Result res;
+        res.name = sc.name;
+
+        constexpr uint32_t CHUNKS = BLOCK * BLOCK;
+        constexpr float    chunkWorld = CHUNK_SIZE * SPHERE_RADIUS;
+        const float originX = sc.origin.X * chunkWorld;
+        const float originZ = sc.origin.Z * chunkWorld;
+
+        // --- Terrain sampling ---
+        // One height per sphere column over the block (same spacing chunk generation uses).
+        {
+            const TerrainGenerator terrain(sc.seed, sampling, noise);
+            constexpr uint32_t side    = BLOCK * CHUNK_SIZE;
+            constexpr uint32_t samples = side * side;
+            std::vector<float> grid(samples);
+
+            res.heightNs = Best(repeat, [&] {
+                float acc = 0.0f;
+                for (uint32_t z = 0; z < side; ++z)
+                    for (uint32_t x = 0; x < side; ++x)
+                        acc += terrain.GetHeight(originX + x * SPHERE_RADIUS, originZ + z * SPHERE_RADIUS);
+                g_Sink = acc;
+            }) / samples;
+
+            res.gradientNs = Best(repeat, [&] {
+                float acc = 0.0f;
+                for (uint32_t z = 0; z < side; ++z) {
+                    for (uint32_t x = 0; x < side; ++x) {
+                        float dx, dz;
+                        acc += terrain.GetHeightAndGradient(originX + x * SPHERE_RADIUS,
+                                                            originZ + z * SPHERE_RADIUS, dx, dz) + dx + dz;
+                    }
+                }
+                g_Sink = acc;
+            }) / samples;
+
+            res.gridNs = Best(repeat, [&] {
+                terrain.GetHeightGrid(originX, originZ, SPHERE_RADIUS, side, side, grid.data());
+                g_Sink = grid[samples / 2];
+            }) / samples;
+
+            std::vector<float> dx(samples), dz(samples);
+            res.gradGridNs = Best(repeat, [&] {
+                terrain.GetHeightAndGradientGrid(originX, originZ, SPHERE_RADIUS, side, side,
+                                                 grid.data(), dx.data(), dz.data());
+                g_Sink = grid[samples / 2] + dx[samples / 2] + dz[samples / 2];
+            }) / samples;
+
+            for (const TerrainGraph::NodeStats& node : terrain.GetGraphStats()) {
+                if (std::strcmp(node.Name, "peaks") != 0) continue;
+                const uint64_t total = node.Evaluated + node.Skipped;
+                res.peaksShare = total ? static_cast<double>(node.Evaluated) / static_cast<double>(total) : 0.0;
+            }
+        }
+
+        // --- Chunk generation ---
+        // A fresh generator per pass: its edge cache would otherwise carry over between passes.
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        res.generateNs = 1e300;
+        for (uint32_t r = 0; r < repeat; ++r) {
+            const ChunkGenerator generator(sc.seed, sampling, noise, erosion, density);
+            chunks.clear();
+            chunks.reserve(CHUNKS);
+            const auto start = Clock::now();
+            for (int32_t z = 0; z < BLOCK; ++z) {
+                for (int32_t x = 0; x < BLOCK; ++x) {
+                    auto chunk = std::make_unique<Chunk>(sc.origin.X + x, sc.origin.Z + z);
+                    generator.Generate(*chunk);
+                    chunks.push_back(std::move(chunk));
+                }
+            }
+            res.generateNs = std::min(res.generateNs, NsSince(start));
+        }
+        res.generateNs /= CHUNKS;
+
+        size_t spheres = 0, ram = 0;
+        for (const auto& chunk : chunks) {
+            spheres += chunk->GetSize();
+            ram     += chunk->GetSphereMemory();
+        }
+        res.spheresPerChunk = static_cast<double>(spheres) / CHUNKS;
+        res.ramPerChunk     = static_cast<double>(ram) / CHUNKS;
+
+        // --- Lookups ---
+        // Fixed pseudo-random queries over the whole block; points are existing spheres.
+        {
+            constexpr uint32_t QUERIES = 1u << 16;
+            std::vector<std::pair<uint32_t, uint16_t>>       cells(QUERIES);
+            std::vector<std::pair<uint32_t, SpherePosition>> points;
+            std::vector<std::vector<SpherePosition>>         positions(CHUNKS);
+            for (uint32_t i = 0; i < CHUNKS; ++i)
+                for (const Sphere& sphere : chunks[i]->GetSpheres()) positions[i].push_back(sphere.Position);
+
+            uint32_t state = 0x9E3779B9u;
+            auto next = [&state] { state = state * 1664525u + 1013904223u; return state >> 8; };
+            for (auto& q : cells) q = { next() % CHUNKS, static_cast<uint16_t>(next() % (CHUNK_SIZE * CHUNK_SIZE)) };
+            points.reserve(QUERIES);
+            while (points.size() < QUERIES) {
+                const uint32_t chunk = next() % CHUNKS;
+                if (!positions[chunk].empty())
+                    points.push_back({ chunk, positions[chunk][next() % positions[chunk].size()] });
+            }
+
+            res.cellNs = Best(repeat, [&] {
+                uint32_t acc = 0;
+                for (const auto& [chunk, cell] : cells) {
+                    uint32_t offset = 0, size = 0;
+                    chunks[chunk]->GetSpheres().GetCellRange(cell, offset, size);
+                    acc += offset + size;
+                }
+                g_Sink = static_cast<float>(acc);
+            }) / QUERIES;
+
+            res.findNs = Best(repeat, [&] {
+                uint32_t acc = 0;
+                for (const auto& [chunk, pos] : points) {
+                    uint32_t index = 0;
+                    acc += chunks[chunk]->BinarySearch(pos, index) ? index : 0;
+                }
+                g_Sink = static_cast<float>(acc);
+            }) / QUERIES;
+        }
+
+        // --- LODs ---
+        res.lodNs = Best(repeat, [&] {
+            for (auto& chunk : chunks) chunk->GenerateLODs();
+        }) / CHUNKS;
+
+        res.lodOnlyNs = 1e300;
+        for (uint32_t r = 0; r < repeat; ++r) {
+            const ChunkGenerator generator(sc.seed, sampling, noise, erosion, density);
+            const auto start = Clock::now();
+            for (int32_t z = 0; z < BLOCK; ++z) {
+                for (int32_t x = 0; x < BLOCK; ++x) {
+                    Chunk chunk(sc.origin.X + x, sc.origin.Z + z);
+                    generator.GenerateLODOnly(chunk);
+                    g_Sink = chunk.GetBounds().m_Max.y;
+                }
+            }
+            res.lodOnlyNs = std::min(res.lodOnlyNs, NsSince(start));
+        }
+        res.lodOnlyNs /= CHUNKS;
+
+        // --- Scatter ---
+        {
+            const ChunkGenerator generator(sc.seed, sampling, noise, erosion, density);
+            res.scatterNs = Best(repeat, [&] {
+                for (auto& chunk : chunks) generator.Scatter(*chunk);
+            }) / CHUNKS;
+        }
+        size_t instances = 0;
+        for (const auto& chunk : chunks) instances += chunk->GetScatter().size();
+        res.instancesPerChunk = static_cast<double>(instances) / CHUNKS;
+
+        size_t lodSpheres = 0;
+        for (const auto& chunk : chunks) lodSpheres += chunk->GetLODs().data.size();
+        res.lodSpheresPerChunk = static_cast<double>(lodSpheres) / CHUNKS;
+
+        // --- Meshing ---
+        std::vector<GPUSphere> mesh;
+        res.meshNs = Best(repeat, [&] {
+            for (const auto& chunk : chunks) {
+                mesh.clear();
+                chunk->GenerateMesh(mesh, SPHERE_RADIUS);
+            }
+        }) / CHUNKS;
+
+        res.meshLodNs = Best(repeat, [&] {
+            for (const auto& chunk : chunks) {
+                mesh.clear();
+                chunk->GenerateMesh(mesh, SPHERE_RADIUS, 1.0f, 8);
+            }
+        }) / CHUNKS;
+
+        // --- Serialization ---
+        std::vector<std::vector<uint8_t>> blobs(CHUNKS);
+        res.serializeNs = Best(repeat, [&] {
+            for (uint32_t i = 0; i < CHUNKS; ++i) {
+                blobs[i].clear();
+                chunks[i]->Serialize(blobs[i]);
+            }
+        }) / CHUNKS;
+
+        size_t bytes = 0;
+        for (const auto& blob : blobs) bytes += blob.size();
+        res.bytesPerChunk = static_cast<double>(bytes) / CHUNKS;
+
+        res.deserializeNs = Best(repeat, [&] {
+            for (uint32_t i = 0; i < CHUNKS; ++i) {
+                Chunk chunk(0, 0);
+                chunk.Deserialize(blobs[i], 0);
+                g_Sink = static_cast<float>(chunk.GetSize());
+            }
+        }) / CHUNKS;
+
+        return res;
+    }
+
+    // FNV-1a 64, fed field by field so struct padding and storage layout never count.
+    struct Fnv {
+        uint64_t Hash = 14695981039346656037ULL;
+        template <typename T>
+        void Add(const T& value) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                Hash ^= bytes[i];
+                Hash *= 1099511628211ULL;
+            }
+        }
+    };
+
+    void HashChunk(const Chunk& chunk, Fnv& fnv) {
+        fnv.Add(chunk.GetSize());
+        for (const Sphere& sphere : chunk.GetSpheres()) {
+            fnv.Add(sphere.Position.CellIndex);
+            fnv.Add(sphere.Position.DiscreteHeight);
+            fnv.Add(sphere.ChunkTypeAndFlags);
+            fnv.Add(sphere.AmbientOcclusion);
+            for (const LightVector& light : sphere.Lights) {
+                fnv.Add(light.R);
+                fnv.Add(light.G);
+                fnv.Add(light.B);
+            }
+        }
+        const BoundBox& bb = chunk.GetBounds();
+        for (const float v : { bb.m_Min.x, bb.m_Min.y, bb.m_Min.z, bb.m_Max.x, bb.m_Max.y, bb.m_Max.z })
+            fnv.Add(v);
+        const ChunkLODSet& lods = chunk.GetLODs();
+        for (uint32_t i = 0; i < LOD_LEVELS; ++i) {
+            fnv.Add(lods.lodOffsets[i]);
+            fnv.Add(lods.lodCounts[i]);
+        }
+        for (const CompactSphere& cs : lods.data) {
+            fnv.Add(cs.lx);
+            fnv.Add(cs.ly);
+            fnv.Add(cs.lz);
+            fnv.Add(cs.lodStep);
+            fnv.Add(cs.color);
+        }
+    }
+
+    uint64_t HashScenario(const Scenario& sc, TerrainSampling sampling, TerrainNoise noise,
+                          TerrainErosion erosion, TerrainDensity density) {
+        const ChunkGenerator generator(sc.seed, sampling, noise, erosion, density);
+        Fnv fnv;
+        for (int32_t z = 0; z < BLOCK; ++z) {
+            for (int32_t x = 0; x < BLOCK; ++x) {
+                Chunk chunk(sc.origin.X + x, sc.origin.Z + z);
+                generator.Generate(chunk);
+                chunk.GenerateLODs();
+                HashChunk(chunk, fnv);
+            }
+        }
+        return fnv.Hash;
+    }
+
+    // 0 when every column kernel reproduces the golden hashes (or, off the default
+    // modes, when the kernels agree with each other).
+    int Verify(TerrainSampling sampling, TerrainNoise noise, TerrainErosion erosion, TerrainDensity density) {
+        const bool defaults = sampling == TerrainSampling::Exact && noise == TerrainNoise::Float &&
+                              erosion == TerrainErosion::None && density == TerrainDensity::None;
+        const ChunkGenerator::ColumnKernel active = ChunkGenerator::GetColumnKernel();
+        const ChunkGenerator::ColumnKernel kernels[] = { ChunkGenerator::ColumnKernel::SSE2,
+                                                         ChunkGenerator::ColumnKernel::Scalar };
+        bool passed = true;
+        for (const Scenario& sc : kScenarios) {
+            uint64_t first = 0;
+            for (const ChunkGenerator::ColumnKernel kernel : kernels) {
+                ChunkGenerator::SetColumnKernel(kernel);
+                if (ChunkGenerator::GetColumnKernel() != kernel) continue; // not built in
+                const uint64_t hash = HashScenario(sc, sampling, noise, erosion, density);
+                if (first == 0) first = hash;
+
+                const bool ok = defaults ? hash == sc.golden : hash == first;
+                std::printf("%-10s %-6s %016" PRIx64 " %s\n", sc.name, ChunkGenerator::ColumnKernelName(kernel),
+                            hash, ok ? "ok" : "MISMATCH");
+                passed = passed && ok;
+            }
+        }
+        ChunkGenerator::SetColumnKernel(active);
+
+        if (!passed) {
+            std::fprintf(stderr, "[Bench] Verify FAILED: %s.\n",
+                         defaults ? "output differs from the golden hashes" : "column kernels disagree");
+            return 1;
+        }
+        std::printf("[Bench] Verify passed%s.\n", defaults ? "" : " (kernels agree; no golden hash for these modes)");
+        return 0;
+    }
+
+    void PrintTable(const std::vector<Result>& results) {
+        std::printf("%-10s %9s %9s %9s %9s %9s %10s %9s %9s %9s %9s %9s %9s %9s %9s %9s %9s %9s %9s %9s %9s\n",
+                    "scenario", "ns/samp", "grad ns", "grid ns", "ggrid ns", "peaks %", "chunks/s", "gen us", "lod us", "lodgen us",
+                    "scat us", "mesh us", "meshL us", "ser us", "deser us", "cell ns", "find ns", "sph/chk", "inst/chk",
+                    "B/chk", "RAM B/chk");
+        for (const Result& r : results) {
+            std::printf("%-10s %9.1f %9.1f %9.1f %9.1f %9.1f %10.0f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %9.1f %9.1f %9.1f %9.2f %9.0f %9.0f\n",
+                        r.name.c_str(), r.heightNs, r.gradientNs, r.gridNs, r.gradGridNs, r.peaksShare * 100.0,
+                        1e9 / r.generateNs,
+                        r.generateNs / 1e3, r.lodNs / 1e3, r.lodOnlyNs / 1e3, r.scatterNs / 1e3,
+                        r.meshNs / 1e3, r.meshLodNs / 1e3, r.serializeNs / 1e3, r.deserializeNs / 1e3,
+                        r.cellNs, r.findNs, r.spheresPerChunk, r.instancesPerChunk, r.bytesPerChunk, r.ramPerChunk);
+        }
+    }
+
+    // Only with GEN_PROFILE: where the time of every scenario above went, summed.
+    void PrintProfile(const GenProfiler::Report& report) {
+        auto row = [](const char* name, const GenProfiler::Counter& c) {
+            if (c.Calls == 0) return;
+            std::printf("%-12s %12llu %14llu %16llu %12.1f\n", name,
+                        static_cast<unsigned long long>(c.Calls), static_cast<unsigned long long>(c.Items),
+                        static_cast<unsigned long long>(c.Cycles),
+                        c.Items ? static_cast<double>(c.Cycles) / static_cast<double>(c.Items) : 0.0);
+        };
+        std::printf("\n%-12s %12s %14s %16s %12s\n", "profile", "calls", "items", "cycles", "cyc/item");
+        for (size_t i = 0; i < report.Modules.size(); ++i)
+            row(GenProfiler::Name(static_cast<GenProfiler::Module>(i)), report.Modules[i]);
+        for (size_t i = 0; i < report.Stages.size(); ++i)
+            row(GenProfiler::Name(static_cast<GenProfiler::Stage>(i)), report.Stages[i]);
+    }
+
+    bool WriteJson(const std::string& path, const std::string& label, const char* sampling,
+                   const char* noise, const char* erosion, const char* density, uint32_t repeat,
+                   const std::vector<Result>& results) {
+        FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) {
+            std::fprintf(stderr, "[Bench] Cannot open %s for writing\n", path.c_str());
+            return false;
+        }
+
+        std::fprintf(f, "{\n  \"label\": \"");
+        for (char c : label) {
+            if (c == '"' || c == '\\') std::fputc('\\', f);
+            std::fputc(c, f);
+        }
+        std::fprintf(f, "\",\n  \"sampling\": \"%s\",\n  \"noise\": \"%s\",\n  \"erosion\": \"%s\",\n"
+                        "  \"density\": \"%s\",\n  \"repeat\": %u,\n  \"chunks_per_scenario\": %d,\n",
+                     sampling, noise, erosion, density, repeat, BLOCK * BLOCK);
+        std::fprintf(f, "  \"scenarios\": [\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::fprintf(f,
+                "    {\"name\": \"%s\", \"ns_per_sample\": %.3f, \"gradient_ns_per_sample\": %.3f, "
+                "\"grid_ns_per_sample\": %.3f, \"gradient_grid_ns_per_sample\": %.3f, \"peaks_share\": %.4f, "
+                "\"chunks_per_s\": %.1f, \"generate_ns\": %.0f, \"lod_ns\": %.0f, \"lod_only_ns\": %.0f, "
+                "\"scatter_ns\": %.0f, \"mesh_ns\": %.0f, \"mesh_adaptive_ns\": %.0f, \"serialize_ns\": %.0f, "
+                "\"deserialize_ns\": %.0f, \"cell_lookup_ns\": %.2f, \"find_ns\": %.2f, \"spheres_per_chunk\": %.2f, "
+                "\"lod_spheres_per_chunk\": %.2f, \"instances_per_chunk\": %.2f, \"bytes_per_chunk\": %.1f, "
+                "\"sphere_ram_per_chunk\": %.1f}%s\n",
+                r.name.c_str(), r.heightNs, r.gradientNs, r.gridNs, r.gradGridNs, r.peaksShare, 1e9 / r.generateNs,
+                r.generateNs, r.lodNs, r.lodOnlyNs, r.scatterNs,
+                r.meshNs, r.meshLodNs, r.serializeNs, r.deserializeNs, r.cellNs, r.findNs, r.spheresPerChunk,
+                r.lodSpheresPerChunk, r.instancesPerChunk, r.bytesPerChunk, r.ramPerChunk, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        std::fclose(f);
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t        repeat   = 5;
+    std::string     jsonPath;
+    std::string     label;
+    TerrainSampling sampling = TerrainSampling::Exact;
+    TerrainNoise    noise    = TerrainNoise::Float;
+    TerrainErosion  erosion  = TerrainErosion::None;
+    TerrainDensity  density  = TerrainDensity::None;
+    bool            verify   = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--repeat" && value) {
+            repeat = static_cast<uint32_t>(std::max(1, std::atoi(value)));
+            ++i;
+        } else if (arg == "--json" && value) {
+            jsonPath = value;
+            ++i;
+        } else if (arg == "--label" && value) {
+            label = value;
+            ++i;
+        } else if (arg == "--sampling" && value && std::strcmp(value, "cached") == 0) {
+            sampling = TerrainSampling::Cached;
+            ++i;
+        } else if (arg == "--sampling" && value && std::strcmp(value, "exact") == 0) {
+            ++i;
+        } else if (arg == "--noise" && value && std::strcmp(value, "lattice") == 0) {
+            noise = TerrainNoise::Lattice;
+            ++i;
+        } else if (arg == "--noise" && value && std::strcmp(value, "float") == 0) {
+            ++i;
+        } else if (arg == "--erosion" && value && std::strcmp(value, "hydraulic") == 0) {
+            erosion = TerrainErosion::Hydraulic;
+            ++i;
+        } else if (arg == "--erosion" && value && std::strcmp(value, "none") == 0) {
+            ++i;
+        } else if (arg == "--density" && value && std::strcmp(value, "narrowband") == 0) {
+            density = TerrainDensity::NarrowBand;
+            ++i;
+        } else if (arg == "--density" && value && std::strcmp(value, "none") == 0) {
+            ++i;
+        } else if (arg == "--verify") {
+            verify = true;
+        } else {
+            std::fprintf(stderr,
+                "usage: bench_world [--repeat N] [--json out.json] [--label text] [--sampling exact|cached]"
+                " [--noise float|lattice] [--erosion none|hydraulic] [--density none|narrowband] [--verify]\n");
+            return 1;
+        }
+    }
+
+    if (verify) return Verify(sampling, noise, erosion, density);
+
+    std::vector<Result> results;
+    for (const Scenario& sc : kScenarios)
+        results.push_back(RunScenario(sc, repeat, sampling, noise, erosion, density));
+
+    PrintTable(results);
+    if (GenProfiler::ENABLED) PrintProfile(GenProfiler::Collect());
+
+    if (!jsonPath.empty()) {
+        const char* samplingName = sampling == TerrainSampling::Exact ? "exact" : "cached";
+        const char* noiseName    = noise == TerrainNoise::Float ? "float" : "lattice";
+        const char* erosionName  = erosion == TerrainErosion::None ? "none" : "hydraulic";
+        const char* densityName  = density == TerrainDensity::None ? "none" : "narrowband";
+        if (!WriteJson(jsonPath, label, samplingName, noiseName, erosionName, densityName, repeat, results))
+            return 1;
+    }
+    return 0;
+}
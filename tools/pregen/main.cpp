@@ -0,0 +1,448 @@
+// biosphere-pregen - offline world pregeneration.
+//
+// Generates every chunk of a square or circular area and writes it to the same
+// reg_/head_ files the game streams from, without opening a window.
+//
+// Work is scheduled region by region: each worker claims a whole region, fills it
+// sequentially with one RegionHandler and saves its header once. Regions are
+// claimed nearest-first, so an interrupted run leaves a compact finished area.
+//
+// Resuming: chunks already listed in a region header are skipped. A region whose
+// header was never saved (run killed mid-region) has its orphaned reg_ bytes
+// discarded and is regenerated from scratch.
+//
+// --check-heights: instead of generating, hashes the terrain heights of the region
+// containing --center once per available noise kernel and reports whether they
+// agree (and match --expect, a hash printed by another build or machine).
+
+#include "world/chunk_generator.hpp"
+#include "world/region_handler.hpp"
+#include "io/file_system.hpp"
+#include "util/math/noise_batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Same seed the game starts with (GameLayer), so a default run pregenerates the default world.
+    const Seed256 kDefaultSeed{941456789ULL, 423654321ULL, 111222333ULL, 444555666ULL};
+
+    enum class Shape : uint8_t { Square, Circle };
+
+    struct Options {
+        Seed256          seed      = kDefaultSeed;
+        ChunkCoordinates center    = ChunkCoordinates(0, 0);
+        int32_t          radius    = DEFAULT_RENDER_DISTANCE; // chunks
+        Shape            shape     = Shape::Square;
+        std::string      worldDir  = "data/world";
+        uint32_t         threads   = 0;                       // 0 = hardware_concurrency
+        TerrainSampling  sampling  = TerrainSampling::Exact;
+        TerrainNoise     noise     = TerrainNoise::Float;
+        TerrainErosion   erosion   = TerrainErosion::Hydraulic; // the game's setting
+        TerrainDensity   density   = TerrainDensity::NarrowBand; // the game's setting
+        bool             lods      = false;
+        bool             checkHeights = false;
+        uint64_t         expectHash   = 0;                    // 0 = none
+    };
+
+    struct Stats {
+        std::atomic<uint64_t> generated{0};
+        std::atomic<uint64_t> skipped{0};
+        std::atomic<uint64_t> failed{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint32_t> regionsDone{0};
+    };
+
+    void PrintUsage() {
+        std::printf(
+            "usage: biosphere-pregen [options]\n"
+            "  --seed A,B,C,D       256-bit world seed as four u64 (default: game seed)\n"
+            "  --center X,Z         centre chunk (default 0,0)\n"
+            "  --radius N           radius in chunks (default %u)\n"
+            "  --shape square|circle\n"
+            "  --world DIR          world directory (default data/world)\n"
+            "  --threads N          worker threads (default: all cores)\n"
+            "  --sampling exact|cached\n"
+            "  --noise float|lattice\n"
+            "  --erosion none|hydraulic (default hydraulic, as the game)\n"
+            "  --density none|narrowband (default narrowband, as the game)\n"
+            "  --lods               also build LOD meshes (timing parity with the streamer)\n"
+            "  --check-heights      hash the heights of the centre region per noise kernel, then exit\n"
+            "  --expect HASH        hex hash --check-heights must reproduce\n",
+            DEFAULT_RENDER_DISTANCE);
+    }
+
+    bool ParseArgs(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+            auto needValue = [&]() {
+                if (!value) std::fprintf(stderr, "[Pregen] Missing value for %s\n", arg.c_str());
+                return value != nullptr;
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                PrintUsage();
+                std::exit(0);
+            } else if (arg == "--seed") {
+                if (!needValue()) return false;
+                uint64_t s[4];
+                if (std::sscanf(value, "%" SCNu64 ",%" SCNu64 ",%" SCNu64 ",%" SCNu64,
+                                &s[0], &s[1], &s[2], &s[3]) != 4) {
+                    std::fprintf(stderr, "[Pregen] Bad seed '%s' (expected A,B,C,D)\n", value);
+                    return false;
+                }
+                opt.seed = Seed256(s[0], s[1], s[2], s[3]);
+                ++i;
+            } else if (arg == "--center") {
+                if (!needValue()) return false;
+                int32_t x, z;
+                if (std::sscanf(value, "%d,%d", &x, &z) != 2) {
+                    std::fprintf(stderr, "[Pregen] Bad centre '%s' (expected X,Z)\n", value);
+                    return false;
+                }
+                opt.center = ChunkCoordinates(x, z);
+                ++i;
+            } else if (arg == "--radius") {
+                if (!needValue()) return false;
+                opt.radius = std::atoi(value);
+                if (opt.radius < 0) {
+                    std::fprintf(stderr, "[Pregen] Radius must be >= 0\n");
+                    return false;
+                }
+                ++i;
+            } else if (arg == "--shape") {
+                if (!needValue()) return false;
+                if (std::strcmp(value, "square") == 0)      opt.shape = Shape::Square;
+                else if (std::strcmp(value, "circle") == 0) opt.shape = Shape::Circle;
+                else {
+                    std::fprintf(stderr, "[Pregen] Unknown shape '%s'\n", value);
+                    return false;
+                }
+                ++i;
+            } else if (arg == "--world") {
+                if (!needValue()) return false;
+                opt.worldDir = value;
+                ++i;
+            } else if (arg == "--threads") {
+                if (!needValue()) return false;
+                opt.threads = static_cast<uint32_t>(std::max(0, std::atoi(value)));
+                ++i;
+            } else if (arg == "--sampling") {
+                if (!needValue()) return false;
+                if (std::strcmp(value, "exact") == 0)       opt.sampling = TerrainSampling::Exact;
+                else if (std::strcmp(value, "cached") == 0) opt.sampling = TerrainSampling::Cached;
+                else {
+                    std::fprintf(stderr, "[Pregen] Unknown sampling '%s'\n", value);
+                    return false;
+                }
+                ++i;
+            } else if (arg == "--noise") {
+                if (!needValue()) return false;
+                if (std::strcmp(value, "float") == 0)        opt.noise = TerrainNoise::Float;
+                else if (std::strcmp(value, "lattice") == 0) opt.noise = TerrainNoise::Lattice;
+                else {
+                    std::fprintf(stderr, "[Pregen] Unknown noise '%s'\n", value);
+                    return false;
+                }
+                ++i;
+            } else if (arg == "--erosion") {
+                if (!needValue()) return false;
+                if (std::strcmp(value, "none") == 0)           opt.erosion = TerrainErosion::None;
+                else if (std::strcmp(value, "hydraulic") == 0) opt.erosion = TerrainErosion::Hydraulic;
+                else {
+                    std::fprintf(stderr, "[Pregen] Unknown erosion '%s'\n", value);
+                    return false;
+                }
+                ++i;
+            } else if (arg == "--density") {
+                if (!needValue()) return false;
+                if (std::strcmp(value, "none") == 0)            opt.density = TerrainDensity::None;
+                else if (std::strcmp(value, "narrowband") == 0) opt.density = TerrainDensity::NarrowBand;
+                else {
+                    std::fprintf(stderr, "[Pregen] Unknown density '%s'\n", value);
+                    return false;
+                }
+                ++i;
+            } else if (arg == "--lods") {
+                opt.lods = true;
+            } else if (arg == "--check-heights") {
+                opt.checkHeights = true;
+            } else if (arg == "--expect") {
+                if (!needValue()) return false;
+                if (std::sscanf(value, "%" SCNx64, &opt.expectHash) != 1) {
+                    std::fprintf(stderr, "[Pregen] Bad hash '%s'\n", value);
+                    return false;
+                }
+                ++i;
+            } else {
+                std::fprintf(stderr, "[Pregen] Unknown option '%s'\n", arg.c_str());
+                PrintUsage();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool InShape(const Options& opt, int32_t cx, int32_t cz) {
+        const int64_t dx = static_cast<int64_t>(cx) - opt.center.X;
+        const int64_t dz = static_cast<int64_t>(cz) - opt.center.Z;
+        if (opt.shape == Shape::Square)
+            return std::llabs(dx) <= opt.radius && std::llabs(dz) <= opt.radius;
+        return dx * dx + dz * dz <= static_cast<int64_t>(opt.radius) * opt.radius;
+    }
+
+    // Regions overlapping the area, nearest to the centre first.
+    std::vector<uint64_t> CollectRegions(const Options& opt) {
+        const ChunkCoordinates minRegion = RegionHandler::ChunkToRegion(
+            ChunkCoordinates(opt.center.X - opt.radius, opt.center.Z - opt.radius));
+        const ChunkCoordinates maxRegion = RegionHandler::ChunkToRegion(
+            ChunkCoordinates(opt.center.X + opt.radius, opt.center.Z + opt.radius));
+        const ChunkCoordinates centerRegion = RegionHandler::ChunkToRegion(opt.center);
+
+        struct Entry { int64_t dist; uint64_t id; };
+        std::vector<Entry> entries;
+        for (int32_t rz = minRegion.Z; rz <= maxRegion.Z; ++rz) {
+            for (int32_t rx = minRegion.X; rx <= maxRegion.X; ++rx) {
+                // A circle's bounding square includes corner regions with no chunk inside.
+                const int32_t nearX = std::clamp(opt.center.X, rx * REGION_SIZE, rx * REGION_SIZE + REGION_SIZE - 1);
+                const int32_t nearZ = std::clamp(opt.center.Z, rz * REGION_SIZE, rz * REGION_SIZE + REGION_SIZE - 1);
+                if (!InShape(opt, nearX, nearZ)) continue;
+
+                const int64_t dx = rx - centerRegion.X;
+                const int64_t dz = rz - centerRegion.Z;
+                entries.push_back({dx * dx + dz * dz, RegionHandler::MakeID(rx, rz)});
+            }
+        }
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const Entry& a, const Entry& b) { return a.dist < b.dist; });
+
+        std::vector<uint64_t> ids;
+        ids.reserve(entries.size());
+        for (const Entry& e : entries) ids.push_back(e.id);
+        return ids;
+    }
+
+    uint64_t FileSizeOrZero(const std::string& path) {
+        std::error_code ec;
+        const auto size = fs::file_size(path, ec);
+        return ec ? 0 : static_cast<uint64_t>(size);
+    }
+
+    void GenerateRegion(const Options& opt, const ChunkGenerator& generator,
+                        const std::string& regDir, uint64_t id, Stats& stats) {
+        int32_t rx, rz;
+        RegionHandler::DecodeID(id, rx, rz);
+
+        const std::string headPath = RegionHandler::HeadPath(regDir, id);
+        const std::string dataPath = RegionHandler::DataPath(regDir, id);
+
+        // No header means nothing in the data file is reachable - a previous run died
+        // before saving it. Drop those bytes instead of appending after them.
+        if (!fs::exists(headPath) && fs::exists(dataPath)) {
+            std::error_code ec;
+            fs::remove(dataPath, ec);
+        }
+        const uint64_t sizeBefore = FileSizeOrZero(dataPath);
+
+        RegionHandler region(id, ChunkCoordinates(rx, rz), regDir);
+        region.Load();
+
+        // Row-major inside the region so each chunk finds its west and north halo edges cached.
+        for (int32_t lz = 0; lz < REGION_SIZE; ++lz) {
+            for (int32_t lx = 0; lx < REGION_SIZE; ++lx) {
+                const int32_t cx = rx * REGION_SIZE + lx;
+                const int32_t cz = rz * REGION_SIZE + lz;
+                if (!InShape(opt, cx, cz)) continue;
+
+                const ChunkCoordinates coords(cx, cz);
+                if (region.HasChunk(coords)) {
+                    stats.skipped.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                Chunk chunk(cx, cz);
+                generator.Generate(chunk);
+                if (opt.lods) chunk.GenerateLODs();
+
+                if (region.WriteChunk(chunk)) {
+                    stats.generated.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    stats.failed.fetch_add(1, std::memory_order_relaxed);
+                    std::fprintf(stderr, "[Pregen] Failed to write chunk (%d, %d)\n", cx, cz);
+                }
+            }
+        }
+
+        region.Unload(); // the one header save for this region
+
+        const uint64_t sizeAfter = FileSizeOrZero(dataPath);
+        stats.bytes.fetch_add(sizeAfter - std::min(sizeBefore, sizeAfter), std::memory_order_relaxed);
+        stats.regionsDone.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Merge the generated regions into world-header.bin (sorted u64 region IDs, see WorldHandler).
+    bool UpdateWorldHeader(const std::string& worldDir, const std::vector<uint64_t>& regions) {
+        const std::string path = worldDir + "/world-header.bin";
+
+        std::vector<uint64_t> ids;
+        std::vector<uint8_t>  buffer;
+        if (FileSystem::ReadBinary(path, buffer)) {
+            if (buffer.size() % sizeof(uint64_t) != 0) {
+                std::fprintf(stderr, "[Pregen] Corrupt world header (size %zu) - rebuilding.\n", buffer.size());
+            } else {
+                ids.resize(buffer.size() / sizeof(uint64_t));
+                std::memcpy(ids.data(), buffer.data(), buffer.size());
+            }
+        }
+
+        ids.insert(ids.end(), regions.begin(), regions.end());
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        return FileSystem::WriteBinary(path, reinterpret_cast<const uint8_t*>(ids.data()),
+                                       ids.size() * sizeof(uint64_t));
+    }
+
+    void PrintProgress(const Stats& stats, size_t regionTotal, double seconds, bool final) {
+        const uint64_t generated = stats.generated.load(std::memory_order_relaxed);
+        const uint64_t bytes     = stats.bytes.load(std::memory_order_relaxed);
+        const double   secs      = std::max(seconds, 1e-6);
+        std::printf("%s[Pregen] regions %u/%zu  chunks %" PRIu64 " (+%" PRIu64 " skipped)  "
+                    "%.0f chunks/s  %.1f MB/s  %.1fs%s",
+                    "\r",
+                    stats.regionsDone.load(std::memory_order_relaxed), regionTotal,
+                    generated, stats.skipped.load(std::memory_order_relaxed),
+                    static_cast<double>(generated) / secs,
+                    static_cast<double>(bytes) / (1024.0 * 1024.0) / secs,
+                    seconds, final ? "\n" : "");
+        std::fflush(stdout);
+    }
+
+    // FNV-1a 64 over the height bits of the region containing the centre chunk, one
+    // sample per sphere (the chunk generator's grid). A fresh generator per kernel,
+    // so Cached mode rebuilds its lattice tiles with that kernel too.
+    uint64_t HashRegionHeights(const Options& opt, NoiseBatch::ISA isa) {
+        NoiseBatch::SetISA(isa);
+        const TerrainGenerator terrain(opt.seed, opt.sampling, opt.noise);
+
+        constexpr int32_t SIDE = REGION_SIZE * CHUNK_SIZE;
+        const ChunkCoordinates region = RegionHandler::ChunkToRegion(opt.center);
+        const float originX = static_cast<float>(region.X * SIDE) * SPHERE_RADIUS;
+        const float originZ = static_cast<float>(region.Z * SIDE) * SPHERE_RADIUS;
+
+        std::vector<float> row(SIDE);
+        uint64_t hash = 14695981039346656037ULL;
+        for (int32_t z = 0; z < SIDE; ++z) {
+            terrain.GetHeightGrid(originX, originZ + static_cast<float>(z) * SPHERE_RADIUS, SPHERE_RADIUS,
+                                  SIDE, 1, row.data());
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(row.data());
+            for (size_t i = 0; i < row.size() * sizeof(float); ++i) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ULL;
+            }
+        }
+        return hash;
+    }
+
+    // 0 when every kernel agrees (and matches opt.expectHash if given).
+    int CheckHeights(const Options& opt) {
+        const ChunkCoordinates region = RegionHandler::ChunkToRegion(opt.center);
+        std::printf("[Pregen] Height check: region (%d, %d), %s noise, %s sampling\n", region.X, region.Z,
+                    opt.noise == TerrainNoise::Float ? "float" : "lattice",
+                    opt.sampling == TerrainSampling::Exact ? "exact" : "cached");
+
+        const NoiseBatch::ISA best = NoiseBatch::DetectISA();
+        uint64_t first = 0;
+        bool     agree = true;
+        for (uint8_t i = 0; i <= static_cast<uint8_t>(best); ++i) {
+            const auto     isa  = static_cast<NoiseBatch::ISA>(i);
+            const uint64_t hash = HashRegionHeights(opt, isa);
+            std::printf("[Pregen]   %-6s %016" PRIx64 "\n", NoiseBatch::ISAName(isa), hash);
+            if (i == 0) first = hash;
+            agree = agree && hash == first;
+        }
+        NoiseBatch::SetISA(best);
+
+        if (!agree) {
+            std::fprintf(stderr, "[Pregen] Height check FAILED: kernels disagree.\n");
+            return 1;
+        }
+        if (opt.expectHash && first != opt.expectHash) {
+            std::fprintf(stderr, "[Pregen] Height check FAILED: expected %016" PRIx64 ".\n", opt.expectHash);
+            return 1;
+        }
+        std::printf("[Pregen] Height check passed.\n");
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!ParseArgs(argc, argv, opt)) return 1;
+    if (opt.checkHeights) return CheckHeights(opt);
+
+    const uint32_t threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    const std::string regDir = opt.worldDir + "/regions"; // same layout as ChunkStreamer
+    std::error_code ec;
+    fs::create_directories(regDir, ec);
+    if (ec) {
+        std::fprintf(stderr, "[Pregen] Cannot create %s: %s\n", regDir.c_str(), ec.message().c_str());
+        return 1;
+    }
+
+    const std::vector<uint64_t> regions = CollectRegions(opt);
+    std::printf("[Pregen] %s radius %d around chunk (%d, %d): %zu region(s), %u thread(s), %s sampling, %s noise, %s erosion, %s density\n",
+                opt.shape == Shape::Square ? "square" : "circle", opt.radius,
+                opt.center.X, opt.center.Z, regions.size(), threads,
+                opt.sampling == TerrainSampling::Exact ? "exact" : "cached",
+                opt.noise == TerrainNoise::Float ? "float" : "lattice",
+                opt.erosion == TerrainErosion::None ? "no" : "hydraulic",
+                opt.density == TerrainDensity::None ? "no" : "narrow-band");
+
+    const ChunkGenerator generator(opt.seed, opt.sampling, opt.noise, opt.erosion, opt.density);
+    Stats stats;
+    std::atomic<size_t> next{0};
+
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (uint32_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next.fetch_add(1); i < regions.size(); i = next.fetch_add(1))
+                GenerateRegion(opt, generator, regDir, regions[i], stats);
+        });
+    }
+
+    while (stats.regionsDone.load(std::memory_order_relaxed) < regions.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        PrintProgress(stats, regions.size(), elapsed(), false);
+    }
+    for (std::thread& w : workers) w.join();
+    PrintProgress(stats, regions.size(), elapsed(), true);
+
+    if (!UpdateWorldHeader(opt.worldDir, regions)) {
+        std::fprintf(stderr, "[Pregen] Failed to update world header.\n");
+        return 1;
+    }
+
+    const uint64_t failed = stats.failed.load(std::memory_order_relaxed);
+    if (failed) {
+        std::fprintf(stderr, "[Pregen] %" PRIu64 " chunk(s) failed to write.\n", failed);
+        return 1;
+    }
+    return 0;
+}